@@ -17,6 +17,7 @@ LArPandoraEvent::LArPandoraEvent(art::EDProducer *pProducer, art::Event *pEvent,
     m_shift(shift)
 {
     this->GetCollections();
+    this->IndexCollections();
 
     for (const art::Ptr<recob::PFParticle> &part : m_pfParticles)
     {
@@ -52,18 +53,20 @@ LArPandoraEvent::LArPandoraEvent(const LArPandoraEvent &event, const PFParticleV
             this->CollectAssociated(part, event.m_pfParticleT0Map, m_t0s);
     }
 
-    this->GetFilteredAssociationMap(m_pfParticles, m_spacePoints, event.m_pfParticleSpacePointMap, m_pfParticleSpacePointMap);
-    this->GetFilteredAssociationMap(m_pfParticles, m_clusters, event.m_pfParticleClusterMap, m_pfParticleClusterMap);
-    this->GetFilteredAssociationMap(m_pfParticles, m_vertices, event.m_pfParticleVertexMap, m_pfParticleVertexMap);
-    this->GetFilteredAssociationMap(m_pfParticles, m_tracks, event.m_pfParticleTrackMap, m_pfParticleTrackMap);
-    this->GetFilteredAssociationMap(m_pfParticles, m_showers, event.m_pfParticleShowerMap, m_pfParticleShowerMap);
-    this->GetFilteredAssociationMap(m_pfParticles, m_pcAxes, event.m_pfParticlePCAxisMap, m_pfParticlePCAxisMap);
-    this->GetFilteredAssociationMap(m_pfParticles, m_metadata, event.m_pfParticleMetadataMap, m_pfParticleMetadataMap);
-    this->GetFilteredAssociationMap(m_spacePoints, event.m_hits, event.m_spacePointHitMap, m_spacePointHitMap);
-    this->GetFilteredAssociationMap(m_clusters, event.m_hits, event.m_clusterHitMap, m_clusterHitMap);
-    this->GetFilteredAssociationMap(m_tracks, event.m_hits, event.m_trackHitMap, m_trackHitMap);
-    this->GetFilteredAssociationMap(m_showers, event.m_hits, event.m_showerHitMap, m_showerHitMap);
-    this->GetFilteredAssociationMap(m_showers, m_pcAxes, event.m_showerPCAxisMap, m_showerPCAxisMap);
+    this->IndexCollections();
+
+    this->GetFilteredAssociationMap(m_pfParticles, m_spacePointIndexMap, event.m_pfParticleSpacePointMap, m_pfParticleSpacePointMap);
+    this->GetFilteredAssociationMap(m_pfParticles, m_clusterIndexMap, event.m_pfParticleClusterMap, m_pfParticleClusterMap);
+    this->GetFilteredAssociationMap(m_pfParticles, m_vertexIndexMap, event.m_pfParticleVertexMap, m_pfParticleVertexMap);
+    this->GetFilteredAssociationMap(m_pfParticles, m_trackIndexMap, event.m_pfParticleTrackMap, m_pfParticleTrackMap);
+    this->GetFilteredAssociationMap(m_pfParticles, m_showerIndexMap, event.m_pfParticleShowerMap, m_pfParticleShowerMap);
+    this->GetFilteredAssociationMap(m_pfParticles, m_pcAxisIndexMap, event.m_pfParticlePCAxisMap, m_pfParticlePCAxisMap);
+    this->GetFilteredAssociationMap(m_pfParticles, m_metadataIndexMap, event.m_pfParticleMetadataMap, m_pfParticleMetadataMap);
+    this->GetFilteredAssociationMap(m_spacePoints, event.m_hitIndexMap, event.m_spacePointHitMap, m_spacePointHitMap);
+    this->GetFilteredAssociationMap(m_clusters, event.m_hitIndexMap, event.m_clusterHitMap, m_clusterHitMap);
+    this->GetFilteredAssociationMap(m_tracks, event.m_hitIndexMap, event.m_trackHitMap, m_trackHitMap);
+    this->GetFilteredAssociationMap(m_showers, event.m_hitIndexMap, event.m_showerHitMap, m_showerHitMap);
+    this->GetFilteredAssociationMap(m_showers, m_pcAxisIndexMap, event.m_showerPCAxisMap, m_showerPCAxisMap);
 
     this->GetFilteredHierarchyMap(selectedPFParticles, event.m_pfParticleDaughterMap, m_pfParticleDaughterMap);
 }
@@ -117,23 +120,23 @@ void LArPandoraEvent::WriteToEvent() const
     this->WriteCollection(m_pcAxes);
     this->WriteCollection(m_metadata);
 
-    this->WriteAssociation(m_pfParticleSpacePointMap, m_pfParticles, m_spacePoints);
-    this->WriteAssociation(m_pfParticleClusterMap, m_pfParticles, m_clusters);
-    this->WriteAssociation(m_pfParticleVertexMap, m_pfParticles, m_vertices);
-    this->WriteAssociation(m_pfParticleTrackMap, m_pfParticles, m_tracks);
-    this->WriteAssociation(m_pfParticleShowerMap, m_pfParticles, m_showers);
-    this->WriteAssociation(m_pfParticlePCAxisMap, m_pfParticles, m_pcAxes);
-    this->WriteAssociation(m_pfParticleMetadataMap, m_pfParticles, m_metadata);
-    this->WriteAssociation(m_spacePointHitMap, m_spacePoints, m_hits, false);
-    this->WriteAssociation(m_clusterHitMap, m_clusters, m_hits, false);
-    this->WriteAssociation(m_trackHitMap, m_tracks, m_hits, false);
-    this->WriteAssociation(m_showerHitMap, m_showers, m_hits, false);
-    this->WriteAssociation(m_showerPCAxisMap, m_showers, m_pcAxes);
+    this->WriteAssociation(m_pfParticleSpacePointMap, m_pfParticleIndexMap, m_spacePointIndexMap);
+    this->WriteAssociation(m_pfParticleClusterMap, m_pfParticleIndexMap, m_clusterIndexMap);
+    this->WriteAssociation(m_pfParticleVertexMap, m_pfParticleIndexMap, m_vertexIndexMap);
+    this->WriteAssociation(m_pfParticleTrackMap, m_pfParticleIndexMap, m_trackIndexMap);
+    this->WriteAssociation(m_pfParticleShowerMap, m_pfParticleIndexMap, m_showerIndexMap);
+    this->WriteAssociation(m_pfParticlePCAxisMap, m_pfParticleIndexMap, m_pcAxisIndexMap);
+    this->WriteAssociation(m_pfParticleMetadataMap, m_pfParticleIndexMap, m_metadataIndexMap);
+    this->WriteAssociation(m_spacePointHitMap, m_spacePointIndexMap, m_hitIndexMap, false);
+    this->WriteAssociation(m_clusterHitMap, m_clusterIndexMap, m_hitIndexMap, false);
+    this->WriteAssociation(m_trackHitMap, m_trackIndexMap, m_hitIndexMap, false);
+    this->WriteAssociation(m_showerHitMap, m_showerIndexMap, m_hitIndexMap, false);
+    this->WriteAssociation(m_showerPCAxisMap, m_showerIndexMap, m_pcAxisIndexMap);
 
     if (m_shouldProduceT0s)
     {
         this->WriteCollection(m_t0s);
-        this->WriteAssociation(m_pfParticleT0Map, m_pfParticles, m_t0s);
+        this->WriteAssociation(m_pfParticleT0Map, m_pfParticleIndexMap, m_t0IndexMap);
     }
 }
 
@@ -178,6 +181,8 @@ LArPandoraEvent LArPandoraEvent::Merge(const LArPandoraEvent &other) const
     this->MergeAssociation(outputEvent.m_showerHitMap, m_showerHitMap);
     this->MergeAssociation(outputEvent.m_showerPCAxisMap, m_showerPCAxisMap);
 
+    outputEvent.IndexCollections();
+
     return outputEvent;
 }
 
@@ -257,6 +262,22 @@ void LArPandoraEvent::GetPFParticleHierarchy()
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+void LArPandoraEvent::IndexCollections()
+{
+    this->IndexCollection(m_pfParticles, m_pfParticleIndexMap);
+    this->IndexCollection(m_spacePoints, m_spacePointIndexMap);
+    this->IndexCollection(m_clusters, m_clusterIndexMap);
+    this->IndexCollection(m_vertices, m_vertexIndexMap);
+    this->IndexCollection(m_tracks, m_trackIndexMap);
+    this->IndexCollection(m_showers, m_showerIndexMap);
+    this->IndexCollection(m_t0s, m_t0IndexMap);
+    this->IndexCollection(m_metadata, m_metadataIndexMap);
+    this->IndexCollection(m_pcAxes, m_pcAxisIndexMap);
+    this->IndexCollection(m_hits, m_hitIndexMap);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 void LArPandoraEvent::GetPrimaryPFParticles(PFParticleVector &primaryPFParticles) const
 {
     for (art::Ptr< recob::PFParticle > part : m_pfParticles)
@@ -28,7 +28,10 @@
 
 #include <memory>
 #include <algorithm>
+#include <functional>
 #include <map>
+#include <optional>
+#include <unordered_map>
 
 namespace lar_pandora
 {
@@ -42,6 +45,19 @@ typedef std::map< art::Ptr<recob::PFParticle>, std::vector< art::Ptr<recob::PFPa
 typedef std::map< art::Ptr<recob::Shower>, std::vector< art::Ptr<recob::PCAxis> > >         ShowersToPCAxes;
 typedef std::map< art::Ptr<recob::SpacePoint>, std::vector< art::Ptr<recob::Hit> > >        SpacePointsToHitVector;
 
+/**
+ *  @brief  Hash for art::Ptr, combining the product id and the key
+ */
+class PtrHash
+{
+public:
+    template <typename T>
+    size_t operator()(const art::Ptr<T> &ptr) const;
+};
+
+template <typename T>
+using PtrToIndexMap = std::unordered_map< art::Ptr<T>, size_t, PtrHash >;
+
 /**
  *  @brief LArPandoraEvent class
  */
@@ -216,6 +232,20 @@ private:
      */
     void GetPFParticleHierarchy();
 
+    /**
+     *  @brief  Build the Ptr to index tables for every collection, so that associations can be written and filtered without searching
+     */
+    void IndexCollections();
+
+    /**
+     *  @brief  Build the Ptr to index table for a given collection. If an object is repeated, the first index is used
+     *
+     *  @param  collection the input collection
+     *  @param  indexMap output mapping from each object in the collection to its index
+     */
+    template <typename T>
+    void IndexCollection(const std::vector<art::Ptr<T> > &collection, PtrToIndexMap<T> &indexMap) const;
+
     /**
      *  @brief  Filters primary PFParticles from the m_pfParticles
      *
@@ -298,14 +328,14 @@ private:
      *   @brief  Gets the mapping between two filtered collections
      *
      *   @param  collectionT a first filtered collection
-     *   @param  collectionU a second filtered collection
+     *   @param  indexMapU the index table for a second filtered collection
      *   @param  inputAssociationTtoU mapping between the two unfiltered collections
      *   @param  outputAssociationTtoU mapping between the two filtered collections
      *
      *   @return mapping between the filtered collections
      */
     template <typename T, typename U>
-    void GetFilteredAssociationMap(const std::vector<art::Ptr<T> > &collectionT, const std::vector<art::Ptr<U> > &collectionU,
+    void GetFilteredAssociationMap(const std::vector<art::Ptr<T> > &collectionT, const PtrToIndexMap<U> &indexMapU,
         const std::map<art::Ptr<T>, std::vector<art::Ptr<U> > > &inputAssociationTtoU, std::map<art::Ptr<T>, std::vector<art::Ptr<U> > > &outputAssociationTtoU) const;
 
     /**
@@ -320,13 +350,13 @@ private:
      *  @brief  Write a given association to the event
      *
      *  @param  associationMap the association to write from objects of type T -> U
-     *  @param  collectionT the collection of type T that has been written
-     *  @param  collectionU the collection of type U that has been written
+     *  @param  indexMapT the index table for the collection of type T that has been written
+     *  @param  indexMapU the index table for the collection of type U that has been written
      *  @param  thisProducesU will this producer produce collectionU of was it produced by a different module?
      */
     template <typename T, typename U>
-    void WriteAssociation(const std::map<art::Ptr<T>, std::vector<art::Ptr<U> > > &associationMap, const std::vector<art::Ptr<T> > &collectionT,
-        const std::vector<art::Ptr<U> > &collectionU, const bool thisProducesU = true) const;
+    void WriteAssociation(const std::map<art::Ptr<T>, std::vector<art::Ptr<U> > > &associationMap, const PtrToIndexMap<T> &indexMapT,
+        const PtrToIndexMap<U> &indexMapU, const bool thisProducesU = true) const;
 
     /**
      *  @brief  Merge two PFParticle to origin ID maps ensuring no ID collisions
@@ -394,10 +424,30 @@ private:
     ShowersToPCAxes             m_showerPCAxisMap;              ///<  The input associations: PCAxis -> Shower
 
     PFParticlesToPFParticles    m_pfParticleDaughterMap;        ///<  The mapping from parent to daughter PFParticles
+
+    // Index tables
+    PtrToIndexMap<recob::PFParticle>                m_pfParticleIndexMap;   ///<  The index of each PFParticle in its collection
+    PtrToIndexMap<recob::SpacePoint>                m_spacePointIndexMap;   ///<  The index of each SpacePoint in its collection
+    PtrToIndexMap<recob::Cluster>                   m_clusterIndexMap;      ///<  The index of each Cluster in its collection
+    PtrToIndexMap<recob::Vertex>                    m_vertexIndexMap;       ///<  The index of each Vertex in its collection
+    PtrToIndexMap<recob::Track>                     m_trackIndexMap;        ///<  The index of each Track in its collection
+    PtrToIndexMap<recob::Shower>                    m_showerIndexMap;       ///<  The index of each Shower in its collection
+    PtrToIndexMap<anab::T0>                         m_t0IndexMap;           ///<  The index of each T0 in its collection
+    PtrToIndexMap<larpandoraobj::PFParticleMetadata> m_metadataIndexMap;    ///<  The index of each PFParticle metadata in its collection
+    PtrToIndexMap<recob::PCAxis>                    m_pcAxisIndexMap;       ///<  The index of each PCAxis in its collection
+    PtrToIndexMap<recob::Hit>                       m_hitIndexMap;          ///<  The index of each Hit in its collection
 };
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+template <typename T>
+inline size_t PtrHash::operator()(const art::Ptr<T> &ptr) const
+{
+    return (std::hash<size_t>()(ptr.key()) ^ (std::hash<art::ProductID::value_type>()(ptr.id().value()) << 1));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 template <typename T>
 inline void LArPandoraEvent::GetCollection(const Labels::LabelType &inputLabel, art::Handle<std::vector<T> > &outputHandle, std::vector<art::Ptr<T> > &outputCollection) const
 {
@@ -435,6 +485,18 @@ inline void LArPandoraEvent::GetAssociationMap(const Labels::LabelType &inputLab
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+template <typename T>
+inline void LArPandoraEvent::IndexCollection(const std::vector<art::Ptr<T> > &collection, PtrToIndexMap<T> &indexMap) const
+{
+    indexMap.clear();
+    indexMap.reserve(collection.size());
+
+    for (size_t index = 0; index < collection.size(); ++index)
+        (void) indexMap.emplace(collection.at(index), index);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 template <typename T, typename U>
 inline void LArPandoraEvent::CollectAssociated(const art::Ptr<T> &anObject, const std::map<art::Ptr<T>, std::vector<art::Ptr<U> > > &associationTtoU,
     std::vector<art::Ptr<U> > &associatedU) const
@@ -449,22 +511,23 @@ inline void LArPandoraEvent::CollectAssociated(const art::Ptr<T> &anObject, cons
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 template <typename T, typename U>
-inline void LArPandoraEvent::GetFilteredAssociationMap(const std::vector<art::Ptr<T> > &collectionT, const std::vector<art::Ptr<U> > &collectionU,
+inline void LArPandoraEvent::GetFilteredAssociationMap(const std::vector<art::Ptr<T> > &collectionT, const PtrToIndexMap<U> &indexMapU,
     const std::map<art::Ptr<T>, std::vector<art::Ptr<U> > > &inputAssociationTtoU, std::map<art::Ptr<T>, std::vector<art::Ptr<U> > > &outputAssociationTtoU) const
 {
     for (art::Ptr< T > objectT : collectionT)
     {
         std::vector<art::Ptr<U> > emptyVector;
-        if (!outputAssociationTtoU.insert(typename std::map<art::Ptr<T>, std::vector<art::Ptr<U> > >::value_type(objectT, emptyVector)).second)
+        const auto insertion(outputAssociationTtoU.insert(typename std::map<art::Ptr<T>, std::vector<art::Ptr<U> > >::value_type(objectT, emptyVector)));
+
+        if (!insertion.second)
             throw cet::exception("LArPandora") << " LArPandoraEvent::GetFilteredAssociationMap -- Can not have multiple association map entries for a single object." << std::endl;
 
         for (art::Ptr< U > objectU : inputAssociationTtoU.at(objectT))
         {
-            typename std::vector<art::Ptr<U> >::const_iterator associatedObjectIter = std::find(collectionU.begin(), collectionU.end(), objectU);
-            if (associatedObjectIter == collectionU.end())
+            if (indexMapU.find(objectU) == indexMapU.end())
                 continue;
 
-            outputAssociationTtoU[objectT].push_back(objectU);
+            insertion.first->second.push_back(objectU);
         }
     }
 }
@@ -518,31 +581,35 @@ inline void LArPandoraEvent::WriteCollection(const std::vector<art::Ptr<recob::P
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 template <typename T, typename U>
-inline void LArPandoraEvent::WriteAssociation(const std::map<art::Ptr<T>, std::vector<art::Ptr<U> > > &associationMap, const std::vector<art::Ptr<T> > &collectionT,
-    const std::vector<art::Ptr<U> > &collectionU, const bool thisProducesU) const
+inline void LArPandoraEvent::WriteAssociation(const std::map<art::Ptr<T>, std::vector<art::Ptr<U> > > &associationMap, const PtrToIndexMap<T> &indexMapT,
+    const PtrToIndexMap<U> &indexMapU, const bool thisProducesU) const
 {
     const art::PtrMaker<T> makePtrT(*m_pEvent);
+
+    // ATTN Only make pointers to the objects of type U if this module produces them, otherwise their product ID can't be found
+    std::optional<const art::PtrMaker<U> > makePtrU;
+    if (thisProducesU)
+        makePtrU.emplace(*m_pEvent);
+
     std::unique_ptr<art::Assns<T, U> > outputAssn(new art::Assns<T, U>);
 
     for (typename std::map<art::Ptr<T>, std::vector<art::Ptr<U> > >::const_iterator it = associationMap.begin(); it != associationMap.end(); ++it)
     {
-        typename std::vector<art::Ptr<T> >::const_iterator itT = std::find(collectionT.begin(), collectionT.end(), it-> first);
-        if (itT == collectionT.end())
+        typename PtrToIndexMap<T>::const_iterator itT = indexMapT.find(it->first);
+        if (itT == indexMapT.end())
             throw cet::exception("LArPandora") << " LArPandoraEvent::WriteAssociation -- association map contains object not in collectionT." << std::endl;
 
-        art::Ptr<T> newObjectT(makePtrT(std::distance(collectionT.begin(), itT)));
+        art::Ptr<T> newObjectT(makePtrT(itT->second));
 
         for (const art::Ptr<U> &objectU : it->second)
         {
             if (thisProducesU)
             {
-                const art::PtrMaker<U> makePtrU(*m_pEvent);
-
-                typename std::vector<art::Ptr<U> >::const_iterator itU = std::find(collectionU.begin(), collectionU.end(), objectU);
-                if (itU == collectionU.end())
+                typename PtrToIndexMap<U>::const_iterator itU = indexMapU.find(objectU);
+                if (itU == indexMapU.end())
                     throw cet::exception("LArPandora") << " LArPandoraEvent::WriteAssociation -- association map contains object not in collectionU." << std::endl;
 
-                art::Ptr<U> newObjectU(makePtrU(std::distance(collectionU.begin(), itU)));
+                art::Ptr<U> newObjectU((*makePtrU)(itU->second));
                 util::CreateAssn(*m_pProducer, *m_pEvent, newObjectU, newObjectT, *outputAssn);
             }
             else
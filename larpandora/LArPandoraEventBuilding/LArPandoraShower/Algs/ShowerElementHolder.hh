@@ -17,10 +17,14 @@
 
 //C++ Inlcudes
 #include <iostream>
+#include <limits>
 #include <map>
 #include <string>
 #include <memory>
 #include <iomanip>
+#include <typeindex>
+#include <utility>
+#include <vector>
 #include "cetlib_except/demangle.h"
 
 namespace reco::shower {
@@ -29,7 +33,12 @@ namespace reco::shower {
   template <class T> class ShowerDataProduct;
   template <class T> class EventDataProduct;
   template <class T, class T2> class ShowerProperty;
+  template <class E> class ShowerElementHandle;
   class ShowerElementHolder;
+
+  template <class T> using ShowerDataProductHandle = ShowerElementHandle<ShowerDataProduct<T> >;
+  template <class T> using EventDataProductHandle = ShowerElementHandle<EventDataProduct<T> >;
+  template <class T, class T2> using ShowerPropertyHandle = ShowerElementHandle<ShowerProperty<T,T2> >;
 }
 
 class reco::shower::ShowerElementBase {
@@ -53,7 +62,7 @@ class reco::shower::ShowerElementBase {
       else return false;
     }
 
-    void Clear(){
+    virtual void Clear(){
       elementPtr    = 0;
     }
 
@@ -72,14 +81,22 @@ class reco::shower::ShowerElementAccessor : public reco::shower::ShowerElementBa
 
   public:
 
-    ShowerElementAccessor(T& Element):
+    typedef T ElementType;
+
+    ShowerElementAccessor(const T& Element):
       element(Element){
         this->elementPtr      = 1;
         // this->element         = Element;
       }
 
+    //Create an empty element. Used when the element is registered before it is set.
+    ShowerElementAccessor():
+      element(){
+        this->elementPtr      = 0;
+      }
+
     //Set the element in the holder
-    void SetShowerElement(T& Element){
+    void SetShowerElement(const T& Element){
       element = Element;
       this->elementPtr = 1;
     }
@@ -103,6 +120,13 @@ class reco::shower::ShowerElementAccessor : public reco::shower::ShowerElementBa
       return element;
     }
 
+    const T& GetShowerElementRef() const {
+      if(!this->elementPtr){
+        throw cet::exception("ShowerElementHolder") << "The element that is being accessed is not set" << std::endl;
+      }
+      return element;
+    }
+
     T GetShowerElement() const {
       if(!this->elementPtr){
         throw cet::exception("ShowerElementHolder") << "The element that is being accessed is not set" << std::endl;
@@ -125,13 +149,18 @@ class reco::shower::ShowerDataProduct : public reco::shower::ShowerElementAccess
 
   public:
 
-    ShowerDataProduct(T& Element, bool Checktag):
+    ShowerDataProduct(const T& Element, bool Checktag):
       reco::shower::ShowerElementAccessor<T>{Element} {
         checktag              = Checktag;
       }
 
+    explicit ShowerDataProduct(bool Checktag):
+      reco::shower::ShowerElementAccessor<T>{} {
+        checktag              = Checktag;
+      }
 
-    void Clear(){
+
+    void Clear() override {
       this->element       = T();
       this->elementPtr    = 0;
     }
@@ -158,12 +187,17 @@ class reco::shower::EventDataProduct : public reco::shower::ShowerElementAccesso
 
   public:
 
-    EventDataProduct(T& Element):
+    EventDataProduct(const T& Element):
       reco::shower::ShowerElementAccessor<T>{Element} {
       }
 
-    void Clear(){
-      // this->element    = T();
+    EventDataProduct():
+      reco::shower::ShowerElementAccessor<T>{} {
+      }
+
+    //The element is not reset here, as it is not necessarily assignable e.g. art::FindManyP. The holder releases the
+    //event data products instead.
+    void Clear() override {
       this->elementPtr = 0;
     }
 };
@@ -174,11 +208,16 @@ class reco::shower::ShowerProperty : public reco::shower::ShowerElementAccessor<
 
   public:
 
-    ShowerProperty(T& Element, T2& ElementErr):
+    ShowerProperty(const T& Element, const T2& ElementErr):
       reco::shower::ShowerElementAccessor<T>{Element} {
         propertyErr      = ElementErr;
       }
 
+    ShowerProperty():
+      reco::shower::ShowerElementAccessor<T>{},
+      propertyErr() {
+      }
+
     //Fill the property error as long as it has been set.
     int GetShowerPropertyError(T2& ElementErr) const {
       if(this->elementPtr){
@@ -190,16 +229,25 @@ class reco::shower::ShowerProperty : public reco::shower::ShowerElementAccessor<
       }
     }
 
+    //Return the property error. The property must have been set.
+    const T2& GetShowerPropertyErrorRef() const {
+      if(!this->elementPtr){
+        throw cet::exception("ShowerElementHolder") << "The element that is being accessed is not set" << std::endl;
+      }
+      return propertyErr;
+    }
+
     //Set the properties. Note you cannot set an property without an error.
-    void SetShowerProperty(T& Element, T2& ElementErr) {
+    void SetShowerProperty(const T& Element, const T2& ElementErr) {
       this->element    = Element;
       this->elementPtr = 1;
       propertyErr      = ElementErr;
     }
 
-    void Clear(){
-      this->element = T();
+    void Clear() override {
+      this->element    = T();
       this->elementPtr = 0;
+      propertyErr      = T2();
     }
 
   private:
@@ -208,19 +256,113 @@ class reco::shower::ShowerProperty : public reco::shower::ShowerElementAccessor<
 };
 
 
+//Typed handle to an element in the ShowerElementHolder. Handles are given out when an element is registered with the holder,
+//usually when the module and tools are constructed, and give direct access to the element without a name lookup or a dynamic_cast.
+template <class E>
+class reco::shower::ShowerElementHandle {
+
+  public:
+
+    ShowerElementHandle():
+      slot(std::numeric_limits<size_t>::max()) {}
+
+    //Check if the handle has been given out by the holder.
+    bool IsValid() const {
+      return slot != std::numeric_limits<size_t>::max();
+    }
+
+  private:
+
+    friend class reco::shower::ShowerElementHolder;
+
+    explicit ShowerElementHandle(size_t Slot):
+      slot(Slot) {}
+
+    size_t slot;
+};
+
 //Class to holder all the reco::shower::ShowerElement objects. This is essentially a map from a string the object so people can
-//add an object in a tool and get it back later.
+//add an object in a tool and get it back later. Each element is stored in a fixed slot, so an element can also be registered
+//up front and accessed through a typed handle, which avoids the string lookup and the type check on every access.
 class reco::shower::ShowerElementHolder{
 
   public:
 
+    //Register a data product and return the handle to access it. If the name is already registered with the same type the
+    //existing element is used. e.g. ShowerElementHolder.RegisterElement<recob::PCAxis>("ShowerPCA");
+    template <class T>
+      ShowerDataProductHandle<T> RegisterElement(const std::string& Name, bool checktag=false){
+        return RegisterSlot<ShowerDataProduct<T> >(showerdataproducts, Name, checktag);
+      }
+
+    //Register a property, which has an associated error, and return the handle to access it.
+    template <class T, class T2>
+      ShowerPropertyHandle<T,T2> RegisterProperty(const std::string& Name){
+        return RegisterSlot<ShowerProperty<T,T2> >(showerproperties, Name);
+      }
+
+    //Register an event data product and return the handle to access it.
+    template <class T>
+      EventDataProductHandle<T> RegisterEventElement(const std::string& Name){
+        return RegisterSlot<EventDataProduct<T> >(eventdataproducts, Name);
+      }
+
+    //Check that the element behind a handle is filled.
+    template <class E>
+      bool CheckElement(const ShowerElementHandle<E>& Handle) const {
+        const E* element = FindSlot(Handle);
+        return element != nullptr && element->CheckShowerElement();
+      }
+
+    //Return a reference to the element behind a handle. This throws if the element has not been filled.
+    template <class E>
+      const typename E::ElementType& GetElement(const ShowerElementHandle<E>& Handle) const {
+        return GetSlot(Handle).GetShowerElementRef();
+      }
+
+    //Return a reference to the error of the property behind a handle. This throws if the property has not been filled.
+    template <class T, class T2>
+      const T2& GetElementError(const ShowerPropertyHandle<T,T2>& Handle) const {
+        return GetSlot(Handle).GetShowerPropertyErrorRef();
+      }
+
+    //Set the data product behind a handle. The element is recreated if it has been deleted.
+    template <class T>
+      void SetElement(const ShowerDataProductHandle<T>& Handle, const typename ShowerDataProduct<T>::ElementType& dataproduct, bool checktag=false){
+        ShowerDataProduct<T>* showerdataprod = FindSlot(Handle);
+        if(showerdataprod == nullptr){
+          elements[Handle.slot] = std::make_unique<ShowerDataProduct<T> >(dataproduct,checktag);
+          return;
+        }
+        showerdataprod->SetShowerElement(dataproduct);
+        showerdataprod->SetCheckTag(checktag);
+      }
+
+    //Set the property behind a handle. The element is recreated if it has been deleted.
+    template <class T, class T2>
+      void SetElement(const ShowerPropertyHandle<T,T2>& Handle, const typename ShowerProperty<T,T2>::ElementType& propertyval, const T2& propertyvalerror){
+        ShowerProperty<T,T2>* showerprop = FindSlot(Handle);
+        if(showerprop == nullptr){
+          elements[Handle.slot] = std::make_unique<ShowerProperty<T,T2> >(propertyval,propertyvalerror);
+          return;
+        }
+        showerprop->SetShowerProperty(propertyval,propertyvalerror);
+      }
+
+    //Set the event data product behind a handle. This is replaced rather than assigned, see SetEventElement below.
+    template <class T>
+      void SetEventElement(const EventDataProductHandle<T>& Handle, const typename EventDataProduct<T>::ElementType& dataproduct){
+        FindSlot(Handle); //Checks the handle has been registered
+        elements[Handle.slot] = std::make_unique<EventDataProduct<T> >(dataproduct);
+      }
+
     //Getter function for accessing the shower property e..g the direction ShowerElementHolder.GetElement("MyShowerValue"); The name is used access the value and precise names are required for a complete shower in LArPandoraModularShowerCreation: ShowerStartPosition, ShowerDirection, ShowerEnergy ,ShowerdEdx.
     template <class T >
       int GetElement(const std::string& Name, T& Element) const {
         auto const showerPropertiesIt = showerproperties.find(Name);
         if(showerPropertiesIt != showerproperties.end()){
-          if(showerPropertiesIt->second->CheckShowerElement()){
-            reco::shower::ShowerElementAccessor<T> *showerprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(showerPropertiesIt->second.get());
+          if(IsSlotSet(showerPropertiesIt->second)){
+            reco::shower::ShowerElementAccessor<T> *showerprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(elements[showerPropertiesIt->second].get());
             if(showerprop == nullptr){
               throw cet::exception("ShowerElementHolder") << "Trying to get Element: " << Name << ". This element you are filling is not the correct type" << std::endl;
             }
@@ -235,8 +377,8 @@ class reco::shower::ShowerElementHolder{
 
         auto const showerDataProductsIt = showerdataproducts.find(Name);
         if(showerDataProductsIt != showerdataproducts.end()){
-          if(showerDataProductsIt->second->CheckShowerElement()){
-            reco::shower::ShowerElementAccessor<T> *showerprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(showerDataProductsIt->second.get());
+          if(IsSlotSet(showerDataProductsIt->second)){
+            reco::shower::ShowerElementAccessor<T> *showerprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(elements[showerDataProductsIt->second].get());
             if(showerprop == nullptr){
               throw cet::exception("ShowerElementHolder") << "Trying to get Element: " << Name << ". This element you are filling is not the correct type" << std::endl;
             }
@@ -251,8 +393,8 @@ class reco::shower::ShowerElementHolder{
 
         auto const eventDataProductsIt = eventdataproducts.find(Name);
         if (eventDataProductsIt != eventdataproducts.end()){
-          if(eventDataProductsIt->second->CheckShowerElement()){
-            reco::shower::ShowerElementAccessor<T> *eventprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(eventDataProductsIt->second.get());
+          if(IsSlotSet(eventDataProductsIt->second)){
+            reco::shower::ShowerElementAccessor<T> *eventprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(elements[eventDataProductsIt->second].get());
             if(eventprop == nullptr){
               throw cet::exception("ShowerElementHolder") << "Trying to get Element: " << Name << ". This element you are filling is not the correct type" << std::endl;
             }
@@ -270,8 +412,8 @@ class reco::shower::ShowerElementHolder{
       int GetEventElement(const std::string& Name, T& Element) const {
         auto const eventDataProductsIt = eventdataproducts.find(Name);
         if (eventDataProductsIt != eventdataproducts.end()){
-          if(eventDataProductsIt->second->CheckShowerElement()){
-            reco::shower::ShowerElementAccessor<T> *eventprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(eventDataProductsIt->second.get());
+          if(IsSlotSet(eventDataProductsIt->second)){
+            reco::shower::ShowerElementAccessor<T> *eventprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(elements[eventDataProductsIt->second].get());
             if(eventprop == nullptr){
               throw cet::exception("ShowerElementHolder") << "Trying to get Element: " << Name << ". This element you are filling is not the correct type" << std::endl;
             }
@@ -290,8 +432,8 @@ class reco::shower::ShowerElementHolder{
       const T& GetEventElement(std::string const& Name) {
         auto const eventDataProductsIt = eventdataproducts.find(Name);
         if (eventDataProductsIt != eventdataproducts.end()){
-          if(eventDataProductsIt->second->CheckShowerElement()){
-            reco::shower::ShowerElementAccessor<T> *eventprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(eventDataProductsIt->second.get());
+          if(IsSlotSet(eventDataProductsIt->second)){
+            reco::shower::ShowerElementAccessor<T> *eventprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(elements[eventDataProductsIt->second].get());
             if(eventprop == nullptr){
               throw cet::exception("ShowerElementHolder") << "Trying to get Element: " << Name << ". This element you are filling is not the correct type" << std::endl;
             }
@@ -306,8 +448,8 @@ class reco::shower::ShowerElementHolder{
       T GetElement(const std::string& Name) const {
         auto const showerPropertiesIt = showerproperties.find(Name);
         if(showerPropertiesIt != showerproperties.end()){
-          if(showerPropertiesIt->second->CheckShowerElement()){
-            reco::shower::ShowerElementAccessor<T> *showerprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(showerPropertiesIt->second.get());
+          if(IsSlotSet(showerPropertiesIt->second)){
+            reco::shower::ShowerElementAccessor<T> *showerprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(elements[showerPropertiesIt->second].get());
             if(showerprop == nullptr){
               throw cet::exception("ShowerElementHolder") << "Trying to get Element: " << Name << ". This element you are filling is not the correct type" << std::endl;
             }
@@ -317,8 +459,8 @@ class reco::shower::ShowerElementHolder{
 
         auto const showerDataProductsIt = showerdataproducts.find(Name);
         if(showerDataProductsIt != showerdataproducts.end()){
-          if(showerDataProductsIt->second->CheckShowerElement()){
-            reco::shower::ShowerElementAccessor<T> *showerprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(showerDataProductsIt->second.get());
+          if(IsSlotSet(showerDataProductsIt->second)){
+            reco::shower::ShowerElementAccessor<T> *showerprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(elements[showerDataProductsIt->second].get());
             if(showerprop == nullptr){
               throw cet::exception("ShowerElementHolder") << "Trying to get Element: " << Name << ". This element you are filling is not the correct type" << std::endl;
             }
@@ -328,8 +470,8 @@ class reco::shower::ShowerElementHolder{
 
         auto const eventDataProductsIt = eventdataproducts.find(Name);
         if (eventDataProductsIt != eventdataproducts.end()){
-          if(eventDataProductsIt->second->CheckShowerElement()){
-            reco::shower::ShowerElementAccessor<T> *eventprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(eventDataProductsIt->second.get());
+          if(IsSlotSet(eventDataProductsIt->second)){
+            reco::shower::ShowerElementAccessor<T> *eventprop = dynamic_cast<reco::shower::ShowerElementAccessor<T> *>(elements[eventDataProductsIt->second].get());
             if(eventprop == nullptr){
               throw cet::exception("ShowerElementHolder") << "Trying to get Element: " << Name << ". This element you are filling is not the correct type" << std::endl;
             }
@@ -347,7 +489,14 @@ class reco::shower::ShowerElementHolder{
           mf::LogError("ShowerElementHolder") << "Trying to get Element Error: " << Name << ". This elment does not exist in the element holder" << std::endl;
           return 1;
         }
-        reco::shower::ShowerProperty<T,T2> *showerprop = dynamic_cast<reco::shower::ShowerProperty<T,T2> *>(showerPropertiesIt->second.get());
+        if(!elements[showerPropertiesIt->second]){
+          mf::LogWarning("ShowerElementHolder") << "Trying to get Element Error: " << Name << ". This elment has not been filled" << std::endl;
+          return 1;
+        }
+        reco::shower::ShowerProperty<T,T2> *showerprop = dynamic_cast<reco::shower::ShowerProperty<T,T2> *>(elements[showerPropertiesIt->second].get());
+        if(showerprop == nullptr){
+          throw cet::exception("ShowerElementHolder") << "Trying to get Element: " << Name << ". This element you are filling is not the correct type" << std::endl;
+        }
         showerprop->GetShowerElement(Element);
         showerprop->GetShowerPropertyError(ElementErr);
         return 0;
@@ -361,13 +510,18 @@ class reco::shower::ShowerElementHolder{
 
         auto const showerDataProductsIt = showerdataproducts.find(Name);
         if(showerDataProductsIt != showerdataproducts.end()){
-          reco::shower::ShowerDataProduct<T>* showerdataprod = dynamic_cast<reco::shower::ShowerDataProduct<T> *>(showerDataProductsIt->second.get());
+          CheckSlotType<ShowerDataProduct<T> >(showerDataProductsIt->second, Name);
+          if(!elements[showerDataProductsIt->second]){
+            elements[showerDataProductsIt->second] = std::make_unique<ShowerDataProduct<T> >(dataproduct,checktag);
+            return;
+          }
+          reco::shower::ShowerDataProduct<T>* showerdataprod = static_cast<reco::shower::ShowerDataProduct<T> *>(elements[showerDataProductsIt->second].get());
           showerdataprod->SetShowerElement(dataproduct);
           showerdataprod->SetCheckTag(checktag);
           return;
         }
         else{
-          showerdataproducts[Name] = std::make_unique<ShowerDataProduct<T> >(dataproduct,checktag);
+          showerdataproducts[Name] = AddElement(std::make_unique<ShowerDataProduct<T> >(dataproduct,checktag));
           return;
         }
       }
@@ -379,12 +533,17 @@ class reco::shower::ShowerElementHolder{
 
         auto const showerPropertiesIt = showerproperties.find(Name);
         if(showerPropertiesIt != showerproperties.end()){
-          reco::shower::ShowerProperty<T,T2>* showerprop = dynamic_cast<reco::shower::ShowerProperty<T,T2> *>(showerPropertiesIt->second.get());
+          CheckSlotType<ShowerProperty<T,T2> >(showerPropertiesIt->second, Name);
+          if(!elements[showerPropertiesIt->second]){
+            elements[showerPropertiesIt->second] = std::make_unique<ShowerProperty<T,T2> >(propertyval,propertyvalerror);
+            return;
+          }
+          reco::shower::ShowerProperty<T,T2>* showerprop = static_cast<reco::shower::ShowerProperty<T,T2> *>(elements[showerPropertiesIt->second].get());
           showerprop->SetShowerProperty(propertyval,propertyvalerror);
           return;
         }
         else{
-          showerproperties[Name] = std::make_unique<ShowerProperty<T,T2> >(propertyval,propertyvalerror);
+          showerproperties[Name] = AddElement(std::make_unique<ShowerProperty<T,T2> >(propertyval,propertyvalerror));
           return;
         }
       }
@@ -394,36 +553,38 @@ class reco::shower::ShowerElementHolder{
     template <class T>
       void SetEventElement(T& dataproduct, const std::string& Name){
 
+        //Replace rather than assign the event data product, as these are not necessarily assignable e.g. art::FindManyP.
+        //The slot keeps its type, so that the handles to it stay valid.
         auto const eventDataProductsIt = eventdataproducts.find(Name);
         if (eventDataProductsIt != eventdataproducts.end()){
-          reco::shower::EventDataProduct<T>* eventdataprod = dynamic_cast<reco::shower::EventDataProduct<T> *>(eventDataProductsIt->second.get());
-          eventdataprod->SetShowerElement(dataproduct);
+          CheckSlotType<EventDataProduct<T> >(eventDataProductsIt->second, Name);
+          elements[eventDataProductsIt->second] = std::make_unique<EventDataProduct<T> >(dataproduct);
           return;
         }
         else{
-          eventdataproducts[Name] = std::make_unique<EventDataProduct<T> >(dataproduct);
+          eventdataproducts[Name] = AddElement(std::make_unique<EventDataProduct<T> >(dataproduct));
           return;
         }
       }
 
     bool CheckEventElement(const std::string& Name) const {
       auto const eventDataProductsIt = eventdataproducts.find(Name);
-      return eventDataProductsIt == eventdataproducts.end() ? false : eventDataProductsIt->second->CheckShowerElement();
+      return eventDataProductsIt == eventdataproducts.end() ? false : IsSlotSet(eventDataProductsIt->second);
     }
 
     //Check that a property is filled
     bool CheckElement(const std::string& Name) const {
       auto const showerPropertiesIt = showerproperties.find(Name);
       if(showerPropertiesIt != showerproperties.end()){
-        return showerPropertiesIt->second->CheckShowerElement();
+        return IsSlotSet(showerPropertiesIt->second);
       }
       auto const showerDataProductsIt = showerdataproducts.find(Name);
       if(showerDataProductsIt != showerdataproducts.end()){
-        return showerDataProductsIt->second->CheckShowerElement();
+        return IsSlotSet(showerDataProductsIt->second);
       }
       auto const eventDataProductsIt = eventdataproducts.find(Name);
       if(eventDataProductsIt!= eventdataproducts.end()){
-        return eventDataProductsIt->second->CheckShowerElement();
+        return IsSlotSet(eventDataProductsIt->second);
       }
       return false;
     }
@@ -432,10 +593,10 @@ class reco::shower::ShowerElementHolder{
     bool CheckAllElements() const {
       bool checked = true;
       for(auto const& showerprop: showerproperties){
-        checked *= showerprop.second->CheckShowerElement();
+        checked *= IsSlotSet(showerprop.second);
       }
       for(auto const& showerdataprod: showerdataproducts){
-        checked *= showerdataprod.second->CheckShowerElement();
+        checked *= IsSlotSet(showerdataprod.second);
       }
       return checked;
     }
@@ -445,11 +606,11 @@ class reco::shower::ShowerElementHolder{
     void ClearElement(const std::string&  Name){
       auto const showerPropertiesIt = showerproperties.find(Name);
       if(showerPropertiesIt != showerproperties.end()){
-        return showerPropertiesIt->second->Clear();
+        return ClearSlot(showerPropertiesIt->second);
       }
       auto const showerDataProductsIt = showerdataproducts.find(Name);
       if(showerDataProductsIt != showerdataproducts.end()){
-        return showerDataProductsIt->second->Clear();
+        return ClearSlot(showerDataProductsIt->second);
       }
       mf::LogError("ShowerElementHolder") << "Trying to clear Element: " << Name << ". This element does not exist in the element holder" << std::endl;
       return;
@@ -458,16 +619,17 @@ class reco::shower::ShowerElementHolder{
     //Clear all the shower properties. This does not delete the element.
     void ClearShower(){
       for(auto const& showerprop: showerproperties){
-        (showerprop.second)->Clear();
+        ClearSlot(showerprop.second);
       }
       for(auto const& showerdataproduct: showerdataproducts){
-        (showerdataproduct.second)->Clear();
+        ClearSlot(showerdataproduct.second);
       }
     }
-    //Clear all the shower properties. This does not delete the element.
+    //Release all the event data products, so that e.g. the art::FindManyP of an event are not kept after it. The slots
+    //and their handles are kept.
     void ClearEvent(){
       for(auto const& eventdataproduct: eventdataproducts){
-        (eventdataproduct.second)->Clear();
+        elements[eventdataproduct.second].reset(nullptr);
       }
     }
     //Clear all the shower properties. This does not delete the element.
@@ -479,21 +641,21 @@ class reco::shower::ShowerElementHolder{
     //Find if the product is one what is being stored.
     bool CheckElementTag(const std::string& Name) const {
       auto const showerDataProductsIt = showerdataproducts.find(Name);
-      if(showerDataProductsIt != showerdataproducts.end()){
-        return showerDataProductsIt->second->CheckTag();
+      if(showerDataProductsIt != showerdataproducts.end() && elements[showerDataProductsIt->second]){
+        return elements[showerDataProductsIt->second]->CheckTag();
       }
       return false;
     }
 
-    //Delete a product. I see no reason for it.
+    //Delete a product. I see no reason for it. The name keeps its slot, so that it can only be set again with the same type.
     void DeleteElement(const std::string& Name){
       auto const showerPropertiesIt = showerproperties.find(Name);
       if(showerPropertiesIt != showerproperties.end()){
-        return showerPropertiesIt->second.reset(nullptr);
+        return elements[showerPropertiesIt->second].reset(nullptr);
       }
       auto const showerDataProductsIt = showerdataproducts.find(Name);
       if(showerDataProductsIt != showerdataproducts.end()){
-        return showerDataProductsIt->second.reset(nullptr);
+        return elements[showerDataProductsIt->second].reset(nullptr);
       }
       mf::LogError("ShowerElementHolder") << "Trying to delete Element: " << Name << ". This element does not exist in the element holder" << std::endl;
       return;
@@ -502,8 +664,8 @@ class reco::shower::ShowerElementHolder{
     //Set the indicator saying if the shower is going to be stored.
     void SetElementTag(const std::string& Name, bool checkelement){
       auto const showerDataProductsIt = showerdataproducts.find(Name);
-      if(showerDataProductsIt != showerdataproducts.end()){
-        return showerDataProductsIt->second->SetCheckTag(checkelement);
+      if(showerDataProductsIt != showerdataproducts.end() && elements[showerDataProductsIt->second]){
+        return elements[showerDataProductsIt->second]->SetCheckTag(checkelement);
       }
       mf::LogError("ShowerElementHolder") << "Trying set the checking of the data product: " << Name << ". This data product does not exist in the element holder" << std::endl;
       return;
@@ -512,9 +674,10 @@ class reco::shower::ShowerElementHolder{
     bool CheckAllElementTags() const {
       bool checked = true;
       for(auto const& showerdataproduct: showerdataproducts){
-        bool check  = showerdataproduct.second->CheckTag();
+        if(!elements[showerdataproduct.second]) continue;
+        bool check  = elements[showerdataproduct.second]->CheckTag();
         if(check){
-          bool elementset = showerdataproduct.second->CheckShowerElement();
+          bool elementset = elements[showerdataproduct.second]->CheckShowerElement();
           if(!elementset){
             mf::LogError("ShowerElementHolder") << "The following element is not set and was asked to be checked: " << showerdataproduct.first << std::endl;
             checked = false;
@@ -552,11 +715,13 @@ class reco::shower::ShowerElementHolder{
       std::map<std::string,std::string> Type_showerprops;
       std::map<std::string,std::string> Type_showerdataprods;
       for(auto const& showerprop: showerproperties){
-        std::string Type = (showerprop.second)->GetType();
+        if(!elements[showerprop.second]) continue;
+        std::string Type = elements[showerprop.second]->GetType();
         Type_showerprops[showerprop.first] = Type;
       }
       for(auto const& showerdataprod: showerdataproducts){
-        std::string Type = (showerdataprod.second)->GetType();
+        if(!elements[showerdataprod.second]) continue;
+        std::string Type = elements[showerdataprod.second]->GetType();
         Type_showerdataprods[showerdataprod.first] = Type;
       }
 
@@ -640,14 +805,81 @@ class reco::shower::ShowerElementHolder{
 
   private:
 
-    //Storage for all the shower properties.
-    std::map<std::string,std::unique_ptr<reco::shower::ShowerElementBase> > showerproperties;
+    //Add a new element to the storage and return its slot. The type of the element is kept with the slot.
+    template <class E>
+      size_t AddElement(std::unique_ptr<E> element){
+        elements.push_back(std::move(element));
+        elementtypes.emplace_back(typeid(E));
+        return elements.size() - 1;
+      }
+
+    //Check that a slot holds, or held before it was deleted, an element of the given type.
+    template <class E>
+      void CheckSlotType(size_t slot, const std::string& Name) const {
+        if(elementtypes[slot] != std::type_index(typeid(E))){
+          throw cet::exception("ShowerElementHolder") << "Trying to set Element: " << Name << ". This element you are setting is not the correct type" << std::endl;
+        }
+      }
+
+    //Check that a slot holds an element and that the element is filled.
+    bool IsSlotSet(size_t slot) const {
+      return elements[slot] && elements[slot]->CheckShowerElement();
+    }
+
+    //Clear the element in a slot, if there is one.
+    void ClearSlot(size_t slot){
+      if(elements[slot]) elements[slot]->Clear();
+    }
+
+    //Find or create the element with the given name and return the handle to its slot.
+    template <class E, class... Args>
+      ShowerElementHandle<E> RegisterSlot(std::map<std::string,size_t>& names, const std::string& Name, Args&&... args){
+        auto const namesIt = names.find(Name);
+        if(namesIt != names.end()){
+          if(elementtypes[namesIt->second] != std::type_index(typeid(E))){
+            throw cet::exception("ShowerElementHolder") << "Trying to register Element: " << Name << ". This element already exists with a different type" << std::endl;
+          }
+          return ShowerElementHandle<E>(namesIt->second);
+        }
+        const size_t slot = AddElement(std::make_unique<E>(std::forward<Args>(args)...));
+        names[Name] = slot;
+        return ShowerElementHandle<E>(slot);
+      }
+
+    //Resolve a handle to its element, or nullptr if the element has been deleted or released. The type was checked when
+    //the handle was registered and the type of a slot never changes.
+    template <class E>
+      E* FindSlot(const ShowerElementHandle<E>& Handle) const {
+        if(!Handle.IsValid()){
+          throw cet::exception("ShowerElementHolder") << "Trying to access an element with a handle that has not been registered" << std::endl;
+        }
+        return static_cast<E*>(elements[Handle.slot].get());
+      }
+
+    //Resolve a handle to its element. This throws if the element has been deleted or released.
+    template <class E>
+      E& GetSlot(const ShowerElementHandle<E>& Handle) const {
+        E* element = FindSlot(Handle);
+        if(element == nullptr){
+          throw cet::exception("ShowerElementHolder") << "The element that is being accessed is not set" << std::endl;
+        }
+        return *element;
+      }
+
+    //Storage for all the elements. The slot of an element, and its type, do not change once it has been created.
+    std::vector<std::unique_ptr<reco::shower::ShowerElementBase> > elements;
+
+    //Type of the element in each slot.
+    std::vector<std::type_index> elementtypes;
+
+    //Slots of all the shower properties.
+    std::map<std::string,size_t> showerproperties;
 
-    //Storage for all the data products
-    std::map<std::string,std::unique_ptr<reco::shower::ShowerElementBase> > showerdataproducts;
+    //Slots of all the data products
+    std::map<std::string,size_t> showerdataproducts;
 
-    //Storage for all the data products
-    std::map<std::string,std::unique_ptr<reco::shower::ShowerElementBase> > eventdataproducts;
+    //Slots of all the data products
+    std::map<std::string,size_t> eventdataproducts;
 
     //Shower ID number. Use this to set ptr makers.
     int showernumber;
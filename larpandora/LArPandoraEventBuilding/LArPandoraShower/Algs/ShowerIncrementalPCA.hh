@@ -0,0 +1,139 @@
+//###################################################################
+//### Name:        ShowerIncrementalPCA                           ###
+//### Date:        16.10.26                                       ###
+//### Description: Class to accumulate the weighted moments of a  ###
+//###              set of 3D points so that the centre and the    ###
+//###              principal axis can be updated as points are   ###
+//###              added and removed, without refitting all of    ###
+//###              the points. Used in the incremental track     ###
+//###              finders.                                       ###
+//###################################################################
+
+#ifndef ShowerIncrementalPCA_HH
+#define ShowerIncrementalPCA_HH
+
+//Framework includes
+#include "cetlib_except/exception.h"
+
+//Root Includes
+#include "TMatrixDSym.h"
+#include "TMatrixDSymEigen.h"
+#include "TVector3.h"
+
+//C++ Includes
+#include <cstddef>
+
+namespace reco::shower {
+  class ShowerIncrementalPCA;
+}
+
+//Each point is stored relative to the first point added, which keeps the second moments small and limits the rounding
+//error when points are removed again. Adding, removing and replacing a point are all constant time.
+class reco::shower::ShowerIncrementalPCA {
+
+  public:
+
+    ShowerIncrementalPCA(){
+      Clear();
+    }
+
+    //Add a point with the given weight.
+    void AddPoint(const TVector3& point, double weight=1){
+      if(numPoints == 0){
+        origin = point;
+      }
+      Accumulate(point, weight);
+      ++numPoints;
+    }
+
+    //Remove a point that was previously added with the same weight.
+    void RemovePoint(const TVector3& point, double weight=1){
+      if(numPoints == 0){
+        throw cet::exception("ShowerIncrementalPCA") << "Trying to remove a point from an empty PCA" << std::endl;
+      }
+      if(--numPoints == 0){
+        Clear();
+        return;
+      }
+      Accumulate(point, -weight);
+    }
+
+    //Replace a point that was previously added e.g. the last point of a track segment.
+    void ReplacePoint(const TVector3& oldPoint, const TVector3& newPoint, double oldWeight=1, double newWeight=1){
+      if(numPoints == 0){
+        throw cet::exception("ShowerIncrementalPCA") << "Trying to replace a point in an empty PCA" << std::endl;
+      }
+      Accumulate(oldPoint, -oldWeight);
+      Accumulate(newPoint, newWeight);
+    }
+
+    void Clear(){
+      numPoints  = 0;
+      sumWeights = 0;
+      origin     = TVector3(0,0,0);
+      for(unsigned int i=0; i<3; ++i){
+        sumPos[i] = 0;
+        for(unsigned int j=0; j<3; ++j){
+          sumPos2[i][j] = 0;
+        }
+      }
+    }
+
+    size_t NumPoints() const {
+      return numPoints;
+    }
+
+    double SumWeights() const {
+      return sumWeights;
+    }
+
+    //Return the weighted centre of the points.
+    TVector3 Centre() const {
+      if(sumWeights <= 0){
+        return TVector3{};
+      }
+      return origin + TVector3(sumPos[0], sumPos[1], sumPos[2]) * (1./sumWeights);
+    }
+
+    //Return the weighted covariance matrix of the points.
+    TMatrixDSym Covariance() const {
+      TMatrixDSym covariance(3);
+      if(sumWeights <= 0){
+        return covariance;
+      }
+      for(unsigned int i=0; i<3; ++i){
+        for(unsigned int j=0; j<3; ++j){
+          covariance(i,j) = sumPos2[i][j]/sumWeights - (sumPos[i]/sumWeights) * (sumPos[j]/sumWeights);
+        }
+      }
+      return covariance;
+    }
+
+    //Return the eigenvector of the covariance matrix with the largest eigenvalue.
+    TVector3 PrincipalAxis() const {
+      const TMatrixDSymEigen eigen(Covariance());
+      const TMatrixD& eigenvectors = eigen.GetEigenVectors();
+      return TVector3(eigenvectors[0][0], eigenvectors[1][0], eigenvectors[2][0]);
+    }
+
+  private:
+
+    void Accumulate(const TVector3& point, double weight){
+      const double relative[3] = {point.X() - origin.X(), point.Y() - origin.Y(), point.Z() - origin.Z()};
+      sumWeights += weight;
+      for(unsigned int i=0; i<3; ++i){
+        sumPos[i] += weight * relative[i];
+        for(unsigned int j=0; j<3; ++j){
+          sumPos2[i][j] += weight * relative[i] * relative[j];
+        }
+      }
+    }
+
+    size_t   numPoints;
+    double   sumWeights;
+    TVector3 origin;
+    double   sumPos[3];
+    double   sumPos2[3][3];
+};
+
+#endif
@@ -0,0 +1,118 @@
+//###################################################################
+//### Name:        ShowerSpatialIndex                             ###
+//### Date:        16.10.26                                       ###
+//### Description: KD-tree over a set of 3D points, used to find  ###
+//###              the closest point to a position e.g. matching  ###
+//###              space points and trajectory points in the      ###
+//###              shower tools                                   ###
+//###################################################################
+
+#ifndef ShowerSpatialIndex_HH
+#define ShowerSpatialIndex_HH
+
+//Root Includes
+#include "TVector3.h"
+
+//C++ Includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace reco::shower {
+  class ShowerSpatialIndex;
+}
+
+//The tree is stored implicitly: the points are reordered so that the median of each range, along the axis of that
+//level, sits in the middle of the range. The index of a point is its position in the vector given to Build. Points can
+//be removed from later searches, which is what the matching tools need when a point can only be used once.
+class reco::shower::ShowerSpatialIndex {
+
+  public:
+
+    ShowerSpatialIndex() = default;
+
+    explicit ShowerSpatialIndex(const std::vector<TVector3>& Points){
+      Build(Points);
+    }
+
+    //Build the tree. This is O(N log N).
+    void Build(const std::vector<TVector3>& Points){
+      points = Points;
+      removed.assign(points.size(), false);
+      order.resize(points.size());
+      for(size_t i=0; i<order.size(); ++i){
+        order[i] = i;
+      }
+      BuildRange(0, order.size(), 0);
+    }
+
+    //Exclude a point from any later searches.
+    void Remove(size_t index){
+      removed.at(index) = true;
+    }
+
+    size_t NumPoints() const {
+      return points.size();
+    }
+
+    //Find the closest point that is strictly closer than MaxDistance. If several points are equally close the one with
+    //the lowest index is returned, which is the same as a linear scan keeping the first closest point.
+    bool FindNearest(const TVector3& position, double MaxDistance, size_t& index) const {
+      double bestDistance = MaxDistance;
+      bool found = false;
+      SearchRange(0, order.size(), 0, position, bestDistance, index, found);
+      return found;
+    }
+
+  private:
+
+    static double Coordinate(const TVector3& point, unsigned int axis){
+      return axis == 0 ? point.X() : (axis == 1 ? point.Y() : point.Z());
+    }
+
+    void BuildRange(size_t begin, size_t end, unsigned int axis){
+      if(end - begin < 2) return;
+      const size_t middle = begin + (end - begin)/2;
+      std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+          [this, axis](size_t a, size_t b){ return Coordinate(points[a], axis) < Coordinate(points[b], axis); });
+      BuildRange(begin, middle, (axis + 1) % 3);
+      BuildRange(middle + 1, end, (axis + 1) % 3);
+    }
+
+    void SearchRange(size_t begin, size_t end, unsigned int axis, const TVector3& position,
+        double& bestDistance, size_t& bestIndex, bool& found) const {
+
+      if(begin >= end) return;
+
+      const size_t middle = begin + (end - begin)/2;
+      const size_t pointIndex = order[middle];
+
+      if(!removed[pointIndex]){
+        const double distance = (points[pointIndex] - position).Mag();
+        if(distance < bestDistance || (found && distance == bestDistance && pointIndex < bestIndex)){
+          bestDistance = distance;
+          bestIndex    = pointIndex;
+          found        = true;
+        }
+      }
+
+      //Search the side of the split the position is on first, then the other side if it could hold a closer point.
+      const double offset = Coordinate(position, axis) - Coordinate(points[pointIndex], axis);
+      const unsigned int nextAxis = (axis + 1) % 3;
+
+      if(offset < 0){
+        SearchRange(begin, middle, nextAxis, position, bestDistance, bestIndex, found);
+        if(std::abs(offset) <= bestDistance) SearchRange(middle + 1, end, nextAxis, position, bestDistance, bestIndex, found);
+      }
+      else{
+        SearchRange(middle + 1, end, nextAxis, position, bestDistance, bestIndex, found);
+        if(std::abs(offset) <= bestDistance) SearchRange(begin, middle, nextAxis, position, bestDistance, bestIndex, found);
+      }
+    }
+
+    std::vector<TVector3> points;
+    std::vector<bool>     removed;
+    std::vector<size_t>   order;
+};
+
+#endif
@@ -68,6 +68,9 @@ class reco::shower::LArPandoraModularShowerCreation : public art::EDProducer {
   //map to the unique ptrs to
   reco::shower::ShowerProducedPtrsHolder uniqueproducerPtrs;
 
+  //Holder for the shower elements. This is kept for the whole job so the tools can register their elements once.
+  reco::shower::ShowerElementHolder showerEleHolder;
+
   // Required services
   art::ServiceHandle<geo::Geometry> fGeom;
 };
@@ -167,6 +170,7 @@ reco::shower::LArPandoraModularShowerCreation::LArPandoraModularShowerCreation(f
     fShowerTools[i]->SetPtr(&producesCollector());
     fShowerTools[i]->InitaliseProducerPtr(uniqueproducerPtrs);
     fShowerTools[i]->InitialiseProducers();
+    fShowerTools[i]->InitialiseElements(showerEleHolder);
   }
 
   //Initialise the other paramters.
@@ -192,7 +196,9 @@ void reco::shower::LArPandoraModularShowerCreation::produce(art::Event& evt)
 
   //Ptr makers for the products
   uniqueproducerPtrs.SetPtrMakers(evt);
-  reco::shower::ShowerElementHolder showerEleHolder;
+
+  //Reset the elements from the previous event
+  showerEleHolder.ClearAll();
 
   //Get the PFParticles
   auto const pfpHandle = evt.getValidHandle<std::vector<recob::PFParticle>>(fPFParticleLabel);
@@ -439,6 +445,9 @@ void reco::shower::LArPandoraModularShowerCreation::produce(art::Event& evt)
     showerEleHolder.ClearShower();
   }
 
+  //Release the event data products, e.g. the FindManyP, rather than keeping them until the next event.
+  showerEleHolder.ClearEvent();
+
   //Put everything in the event.
   uniqueproducerPtrs.MoveAllToEvent(evt);
 
@@ -58,6 +58,10 @@ namespace ShowerRecoTools{
       //Function to initialise the producer i.e produces<std::vector<recob::Vertex> >(); commands go here.
       virtual void InitialiseProducers(){}
 
+      //Function to register the elements the tool uses with the element holder, so they can be accessed through typed handles
+      //i.e fShowerLengthHandle = ShowerEleHolder.RegisterProperty<double,double>(fShowerLengthOutputLabel); commands go here.
+      virtual void InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder){}
+
       //Set the point looking back at the producer module show we can make things in the module
       void SetPtr(art::ProducesCollector* collector){
         collectorPtr = collector;
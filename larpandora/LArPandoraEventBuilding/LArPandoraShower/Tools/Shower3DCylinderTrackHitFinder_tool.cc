@@ -27,6 +27,8 @@ namespace ShowerRecoTools{
           reco::shower::ShowerElementHolder& ShowerEleHolder
           ) override;
 
+      void InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder) override;
+
     private:
 
       std::vector<art::Ptr<recob::SpacePoint> > FindTrackSpacePoints(std::vector<art::Ptr<recob::SpacePoint> >& spacePoints,
@@ -46,6 +48,11 @@ namespace ShowerRecoTools{
       std::string fInitialTrackHitsOutputLabel;
       std::string fInitialTrackSpacePointsOutputLabel;
       std::string fShowerDirectionInputLabel;
+
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3>                       fShowerStartPositionInputHandle;
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3>                       fShowerDirectionInputHandle;
+      reco::shower::ShowerDataProductHandle<std::vector<art::Ptr<recob::Hit> > >        fInitialTrackHitsOutputHandle;
+      reco::shower::ShowerDataProductHandle<std::vector<art::Ptr<recob::SpacePoint> > > fInitialTrackSpacePointsOutputHandle;
   };
 
 
@@ -63,26 +70,30 @@ namespace ShowerRecoTools{
   {
   }
 
+  void Shower3DCylinderTrackHitFinder::InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder){
+    fShowerStartPositionInputHandle      = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerStartPositionInputLabel);
+    fShowerDirectionInputHandle          = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerDirectionInputLabel);
+    fInitialTrackHitsOutputHandle        = ShowerEleHolder.RegisterElement<std::vector<art::Ptr<recob::Hit> > >(fInitialTrackHitsOutputLabel);
+    fInitialTrackSpacePointsOutputHandle = ShowerEleHolder.RegisterElement<std::vector<art::Ptr<recob::SpacePoint> > >(fInitialTrackSpacePointsOutputLabel);
+  }
+
   int Shower3DCylinderTrackHitFinder::CalculateElement(const art::Ptr<recob::PFParticle>& pfparticle,
       art::Event& Event, reco::shower::ShowerElementHolder& ShowerEleHolder){
 
     //This is all based on the shower vertex being known. If it is not lets not do the track
-    if(!ShowerEleHolder.CheckElement(fShowerStartPositionInputLabel)){
+    if(!ShowerEleHolder.CheckElement(fShowerStartPositionInputHandle)){
       if (fVerbose)
         mf::LogError("Shower3DCylinderTrackHitFinder") << "Start position not set, returning "<< std::endl;
       return 1;
     }
-    if(!ShowerEleHolder.CheckElement("ShowerDirection")){
+    if(!ShowerEleHolder.CheckElement(fShowerDirectionInputHandle)){
       if (fVerbose)
         mf::LogError("Shower3DCylinderTrackHitFinder") << "Direction not set, returning "<< std::endl;
       return 1;
     }
 
-    TVector3 ShowerStartPosition = {-999,-999,-999};
-    ShowerEleHolder.GetElement(fShowerStartPositionInputLabel,ShowerStartPosition);
-
-    TVector3 ShowerDirection     = {-999,-999,-999};
-    ShowerEleHolder.GetElement(fShowerDirectionInputLabel,ShowerDirection);
+    TVector3 ShowerStartPosition = ShowerEleHolder.GetElement(fShowerStartPositionInputHandle);
+    TVector3 ShowerDirection     = ShowerEleHolder.GetElement(fShowerDirectionInputHandle);
 
     // Get the assocated pfParicle Handle
     auto const pfpHandle = Event.getValidHandle<std::vector<recob::PFParticle> >(fPFParticleLabel);
@@ -123,8 +134,8 @@ namespace ShowerRecoTools{
       trackHits.push_back(hit);
     }
 
-    ShowerEleHolder.SetElement(trackHits, fInitialTrackHitsOutputLabel);
-    ShowerEleHolder.SetElement(trackSpacePoints,fInitialTrackSpacePointsOutputLabel);
+    ShowerEleHolder.SetElement(fInitialTrackHitsOutputHandle,trackHits);
+    ShowerEleHolder.SetElement(fInitialTrackSpacePointsOutputHandle,trackSpacePoints);
 
     return 0;
   }
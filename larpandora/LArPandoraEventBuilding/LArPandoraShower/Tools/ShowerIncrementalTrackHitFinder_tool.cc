@@ -11,11 +11,14 @@
 
 //LArSoft Includes
 #include "larpandora/LArPandoraEventBuilding/LArPandoraShower/Tools/IShowerTool.h"
+#include "larpandora/LArPandoraEventBuilding/LArPandoraShower/Algs/ShowerIncrementalPCA.hh"
 
 //Root Includes
-#include "TPrincipal.h"
 #include "TGraph2D.h"
 
+//C++ Includes
+#include <deque>
+
 namespace ShowerRecoTools {
 
 
@@ -33,80 +36,85 @@ namespace ShowerRecoTools {
 
     private:
 
+      //Cached position and PCA weight of each of the space points the finder is run on. The finder works on indices into
+      //this cache so that the space point positions and charges are only looked up once.
+      struct SpacePointCache {
+        std::vector<art::Ptr<recob::SpacePoint> > sps;
+        std::vector<TVector3>                     positions;
+        std::vector<double>                       weights;
+      };
+
+      //A track segment, held as indices into the cache, and the PCA accumulated over its space points.
+      struct TrackSegment {
+        std::vector<size_t>                segment;
+        reco::shower::ShowerIncrementalPCA pca;
+      };
+
+      typedef std::deque<size_t> SpacePointPool;
+
       std::vector<art::Ptr<recob::SpacePoint> > RunIncrementalSpacePointFinder(
           const art::Event& Event,
           std::vector< art::Ptr< recob::SpacePoint> > const& sps,
           const art::FindManyP<recob::Hit> & fmh);
 
-      void PruneFrontOfSPSPool(
-          std::vector<art::Ptr<recob::SpacePoint> > & sps_pool,
-          std::vector<art::Ptr<recob::SpacePoint> > const& initial_track);
+      void FillSpacePointCache(const detinfo::DetectorClocksData& clockData,
+          const detinfo::DetectorPropertiesData& detProp,
+          std::vector< art::Ptr< recob::SpacePoint> > const& sps,
+          const art::FindManyP<recob::Hit> & fmh,
+          SpacePointCache& cache);
+
+      void PruneFrontOfSPSPool(const SpacePointCache& cache,
+          SpacePointPool & sps_pool,
+          std::vector<size_t> const& initial_track);
 
-      void PruneTrack(std::vector<art::Ptr<recob::SpacePoint> > & initial_track);
+      void PruneTrack(const SpacePointCache& cache, std::vector<size_t> & initial_track);
 
-      void AddSpacePointsToSegment(
-          std::vector<art::Ptr<recob::SpacePoint> > & segment,
-          std::vector<art::Ptr<recob::SpacePoint> > & sps_pool,
+      void AddSpacePointsToSegment(const SpacePointCache& cache,
+          TrackSegment & segment,
+          SpacePointPool & sps_pool,
           size_t num_sps_to_take);
 
-      bool IsSegmentValid(std::vector<art::Ptr<recob::SpacePoint> > const& segment);
+      void AddSpacePointsToPool(SpacePointPool & pool,
+          SpacePointPool & sps_pool,
+          size_t num_sps_to_take);
 
-      bool IncrementallyFitSegment(const detinfo::DetectorClocksData& clockData,
-          const detinfo::DetectorPropertiesData& detProp,
-          std::vector<art::Ptr<recob::SpacePoint> > & segment,
-          std::vector<art::Ptr< recob::SpacePoint> > & sps_pool,
-          const art::FindManyP<recob::Hit>  & fmh,
-          double current_residual);
+      void RemoveSpacePointFromSegment(const SpacePointCache& cache, TrackSegment & segment, size_t sp_iter);
 
-      double FitSegmentAndCalculateResidual(const detinfo::DetectorClocksData& clockData,
-          const detinfo::DetectorPropertiesData& detProp,
-          std::vector<art::Ptr<recob::SpacePoint> > & segment,
-          const art::FindManyP<recob::Hit> & fmh);
+      void ReplaceLastSpacePoint(const SpacePointCache& cache, TrackSegment & segment, size_t new_sp);
 
-      double FitSegmentAndCalculateResidual(const detinfo::DetectorClocksData& clockData,
-          const detinfo::DetectorPropertiesData& detProp,
-          std::vector<art::Ptr<recob::SpacePoint> > & segment,
-          const art::FindManyP<recob::Hit> & fmh,
-          int& max_residual_point);
+      bool IsSegmentValid(TrackSegment const& segment);
 
+      bool IncrementallyFitSegment(const SpacePointCache& cache,
+          TrackSegment & segment,
+          SpacePointPool & sps_pool);
 
-      bool RecursivelyReplaceLastSpacePointAndRefit(const detinfo::DetectorClocksData& clockData,
-          const detinfo::DetectorPropertiesData& detProp,
-          std::vector<art::Ptr<recob::SpacePoint> > & segment,
-          std::vector<art::Ptr< recob::SpacePoint> > & reduced_sps_pool,
-          const art::FindManyP<recob::Hit>  & fmh,
+      double FitSegmentAndCalculateResidual(const SpacePointCache& cache,
+          TrackSegment const& segment);
+
+      double FitSegmentAndCalculateResidual(const SpacePointCache& cache,
+          TrackSegment const& segment,
+          size_t& max_residual_point);
+
+      bool ReplaceLastSpacePointAndRefit(const SpacePointCache& cache,
+          TrackSegment & segment,
+          SpacePointPool & reduced_sps_pool,
           double current_residual);
 
       bool IsResidualOK(double new_residual, double current_residual) { return new_residual - current_residual < fMaxResidualDiff; };
       bool IsResidualOK(double new_residual, double current_residual, size_t no_sps) { return (new_residual - current_residual < fMaxResidualDiff && new_residual/no_sps < fMaxAverageResidual); };
       bool IsResidualOK(double residual, size_t no_sps) {return residual/no_sps < fMaxAverageResidual;}
 
-      double CalculateResidual(std::vector<art::Ptr<recob::SpacePoint> >& sps,
-          TVector3& PCAEigenvector,
-          TVector3& TrackPosition);
-
-      double CalculateResidual(std::vector<art::Ptr<recob::SpacePoint> >& sps,
-          TVector3& PCAEigenvector,
-          TVector3& TrackPosition,
-          int& max_residual_point);
-
-      //Function to calculate the shower direction using a charge weight 3D PCA calculation.
-      TVector3 ShowerPCAVector(std::vector<art::Ptr<recob::SpacePoint> >& sps);
-
-      TVector3 ShowerPCAVector(const detinfo::DetectorClocksData& clockData,
-          const detinfo::DetectorPropertiesData& detProp,
-          const std::vector<art::Ptr<recob::SpacePoint> >& sps,
-          const art::FindManyP<recob::Hit>& fmh);
+      double CalculateResidual(const SpacePointCache& cache,
+          std::vector<size_t> const& sps,
+          const TVector3& PCAEigenvector,
+          const TVector3& TrackPosition,
+          size_t& max_residual_point);
 
       std::vector<art::Ptr<recob::SpacePoint> > CreateFakeShowerTrajectory(TVector3 start_position, TVector3 start_direction);
       std::vector<art::Ptr<recob::SpacePoint> > CreateFakeSPLine(TVector3 start_position, TVector3 start_direction, int npoints);
       void RunTestOfIncrementalSpacePointFinder(const art::Event& Event, const art::FindManyP<recob::Hit>& dud_fmh);
 
-      void MakeTrackSeed(const detinfo::DetectorClocksData& clockData,
-          const detinfo::DetectorPropertiesData& detProp,
-          std::vector< art::Ptr< recob::SpacePoint> >& segment,
-          const art::FindManyP<recob::Hit> & fmh);
-
+      void MakeTrackSeed(const SpacePointCache& cache, TrackSegment& segment);
 
       //Services
       art::InputTag fPFParticleLabel;
@@ -274,128 +282,59 @@ namespace ShowerRecoTools {
   }
 
 
-  TVector3 ShowerIncrementalTrackHitFinder::ShowerPCAVector(std::vector<art::Ptr<recob::SpacePoint> >& sps){
-
-    //Initialise the the PCA.
-    TPrincipal *pca = new TPrincipal(3,"");
-
-    //Normalise the spacepoints, charge weight and add to the PCA.
-    for(auto& sp: sps){
-
-      TVector3 sp_position = IShowerTool::GetLArPandoraShowerAlg().SpacePointPosition(sp);
-
-      double sp_coord[3];
-      sp_coord[0] = sp_position.X();
-      sp_coord[1] = sp_position.Y();
-      sp_coord[2] = sp_position.Z();
-
-      //Add to the PCA
-      pca->AddRow(sp_coord);
-    }
-
-    //Evaluate the PCA
-    pca->MakePrincipals();
-
-    //Get the Eigenvectors.
-    const TMatrixD* Eigenvectors = pca->GetEigenVectors();
-
-    TVector3 Eigenvector = { (*Eigenvectors)[0][0], (*Eigenvectors)[1][0], (*Eigenvectors)[2][0] };
-
-    delete pca;
-
-    return Eigenvector;
-  }
-
-  //Function to calculate the shower direction using a charge weight 3D PCA calculation.
-  TVector3 ShowerIncrementalTrackHitFinder::ShowerPCAVector(const detinfo::DetectorClocksData& clockData,
+  //Cache the position and PCA weight of each space point. When charge weighting, the weight is the lifetime corrected
+  //charge of the space point, as used for the charge weighted shower centre.
+  void ShowerIncrementalTrackHitFinder::FillSpacePointCache(const detinfo::DetectorClocksData& clockData,
       const detinfo::DetectorPropertiesData& detProp,
-      const std::vector<art::Ptr<recob::SpacePoint> >& sps,
-      const art::FindManyP<recob::Hit>& fmh){
-
-    //Initialise the the PCA.
-    TPrincipal *pca = new TPrincipal(3,"");
-
-    float TotalCharge = 0;
+      std::vector< art::Ptr< recob::SpacePoint> > const& sps,
+      const art::FindManyP<recob::Hit> & fmh,
+      SpacePointCache& cache){
 
-    //Normalise the spacepoints, charge weight and add to the PCA.
-    for(auto& sp: sps){
+    cache.sps = sps;
+    cache.positions.clear();
+    cache.weights.clear();
+    cache.positions.reserve(sps.size());
+    cache.weights.reserve(sps.size());
 
-      TVector3 sp_position = IShowerTool::GetLArPandoraShowerAlg().SpacePointPosition(sp);
+    for(auto const& sp: sps){
 
-      float wht = 1;
+      cache.positions.push_back(IShowerTool::GetLArPandoraShowerAlg().SpacePointPosition(sp));
 
+      float charge = 1;
       if(fChargeWeighted){
-
-        //Get the charge.
-        float Charge = IShowerTool::GetLArPandoraShowerAlg().SpacePointCharge(sp,fmh);
-        //        std::cout << "Charge: " << Charge << std::endl;
-
-        //Get the time of the spacepoint
-        float Time = IShowerTool::GetLArPandoraShowerAlg().SpacePointTime(sp,fmh);
-
-        //Correct for the lifetime at the moment.
-        Charge *= std::exp((sampling_rate(clockData) * Time ) / (detProp.ElectronLifetime()*1e3));
-        //        std::cout << "Charge: "<< Charge << std::endl;
-
-        //Charge Weight
-        wht *= std::sqrt(Charge/TotalCharge);
+        charge = 0;
+        IShowerTool::GetLArPandoraShowerAlg().ShowerCentre(clockData, detProp, {sp}, fmh, charge);
       }
-
-      double sp_coord[3];
-      sp_coord[0] = sp_position.X()*wht;
-      sp_coord[1] = sp_position.Y()*wht;
-      sp_coord[2] = sp_position.Z()*wht;
-
-      //Add to the PCA
-      pca->AddRow(sp_coord);
+      cache.weights.push_back(charge);
     }
-
-    //Evaluate the PCA
-    pca->MakePrincipals();
-
-    //Get the Eigenvectors.
-    const TMatrixD* Eigenvectors = pca->GetEigenVectors();
-
-    TVector3 Eigenvector = { (*Eigenvectors)[0][0], (*Eigenvectors)[1][0], (*Eigenvectors)[2][0] };
-
-    delete pca;
-
-    return Eigenvector;
   }
 
   //Function to remove the spacepoint with the highest residual until we have a track which matches the
   //residual criteria.
-  void ShowerIncrementalTrackHitFinder::MakeTrackSeed(const detinfo::DetectorClocksData& clockData,
-      const detinfo::DetectorPropertiesData& detProp,
-      std::vector< art::Ptr< recob::SpacePoint> >& segment,
-      const art::FindManyP<recob::Hit> & fmh){
+  void ShowerIncrementalTrackHitFinder::MakeTrackSeed(const SpacePointCache& cache, TrackSegment& segment){
 
     bool ok=true;
 
-    int maxresidual_point = 0;
+    size_t maxresidual_point = 0;
 
     //Check the residual
-    double residual = FitSegmentAndCalculateResidual(clockData, detProp, segment, fmh, maxresidual_point);
+    double residual = FitSegmentAndCalculateResidual(cache, segment, maxresidual_point);
 
     //Is it okay
-    ok = IsResidualOK(residual, segment.size());
+    ok = IsResidualOK(residual, segment.segment.size());
 
     //Remove points until we can fit a track.
-    while(!ok && segment.size()!=1){
+    while(!ok && segment.segment.size()!=1){
 
       //Remove the point with the highest residual
-      for (auto sp = segment.begin(); sp != segment.end();  ++sp){
-        if(sp->key() == (unsigned) maxresidual_point){
-          segment.erase(sp);
-          break;
-        }
-      }
+      if(maxresidual_point >= segment.segment.size()) break;
+      RemoveSpacePointFromSegment(cache, segment, maxresidual_point);
 
       //Check the residual
-      double residual = FitSegmentAndCalculateResidual(clockData, detProp, segment, fmh, maxresidual_point);
+      double residual = FitSegmentAndCalculateResidual(cache, segment, maxresidual_point);
 
       //Is it okay
-      ok = IsResidualOK(residual, segment.size());
+      ok = IsResidualOK(residual, segment.segment.size());
 
     }
   }
@@ -408,16 +347,22 @@ namespace ShowerRecoTools {
     auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(Event);
     auto const detProp   = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(Event, clockData);
 
-    //Create space point pool (yes we are copying the input vector because we're going to twiddle with it
-    std::vector<art::Ptr<recob::SpacePoint> > sps_pool = sps;
-    std::vector<art::Ptr<recob::SpacePoint> > initial_track;
-    std::vector<art::Ptr<recob::SpacePoint> > track_segment_copy;
+    SpacePointCache cache;
+    FillSpacePointCache(clockData, detProp, sps, fmh, cache);
+
+    //Create space point pool of indices into the cache, in the order of the input space points
+    SpacePointPool sps_pool;
+    for(size_t sp_iter = 0; sp_iter < sps.size(); ++sp_iter){
+      sps_pool.push_back(sp_iter);
+    }
+    std::vector<size_t> initial_track;
+    std::vector<size_t> track_segment_copy;
 
     while (sps_pool.size() > 0){
-      //PruneFrontOfSPSPool(sps_pool, initial_track);
+      //PruneFrontOfSPSPool(cache, sps_pool, initial_track);
 
-      std::vector<art::Ptr<recob::SpacePoint> > track_segment;
-      AddSpacePointsToSegment(track_segment, sps_pool, (size_t)(fStartFitSize));
+      TrackSegment track_segment;
+      AddSpacePointsToSegment(cache, track_segment, sps_pool, (size_t)(fStartFitSize));
       if (!IsSegmentValid(track_segment)){
         //Clear the pool and lets leave this place
         sps_pool.clear();
@@ -426,27 +371,26 @@ namespace ShowerRecoTools {
 
       //Lets really try to make the initial track seed.
       if(fMakeTrackSeed && sps_pool.size()+fStartFitSize == sps.size()){
-        MakeTrackSeed(clockData, detProp, track_segment, fmh);
-        if(track_segment.empty())
+        MakeTrackSeed(cache, track_segment);
+        if(track_segment.segment.empty())
           break;
 
-        track_segment_copy = track_segment;
+        track_segment_copy = track_segment.segment;
 
       }
 
       //A sleight of hand coming up.  We are going to move the last sp from the segment back into the pool so
-      //that it makes kick starting the recursion easier (sneaky)
+      //that it makes kick starting the fitting easier (sneaky)
       //TODO defend against segments that are too small for this to work (I dunno who is running the alg with
       //fStartFitMinSize==0 but whatever
-      sps_pool.insert(sps_pool.begin(), track_segment.back());
-      track_segment.pop_back();
-      double current_residual = 0;
-      size_t initial_segment_size = track_segment.size();
+      sps_pool.push_front(track_segment.segment.back());
+      RemoveSpacePointFromSegment(cache, track_segment, track_segment.segment.size()-1);
+      size_t initial_segment_size = track_segment.segment.size();
 
-      IncrementallyFitSegment(clockData, detProp, track_segment, sps_pool, fmh, current_residual);
+      IncrementallyFitSegment(cache, track_segment, sps_pool);
 
       //Check if the track has grown in size at all
-      if (initial_segment_size == track_segment.size()){
+      if (initial_segment_size == track_segment.segment.size()){
         //The incremental fitter could not grow th track at all.  SAD!
         //Clear the pool and let's get out of here
         sps_pool.clear();
@@ -455,7 +399,7 @@ namespace ShowerRecoTools {
       else{
         //We did some good fitting and everyone is really happy with it
         //Let's store all of the hits in the final space point vector
-        AddSpacePointsToSegment(initial_track, track_segment, track_segment.size());
+        initial_track.insert(initial_track.end(), track_segment.segment.begin(), track_segment.segment.end());
       }
     }
 
@@ -464,215 +408,211 @@ namespace ShowerRecoTools {
       initial_track = track_segment_copy;
 
     //Runt the algorithm that attepmts to remove hits too far away from the track.
-    PruneTrack(initial_track);
+    PruneTrack(cache, initial_track);
 
-    return initial_track;
+    std::vector<art::Ptr<recob::SpacePoint> > initial_track_sps;
+    initial_track_sps.reserve(initial_track.size());
+    for(size_t const sp_iter: initial_track){
+      initial_track_sps.push_back(cache.sps[sp_iter]);
+    }
+    return initial_track_sps;
   }
 
-  void ShowerIncrementalTrackHitFinder::PruneFrontOfSPSPool(
-      std::vector<art::Ptr<recob::SpacePoint> > & sps_pool,
-      std::vector<art::Ptr<recob::SpacePoint> > const& initial_track){
+  void ShowerIncrementalTrackHitFinder::PruneFrontOfSPSPool(const SpacePointCache& cache,
+      SpacePointPool & sps_pool,
+      std::vector<size_t> const& initial_track){
 
     //If the initial track is empty then there is no pruning to do
     if (initial_track.empty()) return;
-    double distance = IShowerTool::GetLArPandoraShowerAlg().DistanceBetweenSpacePoints(initial_track.back(), sps_pool.front());
-    while (distance > 1 && sps_pool.size() > 0){
-      sps_pool.erase(sps_pool.begin());
-      distance = IShowerTool::GetLArPandoraShowerAlg().DistanceBetweenSpacePoints(initial_track.back(), sps_pool.front());
+    while (!sps_pool.empty() && (cache.positions[initial_track.back()] - cache.positions[sps_pool.front()]).Mag() > 1){
+      sps_pool.pop_front();
     }
     return;
   }
 
-  void ShowerIncrementalTrackHitFinder::PruneTrack(std::vector<art::Ptr<recob::SpacePoint> > & initial_track){
+  //Remove the space points that are too far from the previous kept space point. This is done in a single pass
+  //rather than by erasing from the middle of the track.
+  void ShowerIncrementalTrackHitFinder::PruneTrack(const SpacePointCache& cache, std::vector<size_t> & initial_track){
 
     if (initial_track.empty()) return;
-    std::vector<art::Ptr<recob::SpacePoint> >::iterator sps_it = initial_track.begin();
-    while (sps_it != std::next(initial_track.end(),-1)){
-      std::vector<art::Ptr<recob::SpacePoint> >::iterator next_sps_it = std::next(sps_it,1);
-      double distance = IShowerTool::GetLArPandoraShowerAlg().DistanceBetweenSpacePoints(*sps_it,*next_sps_it);
-      if (distance > fTrackMaxAdjacentSPDistance){
-        initial_track.erase(next_sps_it);
-      }
-      else{
-        sps_it++;
+    std::vector<size_t> pruned_track;
+    pruned_track.reserve(initial_track.size());
+    pruned_track.push_back(initial_track.front());
+    for (auto sps_it = std::next(initial_track.begin()); sps_it != initial_track.end(); ++sps_it){
+      double distance = (cache.positions[pruned_track.back()] - cache.positions[*sps_it]).Mag();
+      if (distance <= fTrackMaxAdjacentSPDistance){
+        pruned_track.push_back(*sps_it);
       }
     }
+    initial_track.swap(pruned_track);
     return;
   }
 
 
-  void ShowerIncrementalTrackHitFinder::AddSpacePointsToSegment(
-      std::vector<art::Ptr<recob::SpacePoint> > & segment,
-      std::vector<art::Ptr<recob::SpacePoint> > & sps_pool,
+  void ShowerIncrementalTrackHitFinder::AddSpacePointsToSegment(const SpacePointCache& cache,
+      TrackSegment & segment,
+      SpacePointPool & sps_pool,
       size_t num_sps_to_take){
-    size_t new_segment_size = segment.size() + num_sps_to_take;
-    while (segment.size() < new_segment_size && sps_pool.size() > 0){
-      segment.push_back(sps_pool[0]);
-      sps_pool.erase(sps_pool.begin());
+    size_t new_segment_size = segment.segment.size() + num_sps_to_take;
+    while (segment.segment.size() < new_segment_size && sps_pool.size() > 0){
+      const size_t sp_iter = sps_pool.front();
+      segment.segment.push_back(sp_iter);
+      segment.pca.AddPoint(cache.positions[sp_iter], cache.weights[sp_iter]);
+      sps_pool.pop_front();
     }
     return;
   }
 
-  bool ShowerIncrementalTrackHitFinder::IsSegmentValid(std::vector<art::Ptr<recob::SpacePoint> > const& segment){
+  void ShowerIncrementalTrackHitFinder::AddSpacePointsToPool(SpacePointPool & pool,
+      SpacePointPool & sps_pool,
+      size_t num_sps_to_take){
+    size_t new_pool_size = pool.size() + num_sps_to_take;
+    while (pool.size() < new_pool_size && sps_pool.size() > 0){
+      pool.push_back(sps_pool.front());
+      sps_pool.pop_front();
+    }
+    return;
+  }
+
+  void ShowerIncrementalTrackHitFinder::RemoveSpacePointFromSegment(const SpacePointCache& cache,
+      TrackSegment & segment, size_t sp_iter){
+    const size_t sp = segment.segment.at(sp_iter);
+    segment.pca.RemovePoint(cache.positions[sp], cache.weights[sp]);
+    segment.segment.erase(segment.segment.begin() + sp_iter);
+    return;
+  }
+
+  void ShowerIncrementalTrackHitFinder::ReplaceLastSpacePoint(const SpacePointCache& cache,
+      TrackSegment & segment, size_t new_sp){
+    const size_t old_sp = segment.segment.back();
+    segment.pca.ReplacePoint(cache.positions[old_sp], cache.positions[new_sp], cache.weights[old_sp], cache.weights[new_sp]);
+    segment.segment.back() = new_sp;
+    return;
+  }
+
+  bool ShowerIncrementalTrackHitFinder::IsSegmentValid(TrackSegment const& segment){
     bool ok = true;
-    if (segment.size() < (size_t)(fStartFitSize)) return !ok;
+    if (segment.segment.size() < (size_t)(fStartFitSize)) return !ok;
 
     return ok;
   }
 
-  bool ShowerIncrementalTrackHitFinder::IncrementallyFitSegment(const detinfo::DetectorClocksData& clockData,
-      const detinfo::DetectorPropertiesData& detProp,
-      std::vector<art::Ptr<recob::SpacePoint> > & segment,
-      std::vector<art::Ptr< recob::SpacePoint> > & sps_pool,
-      const art::FindManyP<recob::Hit> & fmh,
-      double current_residual){
+  bool ShowerIncrementalTrackHitFinder::IncrementallyFitSegment(const SpacePointCache& cache,
+      TrackSegment & segment,
+      SpacePointPool & sps_pool){
 
     bool ok = true;
-    //Firstly, are there any space points left???
-    if (sps_pool.empty()) return !ok;
     //Fit the current line
-    current_residual = FitSegmentAndCalculateResidual(clockData, detProp, segment, fmh);
-    //Take a space point from the pool and plonk it onto the seggieweggie
-    AddSpacePointsToSegment(segment, sps_pool, 1);
-    //Fit again
-    double residual = FitSegmentAndCalculateResidual(clockData, detProp, segment, fmh);
-
-    ok = IsResidualOK(residual, current_residual, segment.size());
-    if (!ok){
-      //Create a sub pool of space points to pass to the refitter
-      std::vector<art::Ptr<recob::SpacePoint> > sub_sps_pool;
-      AddSpacePointsToSegment(sub_sps_pool, sps_pool, fNMissPoints);
-      //We'll need an additional copy of this pool, as we will need the space points if we have to start a new
-      //segment later, but all of the funtionality drains the pools during use
-      std::vector<art::Ptr<recob::SpacePoint> > sub_sps_pool_cache = sub_sps_pool;
-      //The most recently added SP to the segment is bad but it will get thrown away by RecursivelyReplaceLastSpacePointAndRefit
-      //It's possible that we will need it if we end up forming an entirely new line from scratch, so
-      //add the bad SP to the front of the cache
-      sub_sps_pool_cache.insert(sub_sps_pool_cache.begin(), segment.back());
-      ok = RecursivelyReplaceLastSpacePointAndRefit(clockData, detProp, segment, sub_sps_pool, fmh, current_residual);
-      if (ok){
-        //The refitting may have dropped a couple of points but it managed to find a point that kept the residual
-        //at a sensible value.
-        //Add the remaining SPS in the reduced pool back t othe start of the larger pool
-        while (sub_sps_pool.size() > 0){
-          sps_pool.insert(sps_pool.begin(), sub_sps_pool.back());
-          sub_sps_pool.pop_back();
+    double current_residual = FitSegmentAndCalculateResidual(cache, segment);
+
+    //Round and round we go, until there are no space points left
+    //NOBODY GETS OFF MR BONES WILD RIDE
+    while (!sps_pool.empty()){
+      //Take a space point from the pool and plonk it onto the seggieweggie
+      AddSpacePointsToSegment(cache, segment, sps_pool, 1);
+      //Fit again
+      double residual = FitSegmentAndCalculateResidual(cache, segment);
+
+      ok = IsResidualOK(residual, current_residual, segment.segment.size());
+      if (!ok){
+        //Create a sub pool of space points to pass to the refitter
+        SpacePointPool sub_sps_pool;
+        AddSpacePointsToPool(sub_sps_pool, sps_pool, fNMissPoints);
+        //We'll need an additional copy of this pool, as we will need the space points if we have to start a new
+        //segment later, but all of the funtionality drains the pools during use
+        SpacePointPool sub_sps_pool_cache = sub_sps_pool;
+        //The most recently added SP to the segment is bad but it will get thrown away by ReplaceLastSpacePointAndRefit
+        //It's possible that we will need it if we end up forming an entirely new line from scratch, so
+        //add the bad SP to the front of the cache
+        sub_sps_pool_cache.push_front(segment.segment.back());
+        ok = ReplaceLastSpacePointAndRefit(cache, segment, sub_sps_pool, current_residual);
+        if (ok){
+          //The refitting may have dropped a couple of points but it managed to find a point that kept the residual
+          //at a sensible value.
+          //Add the remaining SPS in the reduced pool back t othe start of the larger pool
+          while (sub_sps_pool.size() > 0){
+            sps_pool.push_front(sub_sps_pool.back());
+            sub_sps_pool.pop_back();
+          }
+          //We'll need the latest residual now that we've managed to refit the track
+          residual = FitSegmentAndCalculateResidual(cache, segment);
         }
-        //We'll need the latest residual now that we've managed to refit the track
-        residual = FitSegmentAndCalculateResidual(clockData, detProp, segment, fmh);
-      }
-      else {
-        //All of the space points in the reduced pool could not sensibly refit the track.  The reduced pool will be
-        //empty so move all of the cached space points back into the main pool
-        //        std::cout<<"The refitting was NOT a success, dumping  all " << sub_sps_pool_cache.size() << "  sps back into the pool" << std::endl;
-        while (sub_sps_pool_cache.size() > 0){
-          sps_pool.insert(sps_pool.begin(), sub_sps_pool_cache.back());
-          sub_sps_pool_cache.pop_back();
+        else {
+          //All of the space points in the reduced pool could not sensibly refit the track.  The reduced pool will be
+          //empty so move all of the cached space points back into the main pool
+          while (sub_sps_pool_cache.size() > 0){
+            sps_pool.push_front(sub_sps_pool_cache.back());
+            sub_sps_pool_cache.pop_back();
+          }
+          //The bad point is still on the segment, so remove it
+          RemoveSpacePointFromSegment(cache, segment, segment.segment.size()-1);
+          return !ok;
         }
-        //The bad point is still on the segment, so remove it
-        segment.pop_back();
-        return !ok;
       }
-    }
 
-    //Update the residual
-    current_residual = residual;
+      //Update the residual
+      current_residual = residual;
+    }
 
-    //Round and round we go
-    //NOBODY GETS OFF MR BONES WILD RIDE
-    return IncrementallyFitSegment(clockData, detProp, segment, sps_pool, fmh, current_residual);
+    //There are no space points left
+    return false;
   }
 
-  double ShowerIncrementalTrackHitFinder::FitSegmentAndCalculateResidual(const detinfo::DetectorClocksData& clockData,
-      const detinfo::DetectorPropertiesData& detProp,
-      std::vector<art::Ptr<recob::SpacePoint> > & segment,
-      const art::FindManyP<recob::Hit> & fmh){
-
-    TVector3 primary_axis;
-    if (fChargeWeighted) primary_axis = ShowerPCAVector(clockData, detProp, segment, fmh);
-    else primary_axis = ShowerPCAVector(segment);
-
-    TVector3 segment_centre;
-    if (fChargeWeighted) segment_centre = IShowerTool::GetLArPandoraShowerAlg().ShowerCentre(clockData, detProp, segment,fmh);
-    else segment_centre = IShowerTool::GetLArPandoraShowerAlg().ShowerCentre(segment);
+  double ShowerIncrementalTrackHitFinder::FitSegmentAndCalculateResidual(const SpacePointCache& cache,
+      TrackSegment const& segment){
 
-    double residual = CalculateResidual(segment, primary_axis, segment_centre);
-
-    return residual;
+    size_t max_residual_point = 0;
+    return FitSegmentAndCalculateResidual(cache, segment, max_residual_point);
   }
 
-  double ShowerIncrementalTrackHitFinder::FitSegmentAndCalculateResidual(const detinfo::DetectorClocksData& clockData,
-      const detinfo::DetectorPropertiesData& detProp,
-      std::vector<art::Ptr<recob::SpacePoint> > & segment,
-      const art::FindManyP<recob::Hit> & fmh,
-      int& max_residual_point){
-
-    TVector3 primary_axis;
-    if (fChargeWeighted) primary_axis = ShowerPCAVector(clockData, detProp, segment, fmh);
-    else primary_axis = ShowerPCAVector(segment);
+  //The PCA is updated as space points are added to and removed from the segment, so getting the line is constant
+  //time. Only the residual needs a pass over the segment.
+  double ShowerIncrementalTrackHitFinder::FitSegmentAndCalculateResidual(const SpacePointCache& cache,
+      TrackSegment const& segment,
+      size_t& max_residual_point){
 
-    TVector3 segment_centre;
-    if (fChargeWeighted) segment_centre = IShowerTool::GetLArPandoraShowerAlg().ShowerCentre(clockData, detProp, segment,fmh);
-    else segment_centre = IShowerTool::GetLArPandoraShowerAlg().ShowerCentre(segment);
+    TVector3 primary_axis   = segment.pca.PrincipalAxis();
+    TVector3 segment_centre = segment.pca.Centre();
 
-    double residual = CalculateResidual(segment, primary_axis, segment_centre, max_residual_point);
+    double residual = CalculateResidual(cache, segment.segment, primary_axis, segment_centre, max_residual_point);
 
     return residual;
   }
 
 
 
-  bool ShowerIncrementalTrackHitFinder::RecursivelyReplaceLastSpacePointAndRefit(const detinfo::DetectorClocksData& clockData,
-      const detinfo::DetectorPropertiesData& detProp,
-      std::vector<art::Ptr<recob::SpacePoint> > & segment,
-      std::vector<art::Ptr< recob::SpacePoint> > & reduced_sps_pool,
-      const art::FindManyP<recob::Hit>  & fmh,
+  bool ShowerIncrementalTrackHitFinder::ReplaceLastSpacePointAndRefit(const SpacePointCache& cache,
+      TrackSegment & segment,
+      SpacePointPool & reduced_sps_pool,
       double current_residual){
 
-    bool ok = true;
-    //If the pool is empty, then there is nothing to do (sad)
-    if (reduced_sps_pool.empty()) return !ok;
-    //Drop the last space point
-    segment.pop_back();
-    //Add one point
-    AddSpacePointsToSegment(segment, reduced_sps_pool, 1);
-    double residual = FitSegmentAndCalculateResidual(clockData, detProp, segment, fmh);
-
-    ok = IsResidualOK(residual, current_residual, segment.size());
-    //    std::cout<<"recursive refit: isok " << ok << "  res: " << residual << "  curr res: " << current_residual << std::endl;
-    if (ok) return ok;
-    return RecursivelyReplaceLastSpacePointAndRefit(clockData, detProp, segment, reduced_sps_pool, fmh, current_residual);
-  }
-
-  double ShowerIncrementalTrackHitFinder::CalculateResidual(std::vector<art::Ptr<recob::SpacePoint> >& sps, TVector3& PCAEigenvector, TVector3& TrackPosition){
-
-    double Residual = 0;
-
-    for(auto const& sp: sps){
-
-      //Get the relative position of the spacepoint
-      TVector3 pos= IShowerTool::GetLArPandoraShowerAlg().SpacePointPosition(sp) - TrackPosition;
-
-      //Gen the perpendicular distance
-      double len  = pos.Dot(PCAEigenvector);
-      double perp = (pos - len*PCAEigenvector).Mag();
-
-      Residual += perp;
+    //Keep swapping the last space point for the next one in the pool until the residual is acceptable. If the pool
+    //is empty, then there is nothing to do (sad)
+    while (!reduced_sps_pool.empty()){
+      ReplaceLastSpacePoint(cache, segment, reduced_sps_pool.front());
+      reduced_sps_pool.pop_front();
 
+      double residual = FitSegmentAndCalculateResidual(cache, segment);
+      if (IsResidualOK(residual, current_residual, segment.segment.size())) return true;
     }
-    return Residual;
+    return false;
   }
 
-
-  double ShowerIncrementalTrackHitFinder::CalculateResidual(std::vector<art::Ptr<recob::SpacePoint> >& sps, TVector3& PCAEigenvector, TVector3& TrackPosition, int& max_residual_point){
+  //Sum the perpendicular distance of the space points from the line. Also return the position in the segment of the
+  //space point with the largest distance.
+  double ShowerIncrementalTrackHitFinder::CalculateResidual(const SpacePointCache& cache,
+      std::vector<size_t> const& sps,
+      const TVector3& PCAEigenvector,
+      const TVector3& TrackPosition,
+      size_t& max_residual_point){
 
     double Residual = 0;
     double max_residual  = -999;
 
-    for(auto const& sp: sps){
+    for(size_t sp_iter = 0; sp_iter < sps.size(); ++sp_iter){
 
       //Get the relative position of the spacepoint
-      TVector3 pos= IShowerTool::GetLArPandoraShowerAlg().SpacePointPosition(sp) - TrackPosition;
+      TVector3 pos = cache.positions[sps[sp_iter]] - TrackPosition;
 
       //Gen the perpendicular distance
       double len  = pos.Dot(PCAEigenvector);
@@ -682,7 +622,7 @@ namespace ShowerRecoTools {
 
       if(perp > max_residual){
         max_residual = perp;
-        max_residual_point = sp.key();
+        max_residual_point = sp_iter;
       }
 
     }
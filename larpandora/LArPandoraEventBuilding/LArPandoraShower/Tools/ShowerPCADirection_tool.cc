@@ -31,6 +31,8 @@ namespace ShowerRecoTools {
           reco::shower::ShowerElementHolder& ShowerEleHolder
           ) override;
 
+      void InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder) override;
+
     private:
 
       void InitialiseProducers() override;
@@ -66,6 +68,10 @@ namespace ShowerRecoTools {
       std::string fShowerCentreOutputLabel;
       std::string fShowerPCAOutputLabel;
 
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3> fShowerStartPositionInputHandle;
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3> fShowerDirectionOutputHandle;
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3> fShowerCentreOutputHandle;
+      reco::shower::ShowerDataProductHandle<recob::PCAxis>  fShowerPCAOutputHandle;
   };
 
   ShowerPCADirection::ShowerPCADirection(const fhicl::ParameterSet& pset) :
@@ -82,6 +88,13 @@ namespace ShowerRecoTools {
   {
   }
 
+  void ShowerPCADirection::InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder){
+    fShowerStartPositionInputHandle = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerStartPositionInputLabel);
+    fShowerDirectionOutputHandle    = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerDirectionOutputLabel);
+    fShowerCentreOutputHandle       = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerCentreOutputLabel);
+    fShowerPCAOutputHandle          = ShowerEleHolder.RegisterElement<recob::PCAxis>(fShowerPCAOutputLabel);
+  }
+
   void ShowerPCADirection::InitialiseProducers()
   {
     InitialiseProduct<std::vector<recob::PCAxis> >(fShowerPCAOutputLabel);
@@ -122,19 +135,18 @@ namespace ShowerRecoTools {
 
     //Save the shower the center for downstream tools
     TVector3 ShowerCentreErr = {-999,-999,-999};
-    ShowerEleHolder.SetElement(ShowerCentre,ShowerCentreErr,fShowerCentreOutputLabel);
-    ShowerEleHolder.SetElement(PCA, fShowerPCAOutputLabel);
+    ShowerEleHolder.SetElement(fShowerCentreOutputHandle,ShowerCentre,ShowerCentreErr);
+    ShowerEleHolder.SetElement(fShowerPCAOutputHandle,PCA);
 
     //Check if we are pointing the correct direction or not, First try the start position
     if(fUseStartPosition){
-      if(!ShowerEleHolder.CheckElement(fShowerStartPositionInputLabel)){
+      if(!ShowerEleHolder.CheckElement(fShowerStartPositionInputHandle)){
         if (fVerbose)
           mf::LogError("ShowerPCADirection") << "fUseStartPosition is set but ShowerStartPosition is not set. Bailing" << std::endl;
         return 1;
       }
       //Get the General direction as the vector between the start position and the centre
-      TVector3 StartPositionVec = {-999, -999, -999};
-      ShowerEleHolder.GetElement(fShowerStartPositionInputLabel,StartPositionVec);
+      const TVector3& StartPositionVec = ShowerEleHolder.GetElement(fShowerStartPositionInputHandle);
 
       // Calculate the general direction of the shower
       TVector3 GeneralDir = (ShowerCentre - StartPositionVec).Unit();
@@ -151,7 +163,7 @@ namespace ShowerRecoTools {
 
       //To do
       TVector3 PCADirectionErr = {-999,-999,-999};
-      ShowerEleHolder.SetElement(PCADirection,PCADirectionErr,fShowerDirectionOutputLabel);
+      ShowerEleHolder.SetElement(fShowerDirectionOutputHandle,PCADirection,PCADirectionErr);
       return 0;
     }
 
@@ -167,7 +179,7 @@ namespace ShowerRecoTools {
     //To do
     TVector3 PCADirectionErr = {-999,-999,-999};
 
-    ShowerEleHolder.SetElement(PCADirection,PCADirectionErr,fShowerDirectionOutputLabel);
+    ShowerEleHolder.SetElement(fShowerDirectionOutputHandle,PCADirection,PCADirectionErr);
     return 0;
   }
 
@@ -335,7 +347,7 @@ namespace ShowerRecoTools {
       reco::shower::ShowerElementHolder& ShowerEleHolder){
 
     //First check the element has been set
-    if(!ShowerEleHolder.CheckElement(fShowerPCAOutputLabel)){
+    if(!ShowerEleHolder.CheckElement(fShowerPCAOutputHandle)){
       if (fVerbose)
         mf::LogError("ShowerPCADirection: Add Assns") << "PCA not set."<< std::endl;
       return 1;
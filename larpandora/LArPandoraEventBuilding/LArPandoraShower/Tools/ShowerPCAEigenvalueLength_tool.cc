@@ -28,6 +28,8 @@ namespace ShowerRecoTools {
           reco::shower::ShowerElementHolder& ShowerEleHolder
           ) override;
 
+      void InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder) override;
+
     private:
 
       art::InputTag fPFParticleLabel;
@@ -36,6 +38,10 @@ namespace ShowerRecoTools {
       std::string fShowerLengthOutputLabel;
       std::string fShowerOpeningAngleOutputLabel;
       float fNSigma;
+
+      reco::shower::ShowerDataProductHandle<recob::PCAxis> fShowerPCAHandle;
+      reco::shower::ShowerPropertyHandle<double,double>    fShowerLengthHandle;
+      reco::shower::ShowerPropertyHandle<double,double>    fShowerOpeningAngleHandle;
   };
 
 
@@ -50,18 +56,23 @@ namespace ShowerRecoTools {
   {
   }
 
+  void ShowerPCAEigenvalueLength::InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder){
+    fShowerPCAHandle          = ShowerEleHolder.RegisterElement<recob::PCAxis>(fShowerPCAInputLabel);
+    fShowerLengthHandle       = ShowerEleHolder.RegisterProperty<double,double>(fShowerLengthOutputLabel);
+    fShowerOpeningAngleHandle = ShowerEleHolder.RegisterProperty<double,double>(fShowerOpeningAngleOutputLabel);
+  }
+
   int ShowerPCAEigenvalueLength::CalculateElement(const art::Ptr<recob::PFParticle>& pfparticle,
       art::Event& Event, reco::shower::ShowerElementHolder& ShowerEleHolder){
 
 
-    if(!ShowerEleHolder.CheckElement(fShowerPCAInputLabel)){
+    if(!ShowerEleHolder.CheckElement(fShowerPCAHandle)){
       if (fVerbose)
         mf::LogError("ShowerPCAEigenvalueLength") << "PCA not set, returning "<< std::endl;
       return 1;
     }
 
-    recob::PCAxis PCA = recob::PCAxis();
-    ShowerEleHolder.GetElement(fShowerPCAInputLabel,PCA);
+    const recob::PCAxis& PCA = ShowerEleHolder.GetElement(fShowerPCAHandle);
 
     const double* eigenValues = PCA.getEigenValues();
 
@@ -85,8 +96,8 @@ namespace ShowerRecoTools {
     double ShowerAngleError = -999;
 
     // Fill the shower element holder
-    ShowerEleHolder.SetElement(ShowerLength, ShowerLengthError, fShowerLengthOutputLabel);
-    ShowerEleHolder.SetElement(ShowerAngle, ShowerAngleError, fShowerOpeningAngleOutputLabel);
+    ShowerEleHolder.SetElement(fShowerLengthHandle, ShowerLength, ShowerLengthError);
+    ShowerEleHolder.SetElement(fShowerOpeningAngleHandle, ShowerAngle, ShowerAngleError);
 
     return 0;
   }
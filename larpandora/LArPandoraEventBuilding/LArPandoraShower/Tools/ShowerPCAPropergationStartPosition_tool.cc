@@ -27,6 +27,8 @@ namespace ShowerRecoTools {
           reco::shower::ShowerElementHolder& ShowerEleHolder
           ) override;
 
+      void InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder) override;
+
     private:
 
       //fcl parameters
@@ -36,6 +38,11 @@ namespace ShowerRecoTools {
       std::string   fShowerCentreInputLabel;
       std::string   fShowerDirectionInputLabel;
       std::string   fShowerStartPositionInputLabel;
+
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3> fShowerStartPositionOutputHandle;
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3> fShowerCentreInputHandle;
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3> fShowerDirectionInputHandle;
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3> fShowerStartPositionInputHandle;
   };
 
 
@@ -50,23 +57,30 @@ namespace ShowerRecoTools {
   {
   }
 
+  void ShowerPCAPropergationStartPosition::InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder){
+    fShowerStartPositionOutputHandle = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerStartPositionOutputLabel);
+    fShowerCentreInputHandle         = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerCentreInputLabel);
+    fShowerDirectionInputHandle      = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerDirectionInputLabel);
+    fShowerStartPositionInputHandle  = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerStartPositionInputLabel);
+  }
+
   int ShowerPCAPropergationStartPosition::CalculateElement(const art::Ptr<recob::PFParticle>& pfparticle,
       art::Event& Event, reco::shower::ShowerElementHolder& ShowerEleHolder){
 
     TVector3 ShowerCentre = {-999,-999,-999};
 
     //Get the start position and direction and center
-    if(!ShowerEleHolder.CheckElement(fShowerStartPositionInputLabel)){
+    if(!ShowerEleHolder.CheckElement(fShowerStartPositionInputHandle)){
       if (fVerbose)
         mf::LogError("ShowerPCAPropergationStartPosition") << "Start position not set, returning "<< std::endl;
       return 1;
     }
-    if(!ShowerEleHolder.CheckElement(fShowerDirectionInputLabel)){
+    if(!ShowerEleHolder.CheckElement(fShowerDirectionInputHandle)){
       if (fVerbose)
         mf::LogError("ShowerPCAPropergationStartPosition") << "Direction not set, returning "<< std::endl;
       return 1;
     }
-    if(!ShowerEleHolder.CheckElement(fShowerCentreInputLabel)){
+    if(!ShowerEleHolder.CheckElement(fShowerCentreInputHandle)){
 
       auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(Event);
       auto const detProp   = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(Event, clockData);
@@ -95,15 +109,12 @@ namespace ShowerRecoTools {
 
     }
     else{
-      ShowerEleHolder.GetElement(fShowerCentreInputLabel,ShowerCentre);
+      ShowerCentre = ShowerEleHolder.GetElement(fShowerCentreInputHandle);
     }
 
 
-    TVector3 ShowerStartPosition = {-999,-999,-999};
-    ShowerEleHolder.GetElement(fShowerStartPositionInputLabel,ShowerStartPosition);
-
-    TVector3 ShowerDirection     = {-999,-999,-999};
-    ShowerEleHolder.GetElement(fShowerDirectionInputLabel,ShowerDirection);
+    const TVector3& ShowerStartPosition = ShowerEleHolder.GetElement(fShowerStartPositionInputHandle);
+    const TVector3& ShowerDirection     = ShowerEleHolder.GetElement(fShowerDirectionInputHandle);
 
     //Get the projection
     double projection = ShowerDirection.Dot(ShowerStartPosition-ShowerCentre);
@@ -112,7 +123,7 @@ namespace ShowerRecoTools {
     TVector3 ShowerNewStartPosition = projection*ShowerDirection + ShowerCentre;
     TVector3 ShowerNewStartPositionErr = {-999,-999,-999};
 
-    ShowerEleHolder.SetElement(ShowerNewStartPosition,ShowerNewStartPositionErr,fShowerStartPositionOutputLabel);
+    ShowerEleHolder.SetElement(fShowerStartPositionOutputHandle,ShowerNewStartPosition,ShowerNewStartPositionErr);
 
     return 0;
 
@@ -28,6 +28,7 @@ namespace ShowerRecoTools{
           reco::shower::ShowerElementHolder& ShowerEleHolder
           ) override;
 
+      void InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder) override;
 
     private:
 
@@ -36,6 +37,9 @@ namespace ShowerRecoTools{
       int           fVerbose;
       std::string   fShowerStartPositionOutputLabel;
       std::string   fShowerDirectionInputLabel;
+
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3> fShowerStartPositionOutputHandle;
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3> fShowerDirectionInputHandle;
   };
 
 
@@ -48,6 +52,11 @@ namespace ShowerRecoTools{
   {
   }
 
+  void ShowerPFPVertexStartPosition::InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder){
+    fShowerStartPositionOutputHandle = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerStartPositionOutputLabel);
+    fShowerDirectionInputHandle      = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerDirectionInputLabel);
+  }
+
   int ShowerPFPVertexStartPosition::CalculateElement(const art::Ptr<recob::PFParticle>& pfparticle,
       art::Event& Event,
       reco::shower::ShowerElementHolder& ShowerEleHolder){
@@ -84,15 +93,14 @@ namespace ShowerRecoTools{
       StartPositionVertex->XYZ(xyz);
       TVector3 ShowerStartPosition = {xyz[0], xyz[1], xyz[2]};
       TVector3 ShowerStartPositionErr = {-999, -999, -999};
-      ShowerEleHolder.SetElement(ShowerStartPosition,ShowerStartPositionErr,fShowerStartPositionOutputLabel);
+      ShowerEleHolder.SetElement(fShowerStartPositionOutputHandle,ShowerStartPosition,ShowerStartPositionErr);
       return 0;
     }
 
     //If we there have none then use the direction to find the neutrino vertex
-    if(ShowerEleHolder.CheckElement(fShowerDirectionInputLabel)){
+    if(ShowerEleHolder.CheckElement(fShowerDirectionInputHandle)){
 
-      TVector3 ShowerDirection = {-999, -999, -999};
-      ShowerEleHolder.GetElement(fShowerDirectionInputLabel,ShowerDirection);
+      TVector3 ShowerDirection = ShowerEleHolder.GetElement(fShowerDirectionInputHandle);
 
       const art::FindManyP<recob::SpacePoint>& fmspp = ShowerEleHolder.GetFindManyP<recob::SpacePoint>(
           pfpHandle, Event, fPFParticleLabel);
@@ -121,7 +129,7 @@ namespace ShowerRecoTools{
       TVector3 ShowerStartPosition = IShowerTool::GetLArPandoraShowerAlg().SpacePointPosition(spacePoints_pfp[0]);
 
       TVector3 ShowerStartPositionErr = {-999,-999,-999};
-      ShowerEleHolder.SetElement(ShowerStartPosition,ShowerStartPositionErr,fShowerStartPositionOutputLabel);
+      ShowerEleHolder.SetElement(fShowerStartPositionOutputHandle,ShowerStartPosition,ShowerStartPositionErr);
 
       return 0;
     }
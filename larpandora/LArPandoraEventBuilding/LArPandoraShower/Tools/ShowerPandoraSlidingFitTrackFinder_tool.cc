@@ -26,6 +26,8 @@ namespace ShowerRecoTools{
       //Generic Track Finder
       int CalculateElement(const art::Ptr<recob::PFParticle>& pfparticle,
           art::Event& Event, reco::shower::ShowerElementHolder& ShowerEleHolder) override;
+
+      void InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder) override;
     private:
 
       void InitialiseProducers() override;
@@ -48,6 +50,13 @@ namespace ShowerRecoTools{
       std::string fShowerDirectionInputLabel;
       std::string fInitialTrackSpacePointsInputLabel;
       std::string fInitialTrackHitsInputLabel;
+
+      reco::shower::ShowerDataProductHandle<recob::Track>                               fInitialTrackOutputHandle;
+      reco::shower::ShowerDataProductHandle<float>                                      fInitialTrackLengthOutputHandle;
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3>                             fShowerStartPositionInputHandle;
+      reco::shower::ShowerPropertyHandle<TVector3,TVector3>                             fShowerDirectionInputHandle;
+      reco::shower::ShowerDataProductHandle<std::vector<art::Ptr<recob::SpacePoint> > > fInitialTrackSpacePointsInputHandle;
+      reco::shower::ShowerDataProductHandle<std::vector<art::Ptr<recob::Hit> > >        fInitialTrackHitsInputHandle;
   };
 
 
@@ -65,6 +74,15 @@ namespace ShowerRecoTools{
   {
   }
 
+  void ShowerPandoraSlidingFitTrackFinder::InitialiseElements(reco::shower::ShowerElementHolder& ShowerEleHolder){
+    fInitialTrackOutputHandle           = ShowerEleHolder.RegisterElement<recob::Track>(fInitialTrackOutputLabel);
+    fInitialTrackLengthOutputHandle     = ShowerEleHolder.RegisterElement<float>(fInitialTrackLengthOutputLabel);
+    fShowerStartPositionInputHandle     = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerStartPositionInputLabel);
+    fShowerDirectionInputHandle         = ShowerEleHolder.RegisterProperty<TVector3,TVector3>(fShowerDirectionInputLabel);
+    fInitialTrackSpacePointsInputHandle = ShowerEleHolder.RegisterElement<std::vector<art::Ptr<recob::SpacePoint> > >(fInitialTrackSpacePointsInputLabel);
+    fInitialTrackHitsInputHandle        = ShowerEleHolder.RegisterElement<std::vector<art::Ptr<recob::Hit> > >(fInitialTrackHitsInputLabel);
+  }
+
   void ShowerPandoraSlidingFitTrackFinder::InitialiseProducers(){
 
     InitialiseProduct<std::vector<recob::Track> >(fInitialTrackOutputLabel);
@@ -80,30 +98,25 @@ namespace ShowerRecoTools{
       reco::shower::ShowerElementHolder& ShowerEleHolder
       ){
     //This is all based on the shower vertex being known. If it is not lets not do the track
-    if(!ShowerEleHolder.CheckElement(fShowerStartPositionInputLabel)){
+    if(!ShowerEleHolder.CheckElement(fShowerStartPositionInputHandle)){
       if (fVerbose)
         mf::LogError("ShowerPandoraSlidingFitTrackFinder") << "Start position not set, returning "<< std::endl;
       return 1;
     }
-    if(!ShowerEleHolder.CheckElement(fShowerDirectionInputLabel)){
+    if(!ShowerEleHolder.CheckElement(fShowerDirectionInputHandle)){
       if (fVerbose)
         mf::LogError("ShowerPandoraSlidingFitTrackFinder") << "Direction not set, returning "<< std::endl;
       return 1;
     }
-    if(!ShowerEleHolder.CheckElement(fInitialTrackSpacePointsInputLabel)){
+    if(!ShowerEleHolder.CheckElement(fInitialTrackSpacePointsInputHandle)){
       if (fVerbose)
         mf::LogError("ShowerPandoraSlidingFitTrackFinder") << "Initial Spacepoints not set, returning "<< std::endl;
       return 1;
     }
 
-    TVector3 ShowerStartPosition = {-999,-999,-999};
-    ShowerEleHolder.GetElement(fShowerStartPositionInputLabel,ShowerStartPosition);
+    const TVector3& ShowerStartPosition = ShowerEleHolder.GetElement(fShowerStartPositionInputHandle);
 
-    TVector3 ShowerDirection     = {-999,-999,-999};
-    ShowerEleHolder.GetElement(fShowerDirectionInputLabel,ShowerDirection);
-
-    std::vector<art::Ptr<recob::SpacePoint> > spacepoints;
-    ShowerEleHolder.GetElement(fInitialTrackSpacePointsInputLabel,spacepoints);
+    const std::vector<art::Ptr<recob::SpacePoint> >& spacepoints = ShowerEleHolder.GetElement(fInitialTrackSpacePointsInputHandle);
 
     const unsigned int nWirePlanes(fGeom->MaxPlanes());
 
@@ -196,13 +209,13 @@ namespace ShowerRecoTools{
         util::kBogusI, util::kBogusF, util::kBogusI, recob::tracking::SMatrixSym55(),
         recob::tracking::SMatrixSym55(), pfparticle.key());
 
-    ShowerEleHolder.SetElement(InitialTrack,fInitialTrackOutputLabel);
+    ShowerEleHolder.SetElement(fInitialTrackOutputHandle,InitialTrack);
 
     TVector3 Start = {InitialTrack.Start().X(), InitialTrack.Start().Y(), InitialTrack.Start().Z()};
     TVector3 End   = {InitialTrack.End().X(), InitialTrack.End().Y(),InitialTrack.End().Z()};
     float tracklength = (Start-End).Mag();
 
-    ShowerEleHolder.SetElement(tracklength,fInitialTrackLengthOutputLabel);
+    ShowerEleHolder.SetElement(fInitialTrackLengthOutputHandle,tracklength);
 
     return 0;
   }
@@ -213,7 +226,7 @@ namespace ShowerRecoTools{
       ){
 
     //Check the track has been set
-    if(!ShowerEleHolder.CheckElement(fInitialTrackOutputLabel)){
+    if(!ShowerEleHolder.CheckElement(fInitialTrackOutputHandle)){
       if (fVerbose)
         mf::LogError("ShowerPandoraSlidingFitTrackFinderAddAssn") << "Track not set so the assocation can not be made  "<< std::endl;
       return 1;
@@ -229,8 +242,12 @@ namespace ShowerRecoTools{
 
     AddSingle<art::Assns<recob::Shower, recob::Track> >(showerptr,trackptr,"ShowerTrackAssn");
 
-    std::vector<art::Ptr<recob::Hit> > TrackHits;
-    ShowerEleHolder.GetElement(fInitialTrackHitsInputLabel,TrackHits);
+    if(!ShowerEleHolder.CheckElement(fInitialTrackHitsInputHandle)){
+      mf::LogWarning("ShowerPandoraSlidingFitTrackFinderAddAssn") << "Initial track hits not set so the hit assocation can not be made  "<< std::endl;
+      return 0;
+    }
+
+    const std::vector<art::Ptr<recob::Hit> >& TrackHits = ShowerEleHolder.GetElement(fInitialTrackHitsInputHandle);
 
     for(auto const& TrackHit: TrackHits){
       AddSingle<art::Assns<recob::Track, recob::Hit> >(trackptr,TrackHit,"ShowerTrackHitAssn");
@@ -11,6 +11,7 @@
 
 //LArSoft Includes
 #include "larpandora/LArPandoraEventBuilding/LArPandoraShower/Tools/IShowerTool.h"
+#include "larpandora/LArPandoraEventBuilding/LArPandoraShower/Algs/ShowerSpatialIndex.hh"
 #include "lardataobj/RecoBase/Track.h"
 
 namespace ShowerRecoTools {
@@ -96,6 +97,13 @@ namespace ShowerRecoTools {
     recob::Track InitialTrack;
     ShowerEleHolder.GetElement(fInitialTrackInputTag,InitialTrack);
 
+    //Index the spacepoints so the closest one to each trajectory point can be found without a scan over all of them.
+    std::vector<TVector3> spacePointPositions;
+    for(auto const& spacepoint: intitaltrack_sp){
+      spacePointPositions.push_back(IShowerTool::GetLArPandoraShowerAlg().SpacePointPosition(spacepoint));
+    }
+    reco::shower::ShowerSpatialIndex spacePointIndex(spacePointPositions);
+
     std::vector<art::Ptr<recob::SpacePoint> > new_intitaltrack_sp;
     //Loop over the trajectory points
     for(unsigned int traj=0; traj< InitialTrack.NumberTrajectoryPoints(); ++traj){
@@ -116,24 +124,15 @@ namespace ShowerRecoTools {
       if((TrajPosition - TrajPositionStart).Mag() == 0){continue;}
       if((TrajPosition - ShowerStartPosition).Mag() == 0){continue;}
 
+      //Find the spacepoint closest to the trajectory point.
       float MinDist = 9999;
-      unsigned int index = 999;
-      for(unsigned int sp=0; sp<intitaltrack_sp.size();++sp){
-        //Find the spacepoint closest to the trajectory point.
-        art::Ptr<recob::SpacePoint> spacepoint = intitaltrack_sp[sp];
-        TVector3 pos = IShowerTool::GetLArPandoraShowerAlg().SpacePointPosition(spacepoint) - TrajPosition;
-        if(pos.Mag() < MinDist && pos.Mag()< fMaxDist){
-          MinDist = pos.Mag();
-          index = sp;
-        }
-      }
-
-      if(index == 999){continue;}
+      size_t index;
+      if(!spacePointIndex.FindNearest(TrajPosition, std::min(MinDist, fMaxDist), index)){continue;}
       //Add the spacepoint to the track spacepoints.
       new_intitaltrack_sp.push_back(intitaltrack_sp[index]);
 
-      //Delete the spacepoint so it can not be used again.
-      intitaltrack_sp.erase(intitaltrack_sp.begin() + index);
+      //Remove the spacepoint so it can not be used again.
+      spacePointIndex.Remove(index);
     }
 
 
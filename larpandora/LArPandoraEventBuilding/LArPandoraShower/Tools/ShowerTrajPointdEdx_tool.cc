@@ -14,6 +14,7 @@
 
 //LArSoft Includes
 #include "larpandora/LArPandoraEventBuilding/LArPandoraShower/Tools/IShowerTool.h"
+#include "larpandora/LArPandoraEventBuilding/LArPandoraShower/Algs/ShowerSpatialIndex.hh"
 #include "larreco/Calorimetry/CalorimetryAlg.h"
 #include "lardataobj/RecoBase/Track.h"
 #include "lardataobj/AnalysisBase/T0.h"
@@ -54,6 +55,8 @@ namespace ShowerRecoTools{
       float fdEdxCut;
       bool fUseMedian;        //Use the median value as the dEdx rather than the mean.
       bool fCutStartPosition; //Remove hits using MinDistCutOff from the vertex as well.
+      bool fUseSpatialIndex;  //Match spacepoints to trajectory points with a KD-tree built once per shower
+      //rather than scanning every trajectory point for every spacepoint.
 
       bool fT0Correct;        // Whether to look for a T0 associated to the PFP
       bool fSCECorrectPitch;  // Whether to correct the "squeezing" of pitch, requires corrected input
@@ -83,6 +86,7 @@ namespace ShowerRecoTools{
     fdEdxCut(pset.get<float>("dEdxCut")),
     fUseMedian(pset.get<bool>("UseMedian")),
     fCutStartPosition(pset.get<bool>("CutStartPosition")),
+    fUseSpatialIndex(pset.get<bool>("UseSpatialIndex", true)),
     fT0Correct(pset.get<bool>("T0Correct")),
     fSCECorrectPitch(pset.get<bool>("SCECorrectPitch")),
     fSCECorrectEField(pset.get<bool>("SCECorrectEField")),
@@ -178,6 +182,25 @@ namespace ShowerRecoTools{
     auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(Event);
     auto const detProp   = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(Event, clockData);
 
+    //Index the valid trajectory points so each spacepoint can find its closest one without a scan over the track.
+    reco::shower::ShowerSpatialIndex trajIndex;
+    std::vector<unsigned int> trajNumbers;
+    if(fUseSpatialIndex){
+      std::vector<TVector3> trajPositions;
+      for(unsigned int traj=0; traj< InitialTrack.NumberTrajectoryPoints(); ++traj){
+
+        //ignore bogus info.
+        auto flags = InitialTrack.FlagsAtPoint(traj);
+        if(flags.isSet(recob::TrajectoryPointFlagTraits::NoPoint))
+        {continue;}
+
+        geo::Point_t TrajPositionPoint = InitialTrack.LocationAtPoint(traj);
+        trajPositions.emplace_back(TrajPositionPoint.X(),TrajPositionPoint.Y(),TrajPositionPoint.Z());
+        trajNumbers.push_back(traj);
+      }
+      trajIndex.Build(trajPositions);
+    }
+
     //Loop over the spacepoints
     for(auto const sp: tracksps){
 
@@ -209,22 +232,30 @@ namespace ShowerRecoTools{
       //Find the closest trajectory point of the track. These should be in order if the user has used ShowerTrackTrajToSpacePoint_tool but the sake of gernicness I'll get the cloest sp.
       unsigned int index = 999;
       double MinDist = 999;
-      for(unsigned int traj=0; traj< InitialTrack.NumberTrajectoryPoints(); ++traj){
+      if(fUseSpatialIndex){
+        size_t nearest;
+        if(trajIndex.FindNearest(pos, std::min(MinDist, MaxDist*wirepitch), nearest)){
+          index = trajNumbers[nearest];
+        }
+      }
+      else{
+        for(unsigned int traj=0; traj< InitialTrack.NumberTrajectoryPoints(); ++traj){
 
-        geo::Point_t TrajPositionPoint = InitialTrack.LocationAtPoint(traj);
-        TVector3 TrajPosition = {TrajPositionPoint.X(),TrajPositionPoint.Y(),TrajPositionPoint.Z()};
+          geo::Point_t TrajPositionPoint = InitialTrack.LocationAtPoint(traj);
+          TVector3 TrajPosition = {TrajPositionPoint.X(),TrajPositionPoint.Y(),TrajPositionPoint.Z()};
 
 
-        //ignore bogus info.
-        auto flags = InitialTrack.FlagsAtPoint(traj);
-        if(flags.isSet(recob::TrajectoryPointFlagTraits::NoPoint))
-        {continue;}
+          //ignore bogus info.
+          auto flags = InitialTrack.FlagsAtPoint(traj);
+          if(flags.isSet(recob::TrajectoryPointFlagTraits::NoPoint))
+          {continue;}
 
-        const TVector3 dist = pos - TrajPosition;
+          const TVector3 dist = pos - TrajPosition;
 
-        if(dist.Mag() < MinDist && dist.Mag()< MaxDist*wirepitch){
-          MinDist = dist.Mag();
-          index = traj;
+          if(dist.Mag() < MinDist && dist.Mag()< MaxDist*wirepitch){
+            MinDist = dist.Mag();
+            index = traj;
+          }
         }
       }
 
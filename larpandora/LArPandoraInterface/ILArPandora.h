@@ -7,7 +7,11 @@
 #ifndef I_LAR_PANDORA_H
 #define I_LAR_PANDORA_H 1
 
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
+#include "canvas/Persistency/Common/Ptr.h"
+#include "cetlib_except/exception.h"
+
+#include <vector>
 
 namespace recob {class Hit;}
 namespace pandora {class Pandora;}
@@ -17,12 +21,72 @@ namespace pandora {class Pandora;}
 namespace lar_pandora
 {
 
-typedef std::map< int, art::Ptr<recob::Hit> > IdToHitMap;
+typedef std::vector<const pandora::Pandora*> PandoraInstanceList;
 
 /**
- *  @brief  ILArPandora class
+ *  @brief  IdToHitMap class, mapping pandora hit ids to art hits. The ids are consecutive hit counters, so the art hits are
+ *          held in a dense vector indexed by id, rather than in a map
  */
-class ILArPandora : public art::EDProducer
+class IdToHitMap
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    IdToHitMap();
+
+    /**
+     *  @brief  Reserve space for a number of hits
+     *
+     *  @param  nHits the number of hits
+     */
+    void Reserve(const size_t nHits);
+
+    /**
+     *  @brief  Add the art hit for a pandora hit id, ids may not be smaller than the first id added
+     *
+     *  @param  id the pandora hit id
+     *  @param  hit the art hit
+     */
+    void Add(const int id, const art::Ptr<recob::Hit> &hit);
+
+    /**
+     *  @brief  Whether there is an art hit for a pandora hit id
+     *
+     *  @param  id the pandora hit id
+     */
+    bool Contains(const int id) const;
+
+    /**
+     *  @brief  Get the art hit for a pandora hit id, which must be present
+     *
+     *  @param  id the pandora hit id
+     */
+    const art::Ptr<recob::Hit> &GetHit(const int id) const;
+
+    /**
+     *  @brief  Get the smallest pandora hit id that may be present
+     */
+    int GetFirstId() const;
+
+    /**
+     *  @brief  Get one past the largest pandora hit id that may be present
+     */
+    int GetEndId() const;
+
+private:
+    typedef std::vector< art::Ptr<recob::Hit> > ArtHitVector;
+
+    int             m_firstId;      ///< The pandora hit id of the first element of the hit vector
+    ArtHitVector    m_hitVector;    ///< The art hits, indexed by pandora hit id minus the first id, null if absent
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  ILArPandora class. Events are processed concurrently, each on a primary pandora instance taken from a pool
+ */
+class ILArPandora : public art::SharedProducer
 {
 public:
     /**
@@ -39,53 +103,74 @@ public:
 
 protected:
     /**
-     *  @brief  Create pandora instances
+     *  @brief  Create the pool of primary pandora instances, one for each event that may be processed concurrently
      */
     virtual void CreatePandoraInstances() = 0;
 
     /**
-     *  @brief  Configure pandora instances
+     *  @brief  Configure all primary pandora instances in the pool
      */
     virtual void ConfigurePandoraInstances() = 0;
 
     /**
-     *  @brief  Delete pandora instances
+     *  @brief  Delete all primary pandora instances in the pool
      */
     virtual void DeletePandoraInstances() = 0;
 
+    /**
+     *  @brief  Take a free primary pandora instance from the pool
+     *
+     *  @return the address of the primary pandora instance, for exclusive use until it is released
+     */
+    virtual const pandora::Pandora *AcquirePandoraInstance() = 0;
+
+    /**
+     *  @brief  Return a primary pandora instance to the pool
+     *
+     *  @param  pPrimaryPandora the address of the primary pandora instance
+     */
+    virtual void ReleasePandoraInstance(const pandora::Pandora *const pPrimaryPandora) = 0;
+
     /**
      *  @brief  Create pandora input hits, mc particles etc.
      *
      *  @param  evt the art event
+     *  @param  pPrimaryPandora the address of the primary pandora instance to receive the input
      *  @param  idToHitMap to receive the populated pandora hit id to art hit map
      */
-    virtual void CreatePandoraInput(art::Event &evt, IdToHitMap &idToHitMap) = 0;
+    virtual void CreatePandoraInput(art::Event &evt, const pandora::Pandora *const pPrimaryPandora, IdToHitMap &idToHitMap) = 0;
 
     /**
      *  @brief  Process pandora output particle flow objects
      *
      *  @param  evt the art event
+     *  @param  pPrimaryPandora the address of the primary pandora instance holding the output
      *  @param  idToHitMap the pandora hit id to art hit map
      */
-    virtual void ProcessPandoraOutput(art::Event &evt, const IdToHitMap &idToHitMap) = 0;
+    virtual void ProcessPandoraOutput(art::Event &evt, const pandora::Pandora *const pPrimaryPandora, const IdToHitMap &idToHitMap) = 0;
 
     /**
-     *  @brief  Run all associated pandora instances
+     *  @brief  Run a primary pandora instance and its associated daughter instances
+     *
+     *  @param  pPrimaryPandora the address of the primary pandora instance
      */
-    virtual void RunPandoraInstances() = 0;
+    virtual void RunPandoraInstances(const pandora::Pandora *const pPrimaryPandora) = 0;
 
     /**
-     *  @brief  Reset all associated pandora instances
+     *  @brief  Reset a primary pandora instance and its associated daughter instances
+     *
+     *  @param  pPrimaryPandora the address of the primary pandora instance
      */
-    virtual void ResetPandoraInstances() = 0;
+    virtual void ResetPandoraInstances(const pandora::Pandora *const pPrimaryPandora) = 0;
 
-    const pandora::Pandora     *m_pPrimaryPandora;          ///< The address of the primary pandora instance
+    const pandora::Pandora     *m_pPrimaryPandora;          ///< The address of the first primary pandora instance in the pool
+    PandoraInstanceList         m_primaryPandoraList;       ///< The addresses of all primary pandora instances in the pool
 };
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline ILArPandora::ILArPandora(fhicl::ParameterSet const &pset) :
-    EDProducer(pset),
+    SharedProducer(pset),
     m_pPrimaryPandora(nullptr)
 {
 }
@@ -96,6 +181,70 @@ inline ILArPandora::~ILArPandora()
 {
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline IdToHitMap::IdToHitMap() :
+    m_firstId(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void IdToHitMap::Reserve(const size_t nHits)
+{
+    m_hitVector.reserve(nHits);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void IdToHitMap::Add(const int id, const art::Ptr<recob::Hit> &hit)
+{
+    if (m_hitVector.empty())
+        m_firstId = id;
+
+    if (id < m_firstId)
+        throw cet::exception("LArPandora") << " IdToHitMap::Add - pandora hit id " << id << " is smaller than the first id " << m_firstId;
+
+    const size_t index(id - m_firstId);
+
+    if (index >= m_hitVector.size())
+        m_hitVector.resize(index + 1);
+
+    m_hitVector[index] = hit;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool IdToHitMap::Contains(const int id) const
+{
+    return ((id >= m_firstId) && (id < this->GetEndId()) && !m_hitVector[id - m_firstId].isNull());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const art::Ptr<recob::Hit> &IdToHitMap::GetHit(const int id) const
+{
+    if (!this->Contains(id))
+        throw cet::exception("LArPandora") << " IdToHitMap::GetHit - no art hit for pandora hit id " << id;
+
+    return m_hitVector[id - m_firstId];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline int IdToHitMap::GetFirstId() const
+{
+    return m_firstId;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline int IdToHitMap::GetEndId() const
+{
+    return m_firstId + static_cast<int>(m_hitVector.size());
+}
+
 } // namespace lar_pandora
 
 #endif // #ifndef I_LAR_PANDORA_H
@@ -6,6 +6,7 @@
  */
 
 #include "art/Framework/Principal/Event.h"
+#include "art/Utilities/SharedResource.h"
 #include "art_root_io/TFileService.h"
 #include "cetlib/cpu_timer.h"
 
@@ -34,6 +35,7 @@
 #include "larpandora/LArPandoraInterface/LArPandora.h"
 #include "larpandora/LArPandoraInterface/LArPandoraHelper.h"
 #include "larpandora/LArPandoraInterface/LArPandoraInput.h"
+#include "larpandora/LArPandoraInterface/LArPandoraMCInput.h"
 #include "larpandora/LArPandoraInterface/LArPandoraOutput.h"
 
 #include <iostream>
@@ -63,8 +65,16 @@ namespace lar_pandora {
     , m_enableDetectorGaps(pset.get<bool>("EnableLineGaps", true))
     , m_enableMCParticles(pset.get<bool>("EnableMCParticles", false))
     , m_disableRealDataCheck(pset.get<bool>("DisableRealDataCheck", false))
-    , m_lineGapsCreated(false)
+    , m_enableInstrumentation(pset.get<bool>("EnableInstrumentation", false))
+    , m_geometryCacheDirectory(pset.get<std::string>("GeometryCacheDirectory", ""))
   {
+    // ATTN Events run concurrently on the pool of primary pandora instances, unless instrumented: the instrumentation writes
+    // through the TFileService, and measures each event on its own
+    if (m_enableInstrumentation)
+      serialize<art::InEvent>(art::SharedResource<art::TFileService>);
+    else
+      async<art::InEvent>();
+
     m_inputSettings.m_useHitWidths = pset.get<bool>("UseHitWidths", true);
     m_inputSettings.m_useBirksCorrection = pset.get<bool>("UseBirksCorrection", false);
     m_inputSettings.m_uidOffset = pset.get<int>("UidOffset", 100000000);
@@ -76,8 +86,17 @@ namespace lar_pandora {
     m_inputSettings.m_mips_if_negative = pset.get<double>("MipsIfNegative", 0.);
     m_inputSettings.m_mips_to_gev = pset.get<double>("MipsToGeV", 3.5e-4);
     m_inputSettings.m_recombination_factor = pset.get<double>("RecombinationFactor", 0.63);
+    m_inputSettings.m_readoutGapCacheDirectory =
+      pset.get<std::string>("ReadoutGapCacheDirectory", "");
+    m_mcInputSettings.m_geantModuleLabel = m_geantModuleLabel;
+    m_mcInputSettings.m_generatorModuleLabel = m_generatorModuleLabel;
+    m_mcInputSettings.m_simChannelModuleLabel = m_simChannelModuleLabel;
+    m_mcInputSettings.m_hitfinderModuleLabel = m_hitfinderModuleLabel;
+    m_mcInputSettings.m_backtrackerModuleLabel = m_backtrackerModuleLabel;
     m_outputSettings.m_shouldRunStitching = m_shouldRunStitching;
     m_outputSettings.m_shouldProduceSlices = pset.get<bool>("ShouldProduceSlices", true);
+    m_outputSettings.m_shouldProduceAllOutcomes = m_shouldProduceAllOutcomes;
+    m_outputSettings.m_allOutcomesInstanceLabel = m_allOutcomesInstanceLabel;
     m_outputSettings.m_shouldProduceTestBeamInteractionVertices =
       pset.get<bool>("ShouldProduceTestBeamInteractionVertices", false);
     m_outputSettings.m_testBeamInteractionVerticesInstanceLabel = pset.get<std::string>(
@@ -130,28 +149,42 @@ namespace lar_pandora {
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandora::beginJob()
+  LArPandora::beginJob(art::ProcessingFrame const&)
   {
-    LArDriftVolumeList driftVolumeList;
-    LArPandoraGeometry::LoadGeometry(driftVolumeList, m_driftVolumeMap);
+    // The geometry model is shared with every other larpandora module in the process
+    m_pGeometryModel = LArPandoraGeometry::GetGeometryModel(m_geometryCacheDirectory);
+    LArPandoraGeometry::LoadWireGeometry(m_pGeometryModel->GetDriftVolumeMap(), m_wireGeometryTable);
+
+    if (m_enableMCParticles) LArPandoraGeometry::LoadTPCBoxIndex(m_tpcBoxIndex);
 
     this->CreatePandoraInstances();
 
-    if (!m_pPrimaryPandora)
+    if (!m_pPrimaryPandora || m_primaryPandoraList.empty())
       throw cet::exception("LArPandora")
         << " LArPandora::beginJob - failed to create primary Pandora instance " << std::endl;
 
     m_inputSettings.m_pPrimaryPandora = m_pPrimaryPandora;
     m_outputSettings.m_pPrimaryPandora = m_pPrimaryPandora;
 
-    // Pass basic LArTPC information to pandora instances
-    LArPandoraInput::CreatePandoraLArTPCs(m_inputSettings, driftVolumeList);
+    const LArDriftVolumeList& driftVolumeList(m_pGeometryModel->GetDaughterVolumeList());
+    const LArDetectorGapList& listOfGaps(m_pGeometryModel->GetDetectorGapList());
+
+    if (m_enableInstrumentation) m_pInstrumentation = std::make_unique<LArPandoraInstrumentation>();
+    m_outputSettings.m_pStageMeasurements = this->GetStageMeasurements();
+
+    // The geometry is loaded once and shared, but every primary pandora instance in the pool needs its own copy of the inputs
+    for (const pandora::Pandora* const pPrimaryPandora : m_primaryPandoraList) {
+      LArPandoraInput::Settings inputSettings(m_inputSettings);
+      inputSettings.m_pPrimaryPandora = pPrimaryPandora;
 
-    // If using global drift volume approach, pass details of gaps between daughter volumes to the pandora instance
-    if (m_enableDetectorGaps) {
-      LArDetectorGapList listOfGaps;
-      LArPandoraGeometry::LoadDetectorGaps(listOfGaps);
-      LArPandoraInput::CreatePandoraDetectorGaps(m_inputSettings, driftVolumeList, listOfGaps);
+      // Pass basic LArTPC information to pandora instances
+      LArPandoraInput::CreatePandoraLArTPCs(inputSettings, driftVolumeList);
+
+      // If using global drift volume approach, pass details of gaps between daughter volumes to the pandora instance
+      if (m_enableDetectorGaps)
+        LArPandoraInput::CreatePandoraDetectorGaps(inputSettings, driftVolumeList, listOfGaps);
+
+      m_lineGapsCreatedMap[pPrimaryPandora] = false;
     }
 
     // Parse Pandora settings xml files
@@ -161,96 +194,121 @@ namespace lar_pandora {
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandora::produce(art::Event& evt)
+  LArPandora::produce(art::Event& evt, art::ProcessingFrame const&)
   {
-    IdToHitMap idToHitMap;
-    this->CreatePandoraInput(evt, idToHitMap);
-    this->RunPandoraInstances();
-    this->ProcessPandoraOutput(evt, idToHitMap);
-    this->ResetPandoraInstances();
+    // ATTN The primary pandora instance is held exclusively until it has been reset
+    const pandora::Pandora* const pPrimaryPandora(this->AcquirePandoraInstance());
+
+    try {
+      LArPandoraInstrumentation::StageMeasurements* const pStageMeasurements(
+        this->GetStageMeasurements());
+      if (pStageMeasurements) pStageMeasurements->clear();
+
+      LArPandoraInstrumentation::StageTimer stageTimer(pStageMeasurements);
+
+      IdToHitMap idToHitMap;
+      this->CreatePandoraInput(evt, pPrimaryPandora, idToHitMap);
+      stageTimer.Mark("CreatePandoraInput");
+      this->RunPandoraInstances(pPrimaryPandora);
+      stageTimer.Mark("RunPandoraInstances");
+      this->ProcessPandoraOutput(evt, pPrimaryPandora, idToHitMap);
+      stageTimer.Mark("ProcessPandoraOutput");
+      this->ResetPandoraInstances(pPrimaryPandora);
+      stageTimer.Mark("ResetPandoraInstances");
+
+      if (pStageMeasurements) m_pInstrumentation->FillEvent(evt, *pStageMeasurements);
+    }
+    catch (...) {
+      this->ReleasePandoraInstance(pPrimaryPandora);
+      throw;
+    }
+
+    this->ReleasePandoraInstance(pPrimaryPandora);
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandora::CreatePandoraInput(art::Event& evt, IdToHitMap& idToHitMap)
+  LArPandora::endJob(art::ProcessingFrame const&)
   {
-    // ATTN Should complete gap creation in begin job callback, but channel status service functionality unavailable at that point
-    if (!m_lineGapsCreated && m_enableDetectorGaps) {
-      LArPandoraInput::CreatePandoraReadoutGaps(m_inputSettings, m_driftVolumeMap);
-      m_lineGapsCreated = true;
-    }
+    if (m_pInstrumentation) m_pInstrumentation->Summarise();
+  }
 
-    HitVector artHits;
-    SimChannelVector artSimChannels;
-    HitsToTrackIDEs artHitsToTrackIDEs;
-    MCParticleVector artMCParticleVector;
-    RawMCParticleVector generatorArtMCParticleVector;
-    MCTruthToMCParticles artMCTruthToMCParticles;
-    MCParticlesToMCTruth artMCParticlesToMCTruth;
+  //------------------------------------------------------------------------------------------------------------------------------------------
 
-    bool areSimChannelsValid(false);
+  void
+  LArPandora::CreatePandoraInput(art::Event& evt,
+                                 const pandora::Pandora* const pPrimaryPandora,
+                                 IdToHitMap& idToHitMap)
+  {
+    LArPandoraInput::Settings inputSettings(m_inputSettings);
+    inputSettings.m_pPrimaryPandora = pPrimaryPandora;
 
-    LArPandoraHelper::CollectHits(evt, m_hitfinderModuleLabel, artHits);
+    LArPandoraInstrumentation::StageTimer stageTimer(this->GetStageMeasurements());
 
-    if (m_enableMCParticles && (m_disableRealDataCheck || !evt.isRealData())) {
-      LArPandoraHelper::CollectMCParticles(evt, m_geantModuleLabel, artMCParticleVector);
+    // ATTN Should complete gap creation in begin job callback, but channel status service functionality unavailable at that point
+    bool& lineGapsCreated(m_lineGapsCreatedMap.at(pPrimaryPandora));
+
+    if (!lineGapsCreated && m_enableDetectorGaps) {
+      // The readout gaps are found once, the only use of the channel status service, and then shared by the whole pool
+      std::call_once(m_readoutGapsLoadedFlag, [this, &inputSettings]() {
+        LArPandoraInput::LoadReadoutGaps(
+          inputSettings, m_pGeometryModel->GetDriftVolumeMap(), m_readoutGapList);
+      });
+
+      LArPandoraInput::CreatePandoraReadoutGaps(inputSettings, m_readoutGapList);
+      lineGapsCreated = true;
+      stageTimer.Mark("CreatePandoraReadoutGaps");
+    }
 
-      if (!m_generatorModuleLabel.empty())
-        LArPandoraHelper::CollectGeneratorMCParticles(
-          evt, m_generatorModuleLabel, generatorArtMCParticleVector);
+    HitVector artHits;
+    LArPandoraHelper::CollectHits(evt, m_hitfinderModuleLabel, artHits);
+    stageTimer.Mark("CollectHits");
 
-      LArPandoraHelper::CollectMCParticles(
-        evt, m_geantModuleLabel, artMCTruthToMCParticles, artMCParticlesToMCTruth);
+    // The MC products are read once, and every view of them needed below is built from that read
+    const bool shouldUseMCParticles(m_enableMCParticles &&
+                                    (m_disableRealDataCheck || !evt.isRealData()));
+    std::unique_ptr<LArPandoraMCInput> pMCInput;
 
-      LArPandoraHelper::CollectSimChannels(
-        evt, m_simChannelModuleLabel, artSimChannels, areSimChannelsValid);
-      if (!artSimChannels.empty()) {
-        LArPandoraHelper::BuildMCParticleHitMaps(evt, artHits, artSimChannels, artHitsToTrackIDEs);
-      }
-      else if (!areSimChannelsValid) {
-        if (m_backtrackerModuleLabel.empty())
-          throw cet::exception("LArPandora")
-            << "LArPandora::CreatePandoraInput - Can't build MCParticle to Hit map." << std::endl
-            << "No SimChannels found with label \"" << m_simChannelModuleLabel
-            << "\", and BackTrackerModuleLabel isn't set in FHiCL." << std::endl;
-
-        LArPandoraHelper::BuildMCParticleHitMaps(
-          evt, m_hitfinderModuleLabel, m_backtrackerModuleLabel, artHitsToTrackIDEs);
-      }
-      else {
-        mf::LogDebug("LArPandora")
-          << " *** LArPandora::CreatePandoraInput - empty list of sim channels found " << std::endl;
-      }
-    }
+    if (shouldUseMCParticles)
+      pMCInput = std::make_unique<LArPandoraMCInput>(evt, m_mcInputSettings, artHits, stageTimer);
 
     LArPandoraInput::CreatePandoraHits2D(
-      evt, m_inputSettings, m_driftVolumeMap, artHits, idToHitMap);
-
-    if (m_enableMCParticles && (m_disableRealDataCheck || !evt.isRealData())) {
-      LArPandoraInput::CreatePandoraMCParticles(m_inputSettings,
-                                                artMCTruthToMCParticles,
-                                                artMCParticlesToMCTruth,
-                                                generatorArtMCParticleVector);
-      LArPandoraInput::CreatePandoraMCLinks2D(m_inputSettings, idToHitMap, artHitsToTrackIDEs);
+      evt, inputSettings, m_wireGeometryTable, artHits, idToHitMap);
+    stageTimer.Mark("CreatePandoraHits2D");
+
+    if (shouldUseMCParticles) {
+      LArPandoraInput::CreatePandoraMCParticles(inputSettings,
+                                                m_tpcBoxIndex,
+                                                pMCInput->GetMCTruthToMCParticles(),
+                                                pMCInput->GetGeneratorMCParticles());
+      stageTimer.Mark("CreatePandoraMCParticles");
+      LArPandoraInput::CreatePandoraMCLinks2D(
+        inputSettings, idToHitMap, pMCInput->GetHitsToTrackIDEs());
+      stageTimer.Mark("CreatePandoraMCLinks2D");
     }
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandora::ProcessPandoraOutput(art::Event& evt, const IdToHitMap& idToHitMap)
+  LArPandora::ProcessPandoraOutput(art::Event& evt,
+                                   const pandora::Pandora* const pPrimaryPandora,
+                                   const IdToHitMap& idToHitMap)
   {
     if (m_enableProduction) {
-      m_outputSettings.m_shouldProduceAllOutcomes = false;
-      LArPandoraOutput::ProduceArtOutput(m_outputSettings, idToHitMap, evt);
-
-      if (m_shouldProduceAllOutcomes) {
-        m_outputSettings.m_shouldProduceAllOutcomes = true;
-        m_outputSettings.m_allOutcomesInstanceLabel = m_allOutcomesInstanceLabel;
-        LArPandoraOutput::ProduceArtOutput(m_outputSettings, idToHitMap, evt);
-      }
+      LArPandoraOutput::Settings outputSettings(m_outputSettings);
+      outputSettings.m_pPrimaryPandora = pPrimaryPandora;
+      LArPandoraOutput::ProduceArtOutput(outputSettings, idToHitMap, evt);
     }
   }
 
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArPandoraInstrumentation::StageMeasurements*
+  LArPandora::GetStageMeasurements()
+  {
+    return m_pInstrumentation ? &m_stageMeasurements : nullptr;
+  }
+
 } // namespace lar_pandora
@@ -11,9 +11,13 @@
 #include "larpandora/LArPandoraInterface/ILArPandora.h"
 #include "larpandora/LArPandoraInterface/LArPandoraGeometry.h"
 #include "larpandora/LArPandoraInterface/LArPandoraInput.h"
+#include "larpandora/LArPandoraInterface/LArPandoraInstrumentation.h"
+#include "larpandora/LArPandoraInterface/LArPandoraMCInput.h"
 #include "larpandora/LArPandoraInterface/LArPandoraOutput.h"
 
+#include <map>
 #include <memory> // std::unique_ptr<>
+#include <mutex>  // std::call_once, std::once_flag
 #include <string>
 
 namespace lar_pandora {
@@ -30,12 +34,24 @@ namespace lar_pandora {
      */
     LArPandora(fhicl::ParameterSet const& pset);
 
-    void beginJob();
-    void produce(art::Event& evt);
+    void beginJob(art::ProcessingFrame const& frame) override;
+    void produce(art::Event& evt, art::ProcessingFrame const& frame) override;
+    void endJob(art::ProcessingFrame const& frame) override;
 
   protected:
-    void CreatePandoraInput(art::Event& evt, IdToHitMap& idToHitMap);
-    void ProcessPandoraOutput(art::Event& evt, const IdToHitMap& idToHitMap);
+    void CreatePandoraInput(art::Event& evt,
+                            const pandora::Pandora* const pPrimaryPandora,
+                            IdToHitMap& idToHitMap);
+    void ProcessPandoraOutput(art::Event& evt,
+                              const pandora::Pandora* const pPrimaryPandora,
+                              const IdToHitMap& idToHitMap);
+
+    /**
+     *  @brief  Get the stage measurements of the event being processed
+     *
+     *  @return the address of the stage measurements, nullptr if instrumentation is disabled
+     */
+    LArPandoraInstrumentation::StageMeasurements* GetStageMeasurements();
 
     std::string m_configFile; ///< The config file
 
@@ -69,12 +85,28 @@ namespace lar_pandora {
       m_enableMCParticles; ///< Whether to pass mc information to Pandora instances to aid development
     bool
       m_disableRealDataCheck; ///< Whether to check if the input file contains real data before accessing MC information
-    bool m_lineGapsCreated; ///< Book-keeping: whether line gap creation has been called
-
-    LArPandoraInput::Settings m_inputSettings;   ///< The lar pandora input settings
-    LArPandoraOutput::Settings m_outputSettings; ///< The lar pandora output settings
-
-    LArDriftVolumeMap m_driftVolumeMap; ///< The map from volume id to drift volume
+    bool
+      m_enableInstrumentation; ///< Whether to record the time and memory used by each stage of each event
+    std::string
+      m_geometryCacheDirectory; ///< The directory in which to cache the geometry model, empty to disable the cache
+    std::map<const pandora::Pandora*, bool>
+      m_lineGapsCreatedMap; ///< Book-keeping: whether line gap creation has been called, per primary pandora instance
+    LArPandoraInstrumentation::StageMeasurements
+      m_stageMeasurements; ///< Book-keeping: the stage measurements of the current event, events being serialised if enabled
+    std::unique_ptr<LArPandoraInstrumentation>
+      m_pInstrumentation; ///< The instrumentation, collecting the stage measurements over the job, if enabled
+
+    LArPandoraInput::Settings
+      m_inputSettings; ///< The lar pandora input settings, copied per event for the primary pandora instance in use
+    LArPandoraMCInput::Settings m_mcInputSettings; ///< The lar pandora MC input settings
+    LArPandoraOutput::Settings
+      m_outputSettings; ///< The lar pandora output settings, copied per event for the primary pandora instance in use
+
+    LArGeometryModelPtr m_pGeometryModel;     ///< The geometry model, shared between modules
+    LArWireGeometryTable m_wireGeometryTable; ///< The cached per-wire geometry used for hit creation
+    LArTPCBoxIndex m_tpcBoxIndex;             ///< The tpc bounding boxes used for MC particle creation
+    LArReadoutGapList m_readoutGapList;       ///< The readout gaps covering the bad channels
+    std::once_flag m_readoutGapsLoadedFlag;   ///< Book-keeping: whether the readout gaps have been loaded
   };
 
 } // namespace lar_pandora
@@ -0,0 +1,158 @@
+/**
+ *  @file   larpandora/LArPandoraInterface/LArPandoraBacktracker.cxx
+ *
+ *  @brief  Flat, channel indexed backtracking of reconstructed hits to the true energy deposits in the SimChannels
+ */
+
+#include "cetlib_except/exception.h"
+
+#include "lardata/DetectorInfo/DetectorClocksData.h"
+#include "lardataobj/RecoBase/Hit.h"
+
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h"
+
+#include "larpandora/LArPandoraInterface/LArPandoraBacktracker.h"
+
+#include <algorithm>
+
+namespace lar_pandora {
+
+  LArPandoraBacktracker::LArPandoraBacktracker(const SimChannelVector& simChannelVector)
+  {
+    for (const art::Ptr<sim::SimChannel>& simChannel : simChannelVector)
+      this->AddSimChannel(*simChannel);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArPandoraBacktracker::LArPandoraBacktracker(const std::vector<sim::SimChannel>& simChannels)
+  {
+    for (const sim::SimChannel& simChannel : simChannels)
+      this->AddSimChannel(simChannel);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraBacktracker::Backtrack(const detinfo::DetectorClocksData& clockData,
+                                   const HitVector& hitVector)
+  {
+    m_hitOffsets.clear();
+    m_trackIDEs.clear();
+    m_hitOffsets.reserve(hitVector.size() + 1);
+
+    for (const art::Ptr<recob::Hit>& hit : hitVector) {
+      m_hitOffsets.push_back(m_trackIDEs.size());
+
+      const size_t channel(hit->Channel());
+      if (channel >= m_channelTable.size() || !m_channelTable[channel])
+        continue; // Hit has no truth information [continue]
+
+      // ATTN: Need to convert TDCtick (integer) to TDC (unsigned integer) before passing to simChannel
+      const raw::TDCtick_t start_tick(clockData.TPCTick2TDC(hit->PeakTimeMinusRMS()));
+      const raw::TDCtick_t end_tick(clockData.TPCTick2TDC(hit->PeakTimePlusRMS()));
+      const unsigned int start_tdc((start_tick < 0) ? 0 : start_tick);
+      const unsigned int end_tdc(end_tick);
+
+      if (start_tdc > end_tdc) continue; // Hit undershoots the readout window [continue]
+
+      this->AddTrackIDEs(*m_channelTable[channel], start_tdc, end_tdc);
+    }
+
+    m_hitOffsets.push_back(m_trackIDEs.size());
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraBacktracker::FillHitsToTrackIDEs(const HitVector& hitVector,
+                                             HitsToTrackIDEs& hitsToTrackIDEs) const
+  {
+    if (hitVector.size() != this->GetNHits())
+      throw cet::exception("LArPandora") << " LArPandoraBacktracker::FillHitsToTrackIDEs --- "
+                                            "the hits do not match the backtracked hits ";
+
+    for (size_t hitIndex = 0, hitIndexEnd = hitVector.size(); hitIndex < hitIndexEnd; ++hitIndex) {
+      const sim::TrackIDE *pBegin(nullptr), *pEnd(nullptr);
+      this->GetTrackIDEs(hitIndex, pBegin, pEnd);
+
+      if (pBegin == pEnd) continue; // Hit has no truth information [continue]
+
+      TrackIDEVector& trackCollection(hitsToTrackIDEs[hitVector[hitIndex]]);
+      trackCollection.insert(trackCollection.end(), pBegin, pEnd);
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraBacktracker::AddSimChannel(const sim::SimChannel& simChannel)
+  {
+    const size_t channel(simChannel.Channel());
+
+    if (channel >= m_channelTable.size()) m_channelTable.resize(channel + 1, nullptr);
+
+    // ATTN The first SimChannel found for a channel is used, as for a SimChannelMap
+    if (!m_channelTable[channel]) m_channelTable[channel] = &(simChannel.TDCIDEMap());
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraBacktracker::AddTrackIDEs(const TDCIDEVector& tdcIDEVector,
+                                      const unsigned int startTDC,
+                                      const unsigned int endTDC)
+  {
+    const TDCIDEVector::const_iterator iterFirst(std::lower_bound(
+      tdcIDEVector.begin(),
+      tdcIDEVector.end(),
+      startTDC,
+      [](const sim::TDCIDE& tdcIDE, const unsigned int tdc) { return tdcIDE.first < tdc; }));
+    const TDCIDEVector::const_iterator iterLast(std::upper_bound(
+      iterFirst,
+      tdcIDEVector.end(),
+      endTDC,
+      [](const unsigned int tdc, const sim::TDCIDE& tdcIDE) { return tdc < tdcIDE.first; }));
+
+    // Sum the energy deposits by track id, in the same order as sim::SimChannel::TrackIDEs, so the sums are identical
+    m_scratchIDEs.clear();
+    double totalE(0.);
+
+    for (TDCIDEVector::const_iterator iter = iterFirst; iter != iterLast; ++iter) {
+      for (const sim::IDE& ide : iter->second) {
+        std::vector<sim::TrackIDE>::iterator iterIDE(
+          std::find_if(m_scratchIDEs.begin(),
+                       m_scratchIDEs.end(),
+                       [&ide](const sim::TrackIDE& trackIDE) { return trackIDE.trackID == ide.trackID; }));
+
+        if (m_scratchIDEs.end() == iterIDE) {
+          sim::TrackIDE trackIDE;
+          trackIDE.trackID = ide.trackID;
+          trackIDE.energyFrac = 0.f;
+          trackIDE.energy = 0.f;
+          trackIDE.numElectrons = 0.f;
+          iterIDE = m_scratchIDEs.insert(m_scratchIDEs.end(), trackIDE);
+        }
+
+        iterIDE->energy += ide.energy;
+        iterIDE->numElectrons += ide.numElectrons;
+        totalE += ide.energy;
+      }
+    }
+
+    if (m_scratchIDEs.empty()) return;
+
+    // Protect against a divide by zero below
+    if (totalE < 1.e-5) totalE = 1.;
+
+    std::sort(m_scratchIDEs.begin(),
+              m_scratchIDEs.end(),
+              [](const sim::TrackIDE& lhs, const sim::TrackIDE& rhs) { return lhs.trackID < rhs.trackID; });
+
+    for (sim::TrackIDE& trackIDE : m_scratchIDEs) {
+      trackIDE.energyFrac = trackIDE.energy / totalE;
+      m_trackIDEs.push_back(trackIDE);
+    }
+  }
+
+} // namespace lar_pandora
@@ -0,0 +1,129 @@
+/**
+ *  @file   larpandora/LArPandoraInterface/LArPandoraBacktracker.h
+ *
+ *  @brief  Flat, channel indexed backtracking of reconstructed hits to the true energy deposits in the SimChannels
+ */
+
+#ifndef LAR_PANDORA_BACKTRACKER_H
+#define LAR_PANDORA_BACKTRACKER_H 1
+
+#include "lardataobj/Simulation/SimChannel.h"
+
+#include "larpandora/LArPandoraInterface/LArPandoraHelper.h"
+
+#include <vector>
+
+namespace detinfo {
+  class DetectorClocksData;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_pandora {
+
+  /**
+ *  @brief  LArPandoraBacktracker class. The time ordered energy deposits of each SimChannel are looked up by channel number
+ *          in a flat table, and the deposits in the time window of a hit are found by binary search. The true energy
+ *          deposits of all hits are held contiguously, with an offset per hit (compressed sparse row storage).
+ */
+  class LArPandoraBacktracker {
+  public:
+    typedef std::vector<sim::TDCIDE> TDCIDEVector;
+
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  simChannelVector the input vector of SimChannels
+     */
+    LArPandoraBacktracker(const SimChannelVector& simChannelVector);
+
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  simChannels the input SimChannel collection
+     */
+    LArPandoraBacktracker(const std::vector<sim::SimChannel>& simChannels);
+
+    /**
+     *  @brief  Find the true energy deposits of each hit, replacing those of any previous hits
+     *
+     *  @param  clockData the detector clocks for the event
+     *  @param  hitVector the input vector of reconstructed hits
+     */
+    void Backtrack(const detinfo::DetectorClocksData& clockData, const HitVector& hitVector);
+
+    /**
+     *  @brief  Get the number of hits backtracked
+     */
+    size_t GetNHits() const;
+
+    /**
+     *  @brief  Get the true energy deposits of a hit, in order of track id
+     *
+     *  @param  hitIndex the position of the hit in the input vector of hits
+     *  @param  pBegin to receive the first true energy deposit
+     *  @param  pEnd to receive the end of the true energy deposits
+     */
+    void GetTrackIDEs(const size_t hitIndex,
+                      const sim::TrackIDE*& pBegin,
+                      const sim::TrackIDE*& pEnd) const;
+
+    /**
+     *  @brief  Add the true energy deposits of the backtracked hits to a map, omitting hits without any
+     *
+     *  @param  hitVector the vector of hits that was backtracked
+     *  @param  hitsToTrackIDEs the output map from hits to true energy deposits
+     */
+    void FillHitsToTrackIDEs(const HitVector& hitVector, HitsToTrackIDEs& hitsToTrackIDEs) const;
+
+  private:
+    /**
+     *  @brief  Add a SimChannel to the channel table
+     *
+     *  @param  simChannel the SimChannel
+     */
+    void AddSimChannel(const sim::SimChannel& simChannel);
+
+    /**
+     *  @brief  Append the true energy deposits in a time window of a channel, summed by track id, as
+     *          sim::SimChannel::TrackIDEs would provide them
+     *
+     *  @param  tdcIDEVector the time ordered energy deposits of the channel
+     *  @param  startTDC the start of the time window
+     *  @param  endTDC the end of the time window
+     */
+    void AddTrackIDEs(const TDCIDEVector& tdcIDEVector,
+                      const unsigned int startTDC,
+                      const unsigned int endTDC);
+
+    std::vector<const TDCIDEVector*>
+      m_channelTable; ///< The energy deposits of each channel, indexed by channel number, nullptr if there are none
+    std::vector<size_t> m_hitOffsets; ///< The offset of the deposits of each hit, plus one trailing entry
+    std::vector<sim::TrackIDE> m_trackIDEs; ///< The true energy deposits of all hits
+    std::vector<sim::TrackIDE>
+      m_scratchIDEs; ///< Book-keeping: the deposits of the current hit, reused between hits
+  };
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline size_t
+  LArPandoraBacktracker::GetNHits() const
+  {
+    return m_hitOffsets.empty() ? 0 : m_hitOffsets.size() - 1;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline void
+  LArPandoraBacktracker::GetTrackIDEs(const size_t hitIndex,
+                                      const sim::TrackIDE*& pBegin,
+                                      const sim::TrackIDE*& pEnd) const
+  {
+    const size_t begin(m_hitOffsets.at(hitIndex)), end(m_hitOffsets.at(hitIndex + 1));
+    pBegin = m_trackIDEs.data() + begin;
+    pEnd = m_trackIDEs.data() + end;
+  }
+
+} // namespace lar_pandora
+
+#endif // #ifndef LAR_PANDORA_BACKTRACKER_H
@@ -0,0 +1,75 @@
+/**
+ *  @file   larpandora/LArPandoraInterface/LArPandoraCache.cxx
+ *
+ *  @brief  Fingerprints and files for the on-disk caches of job set-up products, such as the geometry model
+ */
+
+#include "larpandora/LArPandoraInterface/LArPandoraCache.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace lar_pandora {
+
+  std::string
+  LArPandoraCache::GetFileName(const std::string& directory,
+                               const std::string& header,
+                               const std::uint64_t fingerprint)
+  {
+    std::ostringstream fileName;
+    fileName << directory << "/" << header << "_" << std::hex << std::setw(16) << std::setfill('0')
+             << fingerprint << ".txt";
+
+    return fileName.str();
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  bool
+  LArPandoraCache::ReadHeader(std::istream& inputFile,
+                              const std::string& header,
+                              const std::uint64_t fingerprint)
+  {
+    std::string fileHeader;
+    std::uint64_t fileFingerprint(0);
+
+    if (!(inputFile >> fileHeader >> std::hex >> fileFingerprint >> std::dec)) return false;
+
+    return ((fileHeader == header) && (fileFingerprint == fingerprint));
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  bool
+  LArPandoraCache::WriteFile(const std::string& fileName,
+                             const std::string& header,
+                             const std::uint64_t fingerprint,
+                             const ContentsWriter& writeContents)
+  {
+    std::ostringstream temporaryFileName;
+    temporaryFileName << fileName << ".tmp" << ::getpid();
+
+    {
+      std::ofstream outputFile(temporaryFileName.str());
+      outputFile << header << " " << std::hex << fingerprint << std::dec << "\n"
+                 << std::setprecision(std::numeric_limits<float>::max_digits10);
+
+      writeContents(outputFile);
+
+      if (outputFile.flush()) {
+        outputFile.close();
+
+        if (0 == std::rename(temporaryFileName.str().c_str(), fileName.c_str())) return true;
+      }
+    }
+
+    std::remove(temporaryFileName.str().c_str());
+    return false;
+  }
+
+} // namespace lar_pandora
@@ -0,0 +1,157 @@
+/**
+ *  @file   larpandora/LArPandoraInterface/LArPandoraCache.h
+ *
+ *  @brief  Fingerprints and files for the on-disk caches of job set-up products, such as the geometry model
+ */
+
+#ifndef LAR_PANDORA_CACHE_H
+#define LAR_PANDORA_CACHE_H 1
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_pandora {
+
+  /**
+ *  @brief  LArPandoraFingerprint class, a 64-bit FNV-1a hash of everything a cached product depends upon. FNV-1a is used
+ *          rather than std::hash, so that the fingerprint is the same in every job.
+ */
+  class LArPandoraFingerprint {
+  public:
+    /**
+     *  @brief  Default constructor
+     */
+    LArPandoraFingerprint();
+
+    /**
+     *  @brief  Add a block of bytes to the fingerprint
+     *
+     *  @param  pData the address of the bytes
+     *  @param  nBytes the number of bytes
+     */
+    void AddBytes(const void* const pData, const size_t nBytes);
+
+    /**
+     *  @brief  Add the bytes of a trivially copyable value to the fingerprint
+     *
+     *  @param  value the value
+     */
+    template <typename T>
+    void AddValue(const T value);
+
+    /**
+     *  @brief  Add the characters of a string to the fingerprint
+     *
+     *  @param  value the string
+     */
+    void AddString(const std::string& value);
+
+    /**
+     *  @brief  Get the fingerprint
+     */
+    std::uint64_t GetValue() const;
+
+  private:
+    std::uint64_t m_value; ///< The fingerprint
+  };
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  /**
+ *  @brief  LArPandoraCache class, naming, reading and writing cache files. Each file starts with a header naming its
+ *          contents, followed by the fingerprint it was written with.
+ */
+  class LArPandoraCache {
+  public:
+    typedef std::function<void(std::ostream&)> ContentsWriter;
+
+    /**
+     *  @brief  Get the name of the cache file for some contents and fingerprint
+     *
+     *  @param  directory the cache directory
+     *  @param  header the header naming the contents
+     *  @param  fingerprint the fingerprint
+     */
+    static std::string GetFileName(const std::string& directory,
+                                   const std::string& header,
+                                   const std::uint64_t fingerprint);
+
+    /**
+     *  @brief  Read the header of a cache file, and check that it matches
+     *
+     *  @param  inputFile the cache file
+     *  @param  header the expected header
+     *  @param  fingerprint the expected fingerprint
+     *
+     *  @return whether the header and fingerprint were read and match
+     */
+    static bool ReadHeader(std::istream& inputFile,
+                           const std::string& header,
+                           const std::uint64_t fingerprint);
+
+    /**
+     *  @brief  Write a cache file. The file is written under a temporary name and then renamed, so that concurrent jobs
+     *          never read a partially written file.
+     *
+     *  @param  fileName the name of the file
+     *  @param  header the header naming the contents
+     *  @param  fingerprint the fingerprint
+     *  @param  writeContents writes the contents after the header, with floating point values at full precision
+     *
+     *  @return whether the file was written
+     */
+    static bool WriteFile(const std::string& fileName,
+                          const std::string& header,
+                          const std::uint64_t fingerprint,
+                          const ContentsWriter& writeContents);
+  };
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline LArPandoraFingerprint::LArPandoraFingerprint() : m_value(14695981039346656037ULL) {}
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline void
+  LArPandoraFingerprint::AddBytes(const void* const pData, const size_t nBytes)
+  {
+    const unsigned char* const pBytes(static_cast<const unsigned char*>(pData));
+
+    for (size_t iByte = 0; iByte < nBytes; ++iByte) {
+      m_value ^= pBytes[iByte];
+      m_value *= 1099511628211ULL;
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  template <typename T>
+  inline void
+  LArPandoraFingerprint::AddValue(const T value)
+  {
+    this->AddBytes(&value, sizeof(value));
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline void
+  LArPandoraFingerprint::AddString(const std::string& value)
+  {
+    this->AddBytes(value.data(), value.size());
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline std::uint64_t
+  LArPandoraFingerprint::GetValue() const
+  {
+    return m_value;
+  }
+
+} // namespace lar_pandora
+
+#endif // #ifndef LAR_PANDORA_CACHE_H
@@ -5,16 +5,24 @@
  */
 
 #include "cetlib_except/exception.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
 
 #include "larcore/Geometry/Geometry.h"
 #include "larcorealg/Geometry/PlaneGeo.h"
 #include "larcorealg/Geometry/TPCGeo.h"
 #include "larcorealg/Geometry/WireGeo.h"
 
+#include "larpandora/LArPandoraInterface/LArPandoraCache.h"
 #include "larpandora/LArPandoraInterface/LArPandoraGeometry.h"
 
+#include <algorithm>
+#include <array>
+#include <fstream>
 #include <iomanip>
+#include <limits>
+#include <mutex>
 #include <set>
+#include <utility>
 
 namespace lar_pandora {
 
@@ -26,14 +34,180 @@ namespace lar_pandora {
       throw cet::exception("LArPandora")
         << " LArPandoraGeometry::LoadDetectorGaps --- the list of gaps already exists ";
 
-    // Loop over drift volumes and write out the dead regions at their boundaries
+    const LArGeometryModelPtr pGeometryModel(LArPandoraGeometry::GetGeometryModel(""));
+    listOfGaps = pGeometryModel->GetDetectorGapList();
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraGeometry::LoadGeometry(LArDriftVolumeList& outputVolumeList,
+                                   LArDriftVolumeMap& outputVolumeMap)
+  {
+    if (!outputVolumeList.empty())
+      throw cet::exception("LArPandora")
+        << " LArPandoraGeometry::LoadGeometry --- the list of drift volumes already exists ";
+
+    const LArGeometryModelPtr pGeometryModel(LArPandoraGeometry::GetGeometryModel(""));
+    outputVolumeList = pGeometryModel->GetDaughterVolumeList();
+    outputVolumeMap.insert(pGeometryModel->GetDriftVolumeMap().begin(),
+                           pGeometryModel->GetDriftVolumeMap().end());
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArGeometryModelPtr
+  LArPandoraGeometry::GetGeometryModel(const std::string& cacheDirectory)
+  {
+    // ATTN The model is shared by every module in the process, and is only rebuilt if the geometry configuration changes
+    static std::mutex geometryModelMutex;
+    static std::map<std::uint64_t, LArGeometryModelPtr> geometryModelMap;
+
+    const std::uint64_t fingerprint(LArPandoraGeometry::GetGeometryFingerprint());
+
+    std::lock_guard<std::mutex> lock(geometryModelMutex);
+
+    const auto iter(geometryModelMap.find(fingerprint));
+    if (geometryModelMap.end() != iter) return iter->second;
+
     LArDriftVolumeList driftVolumeList;
-    LArPandoraGeometry::LoadGeometry(driftVolumeList);
+    LArDetectorGapList listOfGaps;
+
+    const std::string fileName(
+      cacheDirectory.empty() ?
+        "" :
+        LArPandoraCache::GetFileName(cacheDirectory, "LArPandoraGeometry", fingerprint));
+
+    if (!cacheDirectory.empty() &&
+        LArPandoraGeometry::ReadGeometryModel(fileName, fingerprint, driftVolumeList, listOfGaps)) {
+      mf::LogDebug("LArPandora") << "GetGeometryModel - read " << driftVolumeList.size()
+                                 << " drift volumes and " << listOfGaps.size()
+                                 << " detector gaps from " << fileName << std::endl;
+    }
+    else {
+      driftVolumeList.clear();
+      listOfGaps.clear();
+      LArPandoraGeometry::LoadGeometry(driftVolumeList);
+      LArPandoraGeometry::BuildDetectorGaps(driftVolumeList, listOfGaps);
+
+      if (!cacheDirectory.empty())
+        LArPandoraGeometry::WriteGeometryModel(fileName, fingerprint, driftVolumeList, listOfGaps);
+    }
+
+    // Use a global coordinate system but keep drift volumes separate
+    LArDriftVolumeList daughterVolumeList;
+    LArPandoraGeometry::LoadGlobalDaughterGeometry(driftVolumeList, daughterVolumeList);
+
+    // Create mapping between tpc/cstat labels and drift volumes
+    LArDriftVolumeMap driftVolumeMap;
+    for (const LArDriftVolume& driftVolume : daughterVolumeList) {
+      for (const LArDaughterDriftVolume& tpcVolume : driftVolume.GetTpcVolumeList()) {
+        (void)driftVolumeMap.insert(LArDriftVolumeMap::value_type(
+          LArPandoraGeometry::GetTpcID(tpcVolume.GetCryostat(), tpcVolume.GetTpc()), driftVolume));
+      }
+    }
 
+    const LArGeometryModelPtr pGeometryModel(std::make_shared<const LArGeometryModel>(
+      driftVolumeList, daughterVolumeList, driftVolumeMap, listOfGaps));
+    geometryModelMap[fingerprint] = pGeometryModel;
+
+    return pGeometryModel;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraGeometry::BuildDetectorGaps(const LArDriftVolumeList& driftVolumeList,
+                                        LArDetectorGapList& listOfGaps)
+  {
     // ATTN: Expectations here are that the input geometry corresponds to either a single or dual phase LArTPC.
     art::ServiceHandle<geo::Geometry const> theGeometry;
     const bool isDualPhase(theGeometry->MaxPlanes() == 2);
 
+    if (isDualPhase) {
+      LArPandoraGeometry::BuildDualPhaseDetectorGaps(driftVolumeList, listOfGaps);
+      return;
+    }
+
+    // Single phase gaps only lie between volumes whose centres are within the maximum gap size in z, so sweep along z and
+    // compare each volume with its neighbours in z alone, rather than with every other volume
+    const float maxDisplacement(LArDetectorGap::GetMaxGapSize());
+
+    std::vector<size_t> sortedIndices(driftVolumeList.size());
+    for (size_t index = 0; index < sortedIndices.size(); ++index)
+      sortedIndices[index] = index;
+
+    std::stable_sort(
+      sortedIndices.begin(), sortedIndices.end(), [&driftVolumeList](const size_t lhs, const size_t rhs) {
+        return driftVolumeList[lhs].GetCenterZ() < driftVolumeList[rhs].GetCenterZ();
+      });
+
+    std::vector<std::pair<size_t, size_t>> neighbourPairs;
+
+    for (size_t iSorted1 = 0, iSortedEnd = sortedIndices.size(); iSorted1 < iSortedEnd; ++iSorted1) {
+      const size_t index1(sortedIndices[iSorted1]);
+      const float centerZ1(driftVolumeList[index1].GetCenterZ());
+
+      for (size_t iSorted2 = iSorted1 + 1; iSorted2 < iSortedEnd; ++iSorted2) {
+        const size_t index2(sortedIndices[iSorted2]);
+
+        if (driftVolumeList[index2].GetCenterZ() - centerZ1 > maxDisplacement) break;
+
+        neighbourPairs.emplace_back(std::min(index1, index2), std::max(index1, index2));
+      }
+    }
+
+    // ATTN Visit the pairs in the order of the drift volume list, so the gaps do not depend upon how ties in z were broken
+    std::sort(neighbourPairs.begin(), neighbourPairs.end());
+
+    for (const std::pair<size_t, size_t>& neighbourPair : neighbourPairs) {
+      const LArDriftVolume& driftVolume1(driftVolumeList[neighbourPair.first]);
+      const LArDriftVolume& driftVolume2(driftVolumeList[neighbourPair.second]);
+
+      if (driftVolume1.GetVolumeID() == driftVolume2.GetVolumeID()) continue;
+
+      const float deltaX(std::fabs(driftVolume1.GetCenterX() - driftVolume2.GetCenterX()));
+      const float deltaY(std::fabs(driftVolume1.GetCenterY() - driftVolume2.GetCenterY()));
+      const float deltaZ(std::fabs(driftVolume1.GetCenterZ() - driftVolume2.GetCenterZ()));
+
+      const float widthX(0.5f * (driftVolume1.GetWidthX() + driftVolume2.GetWidthX()));
+      const float gapX(deltaX - widthX);
+
+      if (gapX < 0.f || gapX > maxDisplacement || deltaY > maxDisplacement ||
+          deltaZ > maxDisplacement)
+        continue;
+
+      const float X1((driftVolume1.GetCenterX() < driftVolume2.GetCenterX()) ?
+                       (driftVolume1.GetCenterX() + 0.5f * driftVolume1.GetWidthX()) :
+                       (driftVolume2.GetCenterX() + 0.5f * driftVolume2.GetWidthX()));
+      const float X2((driftVolume1.GetCenterX() > driftVolume2.GetCenterX()) ?
+                       (driftVolume1.GetCenterX() - 0.5f * driftVolume1.GetWidthX()) :
+                       (driftVolume2.GetCenterX() - 0.5f * driftVolume2.GetWidthX()));
+      const float Y1(std::min((driftVolume1.GetCenterY() - 0.5f * driftVolume1.GetWidthY()),
+                              (driftVolume2.GetCenterY() - 0.5f * driftVolume2.GetWidthY())));
+      const float Y2(std::max((driftVolume1.GetCenterY() + 0.5f * driftVolume1.GetWidthY()),
+                              (driftVolume2.GetCenterY() + 0.5f * driftVolume2.GetWidthY())));
+      const float Z1(std::min((driftVolume1.GetCenterZ() - 0.5f * driftVolume1.GetWidthZ()),
+                              (driftVolume2.GetCenterZ() - 0.5f * driftVolume2.GetWidthZ())));
+      const float Z2(std::max((driftVolume1.GetCenterZ() + 0.5f * driftVolume1.GetWidthZ()),
+                              (driftVolume2.GetCenterZ() + 0.5f * driftVolume2.GetWidthZ())));
+
+      listOfGaps.emplace_back(LArDetectorGap(X1, Y1, Z1, X2, Y2, Z2));
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraGeometry::BuildDualPhaseDetectorGaps(const LArDriftVolumeList& driftVolumeList,
+                                                 LArDetectorGapList& listOfGaps)
+  {
+    // ATTN In the dual phase scenario a gap is created for every pair of volumes that are separated in y or z by more than
+    // the maximum gap size, so distant pairs produce gaps and the number of gaps itself grows with the square of the number
+    // of volumes. A sweep along z, as for single phase, would only skip the close pairs, which produce no gap, so every
+    // pair of volumes is visited here.
+    const float maxDisplacement(LArDetectorGap::GetMaxGapSize());
+
     for (LArDriftVolumeList::const_iterator iter1 = driftVolumeList.begin(),
                                             iterEnd1 = driftVolumeList.end();
          iter1 != iterEnd1;
@@ -47,24 +221,15 @@ namespace lar_pandora {
 
         if (driftVolume1.GetVolumeID() == driftVolume2.GetVolumeID()) continue;
 
-        const float maxDisplacement(LArDetectorGap::GetMaxGapSize());
-
-        const float deltaX(std::fabs(driftVolume1.GetCenterX() - driftVolume2.GetCenterX()));
         const float deltaY(std::fabs(driftVolume1.GetCenterY() - driftVolume2.GetCenterY()));
         const float deltaZ(std::fabs(driftVolume1.GetCenterZ() - driftVolume2.GetCenterZ()));
 
-        const float widthX(0.5f * (driftVolume1.GetWidthX() + driftVolume2.GetWidthX()));
         const float widthY(0.5f * (driftVolume1.GetWidthY() + driftVolume2.GetWidthY()));
         const float widthZ(0.5f * (driftVolume1.GetWidthZ() + driftVolume2.GetWidthZ()));
 
-        const float gapX(deltaX - widthX);
         const float gapY(deltaY - widthY);
         const float gapZ(deltaZ - widthZ);
 
-        if (!isDualPhase && (gapX < 0.f || gapX > maxDisplacement || deltaY > maxDisplacement ||
-                             deltaZ > maxDisplacement))
-          continue;
-
         const float X1((driftVolume1.GetCenterX() < driftVolume2.GetCenterX()) ?
                          (driftVolume1.GetCenterX() + 0.5f * driftVolume1.GetWidthX()) :
                          (driftVolume2.GetCenterX() + 0.5f * driftVolume2.GetWidthX()));
@@ -80,84 +245,192 @@ namespace lar_pandora {
         const float Z2(std::max((driftVolume1.GetCenterZ() + 0.5f * driftVolume1.GetWidthZ()),
                                 (driftVolume2.GetCenterZ() + 0.5f * driftVolume2.GetWidthZ())));
 
-        if (isDualPhase && (std::fabs(gapY) > maxDisplacement || std::fabs(gapZ) > maxDisplacement))
+        if (std::fabs(gapY) > maxDisplacement || std::fabs(gapZ) > maxDisplacement)
           listOfGaps.emplace_back(
             LArDetectorGap(X1, Y1 + widthY, Z1 + widthZ, X2, Y2 - widthY, Z2 - widthZ));
-
-        else if (!isDualPhase)
-          listOfGaps.emplace_back(LArDetectorGap(X1, Y1, Z1, X2, Y2, Z2));
       }
-      if (isDualPhase)
-      {
-        for (LArDaughterDriftVolumeList::const_iterator iterDghtr1 = driftVolume1.GetTpcVolumeList().begin(),
-             iterDghtrEnd1 = driftVolume1.GetTpcVolumeList().end();
-             iterDghtr1 != iterDghtrEnd1; 
-             ++iterDghtr1) {
-          const LArDaughterDriftVolume &tpcVolume1(*iterDghtr1);
 
-          for (LArDaughterDriftVolumeList::const_iterator iterDghtr2 = iterDghtr1,
-               iterDghtrEnd2 = driftVolume1.GetTpcVolumeList().end();
-               iterDghtr2 != iterDghtrEnd2;
-               ++iterDghtr2) {
-            const LArDaughterDriftVolume &tpcVolume2(*iterDghtr2);
+      // Gaps between the tpcs within this drift volume
+      for (LArDaughterDriftVolumeList::const_iterator iterDghtr1 = driftVolume1.GetTpcVolumeList().begin(),
+           iterDghtrEnd1 = driftVolume1.GetTpcVolumeList().end();
+           iterDghtr1 != iterDghtrEnd1;
+           ++iterDghtr1) {
+        const LArDaughterDriftVolume& tpcVolume1(*iterDghtr1);
 
-            if (tpcVolume1.GetTpc() == tpcVolume2.GetTpc())
-              continue;
+        for (LArDaughterDriftVolumeList::const_iterator iterDghtr2 = iterDghtr1,
+             iterDghtrEnd2 = driftVolume1.GetTpcVolumeList().end();
+             iterDghtr2 != iterDghtrEnd2;
+             ++iterDghtr2) {
+          const LArDaughterDriftVolume& tpcVolume2(*iterDghtr2);
 
-            const float maxDisplacement(LArDetectorGap::GetMaxGapSize());
+          if (tpcVolume1.GetTpc() == tpcVolume2.GetTpc()) continue;
 
-            const float deltaY(std::fabs(tpcVolume1.GetCenterY() - tpcVolume2.GetCenterY()));
-            const float deltaZ(std::fabs(tpcVolume1.GetCenterZ() - tpcVolume2.GetCenterZ()));
+          const float deltaY(std::fabs(tpcVolume1.GetCenterY() - tpcVolume2.GetCenterY()));
+          const float deltaZ(std::fabs(tpcVolume1.GetCenterZ() - tpcVolume2.GetCenterZ()));
 
-            const float widthY(0.5f * (tpcVolume1.GetWidthY() + tpcVolume2.GetWidthY()));
-            const float widthZ(0.5f * (tpcVolume1.GetWidthZ() + tpcVolume2.GetWidthZ()));
+          const float widthY(0.5f * (tpcVolume1.GetWidthY() + tpcVolume2.GetWidthY()));
+          const float widthZ(0.5f * (tpcVolume1.GetWidthZ() + tpcVolume2.GetWidthZ()));
 
-            const float gapY(deltaY - widthY);
-            const float gapZ(deltaZ - widthZ);
+          const float gapY(deltaY - widthY);
+          const float gapZ(deltaZ - widthZ);
 
-            const float X1((tpcVolume1.GetCenterX() < tpcVolume2.GetCenterX()) ? (tpcVolume1.GetCenterX() + 0.5f * tpcVolume1.GetWidthX()) :
+          const float X1((tpcVolume1.GetCenterX() < tpcVolume2.GetCenterX()) ?
+                           (tpcVolume1.GetCenterX() + 0.5f * tpcVolume1.GetWidthX()) :
                            (tpcVolume2.GetCenterX() + 0.5f * tpcVolume2.GetWidthX()));
-            const float X2((tpcVolume1.GetCenterX() > tpcVolume2.GetCenterX()) ? (tpcVolume1.GetCenterX() - 0.5f * tpcVolume1.GetWidthX()) :
+          const float X2((tpcVolume1.GetCenterX() > tpcVolume2.GetCenterX()) ?
+                           (tpcVolume1.GetCenterX() - 0.5f * tpcVolume1.GetWidthX()) :
                            (tpcVolume2.GetCenterX() - 0.5f * tpcVolume2.GetWidthX()));
-            const float Y1(std::min((tpcVolume1.GetCenterY() - 0.5f * tpcVolume1.GetWidthY()),
-                                    (tpcVolume2.GetCenterY() - 0.5f * tpcVolume2.GetWidthY())));
-            const float Y2(std::max((tpcVolume1.GetCenterY() + 0.5f * tpcVolume1.GetWidthY()),
-                                    (tpcVolume2.GetCenterY() + 0.5f * tpcVolume2.GetWidthY())));
-            const float Z1(std::min((tpcVolume1.GetCenterZ() - 0.5f * tpcVolume1.GetWidthZ()),
-                                    (tpcVolume2.GetCenterZ() - 0.5f * tpcVolume2.GetWidthZ())));
-            const float Z2(std::max((tpcVolume1.GetCenterZ() + 0.5f * tpcVolume1.GetWidthZ()),
-                                    (tpcVolume2.GetCenterZ() + 0.5f * tpcVolume2.GetWidthZ())));
-
-            if (std::fabs(gapY) > maxDisplacement || std::fabs(gapZ) > maxDisplacement)
-              listOfGaps.emplace_back(LArDetectorGap(X1, Y1 + widthY, Z1 + widthZ, X2, Y2 - widthY, Z2 - widthZ));
+          const float Y1(std::min((tpcVolume1.GetCenterY() - 0.5f * tpcVolume1.GetWidthY()),
+                                  (tpcVolume2.GetCenterY() - 0.5f * tpcVolume2.GetWidthY())));
+          const float Y2(std::max((tpcVolume1.GetCenterY() + 0.5f * tpcVolume1.GetWidthY()),
+                                  (tpcVolume2.GetCenterY() + 0.5f * tpcVolume2.GetWidthY())));
+          const float Z1(std::min((tpcVolume1.GetCenterZ() - 0.5f * tpcVolume1.GetWidthZ()),
+                                  (tpcVolume2.GetCenterZ() - 0.5f * tpcVolume2.GetWidthZ())));
+          const float Z2(std::max((tpcVolume1.GetCenterZ() + 0.5f * tpcVolume1.GetWidthZ()),
+                                  (tpcVolume2.GetCenterZ() + 0.5f * tpcVolume2.GetWidthZ())));
+
+          if (std::fabs(gapY) > maxDisplacement || std::fabs(gapZ) > maxDisplacement)
+            listOfGaps.emplace_back(
+              LArDetectorGap(X1, Y1 + widthY, Z1 + widthZ, X2, Y2 - widthY, Z2 - widthZ));
+        }
+      }
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraGeometry::LoadWireGeometry(const LArDriftVolumeMap& driftVolumeMap,
+                                       LArWireGeometryTable& wireGeometryTable)
+  {
+    if (!wireGeometryTable.IsEmpty())
+      throw cet::exception("LArPandora")
+        << " LArPandoraGeometry::LoadWireGeometry --- the wire geometry table already exists ";
+
+    art::ServiceHandle<geo::Geometry const> theGeometry;
+
+    LArWireGeometryTable::OffsetVector cryostatOffsets, tpcOffsets, planeOffsets;
+    LArWireGeometryList wireList;
+
+    for (unsigned int icstat = 0; icstat < theGeometry->Ncryostats(); ++icstat) {
+      cryostatOffsets.push_back(tpcOffsets.size());
+
+      for (unsigned int itpc = 0; itpc < theGeometry->NTPC(icstat); ++itpc) {
+        tpcOffsets.push_back(planeOffsets.size());
+
+        // Volume IDs are shared by all wires in a TPC, so only look them up once
+        const unsigned int volumeID(LArPandoraGeometry::GetVolumeID(driftVolumeMap, icstat, itpc));
+        const unsigned int daughterVolumeID(
+          LArPandoraGeometry::GetDaughterVolumeID(driftVolumeMap, icstat, itpc));
+        const geo::TPCGeo& theTpc(theGeometry->Cryostat(icstat).TPC(itpc));
+
+        for (unsigned int iplane = 0; iplane < theTpc.Nplanes(); ++iplane) {
+          planeOffsets.push_back(wireList.size());
+
+          const geo::PlaneGeo& thePlane(theTpc.Plane(iplane));
+          const geo::View_t view(thePlane.View());
+          const float wirePitch(theGeometry->WirePitch(view));
+
+          // ATTN Planes with views Pandora does not recognise are only an error if a hit is found on them
+          geo::View_t globalView(geo::kUnknown);
+
+          try {
+            globalView = LArPandoraGeometry::GetGlobalView(icstat, itpc, view);
+          }
+          catch (const cet::exception&) {
+          }
+
+          for (unsigned int iwire = 0; iwire < thePlane.Nwires(); ++iwire) {
+            double xyz[3];
+            thePlane.Wire(iwire).GetCenter(xyz);
+            wireList.emplace_back(xyz[1], xyz[2], wirePitch, volumeID, daughterVolumeID, globalView);
           }
         }
       }
     }
+
+    cryostatOffsets.push_back(tpcOffsets.size());
+    tpcOffsets.push_back(planeOffsets.size());
+    planeOffsets.push_back(wireList.size());
+
+    wireGeometryTable = LArWireGeometryTable(cryostatOffsets, tpcOffsets, planeOffsets, wireList);
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandoraGeometry::LoadGeometry(LArDriftVolumeList& outputVolumeList,
-                                   LArDriftVolumeMap& outputVolumeMap)
+  LArPandoraGeometry::LoadTPCBoxIndex(LArTPCBoxIndex& tpcBoxIndex)
   {
-    if (!outputVolumeList.empty())
+    if (!tpcBoxIndex.IsEmpty())
       throw cet::exception("LArPandora")
-        << " LArPandoraGeometry::LoadGeometry --- the list of drift volumes already exists ";
+        << " LArPandoraGeometry::LoadTPCBoxIndex --- the tpc box index already exists ";
 
-    // Use a global coordinate system but keep drift volumes separate
-    LArDriftVolumeList inputVolumeList;
-    LArPandoraGeometry::LoadGeometry(inputVolumeList);
-    LArPandoraGeometry::LoadGlobalDaughterGeometry(inputVolumeList, outputVolumeList);
+    art::ServiceHandle<geo::Geometry const> theGeometry;
 
-    // Create mapping between tpc/cstat labels and drift volumes
-    for (const LArDriftVolume& driftVolume : outputVolumeList) {
-      for (const LArDaughterDriftVolume& tpcVolume : driftVolume.GetTpcVolumeList()) {
-        (void)outputVolumeMap.insert(LArDriftVolumeMap::value_type(
-          LArPandoraGeometry::GetTpcID(tpcVolume.GetCryostat(), tpcVolume.GetTpc()), driftVolume));
+    // ATTN Widen each box by the same relative tolerance that the geometry service applies when locating a position in a tpc
+    const double wiggle(1. + 1.e-4);
+    std::vector<std::array<double, 6>> boxList;
+
+    for (unsigned int icstat = 0; icstat < theGeometry->Ncryostats(); ++icstat) {
+      for (unsigned int itpc = 0; itpc < theGeometry->NTPC(icstat); ++itpc) {
+        const geo::TPCGeo& theTpc(theGeometry->Cryostat(icstat).TPC(itpc));
+        boxList.push_back({{(theTpc.MinX() > 0.) ? theTpc.MinX() / wiggle : theTpc.MinX() * wiggle,
+                            (theTpc.MaxX() < 0.) ? theTpc.MaxX() / wiggle : theTpc.MaxX() * wiggle,
+                            (theTpc.MinY() > 0.) ? theTpc.MinY() / wiggle : theTpc.MinY() * wiggle,
+                            (theTpc.MaxY() < 0.) ? theTpc.MaxY() / wiggle : theTpc.MaxY() * wiggle,
+                            (theTpc.MinZ() > 0.) ? theTpc.MinZ() / wiggle : theTpc.MinZ() * wiggle,
+                            (theTpc.MaxZ() < 0.) ? theTpc.MaxZ() / wiggle : theTpc.MaxZ() * wiggle}});
+      }
+    }
+
+    if (boxList.empty())
+      throw cet::exception("LArPandora")
+        << " LArPandoraGeometry::LoadTPCBoxIndex --- unable to find any tpcs in the geometry ";
+
+    // The cell edges in each coordinate are the distinct box faces
+    LArTPCBoxIndex::EdgeVector edges[3];
+
+    for (const std::array<double, 6>& box : boxList) {
+      for (unsigned int icoord = 0; icoord < 3; ++icoord) {
+        edges[icoord].push_back(box[2 * icoord]);
+        edges[icoord].push_back(box[2 * icoord + 1]);
+      }
+    }
+
+    for (LArTPCBoxIndex::EdgeVector& coordEdges : edges) {
+      std::sort(coordEdges.begin(), coordEdges.end());
+      coordEdges.erase(std::unique(coordEdges.begin(), coordEdges.end()), coordEdges.end());
+
+      // ATTN Keep the index well formed for a flat tpc, a zero width cell then holds its surface
+      if (coordEdges.size() < 2) coordEdges.push_back(coordEdges.front());
+    }
+
+    // A cell lies inside a tpc if its centre does, as no box face crosses the interior of a cell
+    const size_t nCellsX(edges[0].size() - 1), nCellsY(edges[1].size() - 1),
+      nCellsZ(edges[2].size() - 1);
+    std::vector<bool> isInsideCell(nCellsX * nCellsY * nCellsZ, false);
+
+    for (size_t iX = 0; iX < nCellsX; ++iX) {
+      const double x(0.5 * (edges[0][iX] + edges[0][iX + 1]));
+
+      for (size_t iY = 0; iY < nCellsY; ++iY) {
+        const double y(0.5 * (edges[1][iY] + edges[1][iY + 1]));
+
+        for (size_t iZ = 0; iZ < nCellsZ; ++iZ) {
+          const double z(0.5 * (edges[2][iZ] + edges[2][iZ + 1]));
+
+          for (const std::array<double, 6>& box : boxList) {
+            if (x >= box[0] && x <= box[1] && y >= box[2] && y <= box[3] && z >= box[4] &&
+                z <= box[5]) {
+              isInsideCell[(iX * nCellsY + iY) * nCellsZ + iZ] = true;
+              break;
+            }
+          }
+        }
       }
     }
+
+    tpcBoxIndex = LArTPCBoxIndex(edges[0], edges[1], edges[2], isInsideCell);
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
@@ -522,6 +795,198 @@ namespace lar_pandora {
                                             "failed to create daughter geometry list ";
   }
 
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  std::uint64_t
+  LArPandoraGeometry::GetGeometryFingerprint()
+  {
+    art::ServiceHandle<geo::Geometry const> theGeometry;
+
+    LArPandoraFingerprint fingerprint;
+    fingerprint.AddString(theGeometry->DetectorName());
+    fingerprint.AddValue(theGeometry->MaxPlanes());
+
+    for (unsigned int icstat = 0; icstat < theGeometry->Ncryostats(); ++icstat) {
+      for (unsigned int itpc = 0; itpc < theGeometry->NTPC(icstat); ++itpc) {
+        const geo::TPCGeo& theTpc(theGeometry->TPC(itpc, icstat));
+
+        double localCoord[3] = {0., 0., 0.};
+        double worldCoord[3] = {0., 0., 0.};
+        theTpc.LocalToWorld(localCoord, worldCoord);
+
+        fingerprint.AddValue(icstat);
+        fingerprint.AddValue(itpc);
+        fingerprint.AddBytes(worldCoord, sizeof(worldCoord));
+        fingerprint.AddValue(theTpc.ActiveHalfWidth());
+        fingerprint.AddValue(theTpc.ActiveHalfHeight());
+        fingerprint.AddValue(theTpc.ActiveLength());
+        fingerprint.AddValue(theTpc.DriftDirection());
+
+        for (unsigned int iplane = 0; iplane < theTpc.Nplanes(); ++iplane) {
+          const geo::View_t view(theTpc.Plane(iplane).View());
+          fingerprint.AddValue(view);
+          fingerprint.AddValue(theGeometry->WirePitch(view));
+          fingerprint.AddValue(theGeometry->WireAngleToVertical(view, itpc, icstat));
+        }
+      }
+    }
+
+    return fingerprint.GetValue();
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  bool
+  LArPandoraGeometry::ReadGeometryModel(const std::string& fileName,
+                                        const std::uint64_t fingerprint,
+                                        LArDriftVolumeList& driftVolumeList,
+                                        LArDetectorGapList& listOfGaps)
+  {
+    std::ifstream inputFile(fileName);
+
+    if (!inputFile) return false;
+
+    size_t nVolumes(0), nGaps(0);
+
+    if (!LArPandoraCache::ReadHeader(inputFile, "LArPandoraGeometry", fingerprint) ||
+        !(inputFile >> nVolumes >> nGaps) || (0 == nVolumes)) {
+      mf::LogWarning("LArPandora") << "ReadGeometryModel - ignoring invalid geometry model "
+                                   << fileName << std::endl;
+      return false;
+    }
+
+    LArDriftVolumeList fileVolumeList;
+    LArDetectorGapList fileGapList;
+    fileVolumeList.reserve(nVolumes);
+    fileGapList.reserve(nGaps);
+
+    for (size_t iVolume = 0; iVolume < nVolumes; ++iVolume) {
+      unsigned int volumeID(0);
+      bool isPositiveDrift(false);
+      float wirePitchU(0.f), wirePitchV(0.f), wirePitchW(0.f);
+      float wireAngleU(0.f), wireAngleV(0.f), wireAngleW(0.f);
+      float centerX(0.f), centerY(0.f), centerZ(0.f), widthX(0.f), widthY(0.f), widthZ(0.f);
+      float sigmaUVZ(0.f);
+      size_t nTpcVolumes(0);
+
+      if (!(inputFile >> volumeID >> isPositiveDrift >> wirePitchU >> wirePitchV >> wirePitchW >>
+            wireAngleU >> wireAngleV >> wireAngleW >> centerX >> centerY >> centerZ >> widthX >>
+            widthY >> widthZ >> sigmaUVZ >> nTpcVolumes)) {
+        mf::LogWarning("LArPandora")
+          << "ReadGeometryModel - ignoring truncated geometry model " << fileName << std::endl;
+        return false;
+      }
+
+      LArDaughterDriftVolumeList tpcVolumeList;
+      tpcVolumeList.reserve(nTpcVolumes);
+
+      for (size_t iTpcVolume = 0; iTpcVolume < nTpcVolumes; ++iTpcVolume) {
+        unsigned int cryostat(0), tpc(0);
+        float tpcCenterX(0.f), tpcCenterY(0.f), tpcCenterZ(0.f);
+        float tpcWidthX(0.f), tpcWidthY(0.f), tpcWidthZ(0.f);
+
+        if (!(inputFile >> cryostat >> tpc >> tpcCenterX >> tpcCenterY >> tpcCenterZ >>
+              tpcWidthX >> tpcWidthY >> tpcWidthZ)) {
+          mf::LogWarning("LArPandora")
+            << "ReadGeometryModel - ignoring truncated geometry model " << fileName << std::endl;
+          return false;
+        }
+
+        tpcVolumeList.emplace_back(
+          cryostat, tpc, tpcCenterX, tpcCenterY, tpcCenterZ, tpcWidthX, tpcWidthY, tpcWidthZ);
+      }
+
+      fileVolumeList.emplace_back(volumeID,
+                                  isPositiveDrift,
+                                  wirePitchU,
+                                  wirePitchV,
+                                  wirePitchW,
+                                  wireAngleU,
+                                  wireAngleV,
+                                  wireAngleW,
+                                  centerX,
+                                  centerY,
+                                  centerZ,
+                                  widthX,
+                                  widthY,
+                                  widthZ,
+                                  sigmaUVZ,
+                                  tpcVolumeList);
+    }
+
+    for (size_t iGap = 0; iGap < nGaps; ++iGap) {
+      float x1(0.f), y1(0.f), z1(0.f), x2(0.f), y2(0.f), z2(0.f);
+
+      if (!(inputFile >> x1 >> y1 >> z1 >> x2 >> y2 >> z2)) {
+        mf::LogWarning("LArPandora")
+          << "ReadGeometryModel - ignoring truncated geometry model " << fileName << std::endl;
+        return false;
+      }
+
+      fileGapList.emplace_back(x1, y1, z1, x2, y2, z2);
+    }
+
+    driftVolumeList.swap(fileVolumeList);
+    listOfGaps.swap(fileGapList);
+    return true;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraGeometry::WriteGeometryModel(const std::string& fileName,
+                                         const std::uint64_t fingerprint,
+                                         const LArDriftVolumeList& driftVolumeList,
+                                         const LArDetectorGapList& listOfGaps)
+  {
+    auto writeContents = [&driftVolumeList, &listOfGaps](std::ostream& outputFile) {
+      outputFile << driftVolumeList.size() << " " << listOfGaps.size() << "\n";
+
+      for (const LArDriftVolume& driftVolume : driftVolumeList) {
+        outputFile << driftVolume.GetVolumeID() << " " << driftVolume.IsPositiveDrift() << " "
+                   << driftVolume.GetWirePitchU() << " " << driftVolume.GetWirePitchV() << " "
+                   << driftVolume.GetWirePitchW() << " " << driftVolume.GetWireAngleU() << " "
+                   << driftVolume.GetWireAngleV() << " " << driftVolume.GetWireAngleW() << " "
+                   << driftVolume.GetCenterX() << " " << driftVolume.GetCenterY() << " "
+                   << driftVolume.GetCenterZ() << " " << driftVolume.GetWidthX() << " "
+                   << driftVolume.GetWidthY() << " " << driftVolume.GetWidthZ() << " "
+                   << driftVolume.GetSigmaUVZ() << " " << driftVolume.GetTpcVolumeList().size()
+                   << "\n";
+
+        for (const LArDaughterDriftVolume& tpcVolume : driftVolume.GetTpcVolumeList()) {
+          outputFile << tpcVolume.GetCryostat() << " " << tpcVolume.GetTpc() << " "
+                     << tpcVolume.GetCenterX() << " " << tpcVolume.GetCenterY() << " "
+                     << tpcVolume.GetCenterZ() << " " << tpcVolume.GetWidthX() << " "
+                     << tpcVolume.GetWidthY() << " " << tpcVolume.GetWidthZ() << "\n";
+        }
+      }
+
+      for (const LArDetectorGap& gap : listOfGaps) {
+        outputFile << gap.GetX1() << " " << gap.GetY1() << " " << gap.GetZ1() << " "
+                   << gap.GetX2() << " " << gap.GetY2() << " " << gap.GetZ2() << "\n";
+      }
+    };
+
+    if (LArPandoraCache::WriteFile(fileName, "LArPandoraGeometry", fingerprint, writeContents))
+      return;
+
+    mf::LogWarning("LArPandora") << "WriteGeometryModel - unable to write geometry model "
+                                 << fileName << std::endl;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArGeometryModel::LArGeometryModel(const LArDriftVolumeList& driftVolumeList,
+                                     const LArDriftVolumeList& daughterVolumeList,
+                                     const LArDriftVolumeMap& driftVolumeMap,
+                                     const LArDetectorGapList& detectorGapList)
+    : m_driftVolumeList(driftVolumeList)
+    , m_daughterVolumeList(daughterVolumeList)
+    , m_driftVolumeMap(driftVolumeMap)
+    , m_detectorGapList(detectorGapList)
+  {}
+
   //------------------------------------------------------------------------------------------------------------------------------------------
   //------------------------------------------------------------------------------------------------------------------------------------------
 
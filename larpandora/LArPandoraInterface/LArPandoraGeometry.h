@@ -7,9 +7,15 @@
 #ifndef LAR_PANDORA_GEOMETRY_H
 #define LAR_PANDORA_GEOMETRY_H 1
 
+#include "cetlib_except/exception.h"
+
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace lar_pandora {
@@ -312,6 +318,254 @@ private:
   //------------------------------------------------------------------------------------------------------------------------------------------
   //------------------------------------------------------------------------------------------------------------------------------------------
 
+  /**
+ *  @brief  wire geometry class to hold the properties of a single wire required to create pandora hits
+ */
+  class LArWireGeometry {
+  public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  centerY          centre of wire (Y)
+     *  @param  centerZ          centre of wire (Z)
+     *  @param  wirePitch        wire pitch for the view of this wire
+     *  @param  volumeID         the pandora drift volume ID
+     *  @param  daughterVolumeID the pandora daughter drift volume ID
+     *  @param  globalView       the view in the global coordinate system
+     */
+    LArWireGeometry(const double centerY,
+                    const double centerZ,
+                    const float wirePitch,
+                    const unsigned int volumeID,
+                    const unsigned int daughterVolumeID,
+                    const geo::View_t globalView);
+
+    /**
+     *  @brief Return Y position at centre of wire
+     */
+    double GetCenterY() const;
+
+    /**
+     *  @brief Return Z position at centre of wire
+     */
+    double GetCenterZ() const;
+
+    /**
+     *  @brief Return wire pitch
+     */
+    float GetWirePitch() const;
+
+    /**
+     *  @brief Return pandora drift volume ID
+     */
+    unsigned int GetVolumeID() const;
+
+    /**
+     *  @brief Return pandora daughter drift volume ID
+     */
+    unsigned int GetDaughterVolumeID() const;
+
+    /**
+     *  @brief Return view in the global coordinate system
+     */
+    geo::View_t GetGlobalView() const;
+
+  private:
+    double m_centerY;
+    double m_centerZ;
+    float m_wirePitch;
+    unsigned int m_volumeID;
+    unsigned int m_daughterVolumeID;
+    geo::View_t m_globalView;
+  };
+
+  typedef std::vector<LArWireGeometry> LArWireGeometryList;
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  /**
+ *  @brief  wire geometry table class to provide flat, indexed access to the wire geometry for each geo::WireID
+ */
+  class LArWireGeometryTable {
+  public:
+    typedef std::vector<size_t> OffsetVector;
+
+    /**
+     *  @brief  Default constructor, creates an empty table
+     */
+    LArWireGeometryTable() = default;
+
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  cryostatOffsets  offset of first tpc of each cryostat in the tpc offsets (plus one trailing entry)
+     *  @param  tpcOffsets       offset of first plane of each tpc in the plane offsets (plus one trailing entry)
+     *  @param  planeOffsets     offset of first wire of each plane in the wire list (plus one trailing entry)
+     *  @param  wireList         the flat list of wire geometry
+     */
+    LArWireGeometryTable(const OffsetVector& cryostatOffsets,
+                         const OffsetVector& tpcOffsets,
+                         const OffsetVector& planeOffsets,
+                         const LArWireGeometryList& wireList);
+
+    /**
+     *  @brief  Whether the table has been populated
+     */
+    bool IsEmpty() const;
+
+    /**
+     *  @brief  Get the number of planes in the table
+     */
+    size_t GetNPlanes() const;
+
+    /**
+     *  @brief  Get the flat index of a specified plane, throw an exception if it doesn't exist
+     *
+     *  @param  planeID the plane ID
+     */
+    size_t GetPlaneIndex(const geo::PlaneID& planeID) const;
+
+    /**
+     *  @brief  Get the wire geometry for a specified wire, throw an exception if it doesn't exist
+     *
+     *  @param  wireID the wire ID
+     */
+    const LArWireGeometry& GetWireGeometry(const geo::WireID& wireID) const;
+
+    /**
+     *  @brief  Get the wire geometry for a specified wire in a plane, throw an exception if it doesn't exist
+     *
+     *  @param  planeIndex the flat index of the plane
+     *  @param  wire the wire number in the plane
+     */
+    const LArWireGeometry& GetWireGeometry(const size_t planeIndex, const unsigned int wire) const;
+
+  private:
+    OffsetVector m_cryostatOffsets;
+    OffsetVector m_tpcOffsets;
+    OffsetVector m_planeOffsets;
+    LArWireGeometryList m_wireList;
+  };
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  /**
+ *  @brief  tpc box index class to answer whether positions lie inside any tpc, without searching the tpcs one by one
+ *
+ *          The tpc bounding boxes are cut into a grid of cells along the distinct box faces in each coordinate, and each
+ *          cell is flagged as inside or outside the tpcs, so that a position needs only a binary search per coordinate.
+ */
+  class LArTPCBoxIndex {
+  public:
+    typedef std::vector<double> EdgeVector;
+
+    /**
+     *  @brief  Default constructor, creates an empty index
+     */
+    LArTPCBoxIndex() = default;
+
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  xEdges the sorted, distinct x coordinates of the tpc box faces
+     *  @param  yEdges the sorted, distinct y coordinates of the tpc box faces
+     *  @param  zEdges the sorted, distinct z coordinates of the tpc box faces
+     *  @param  isInsideCell whether each cell lies inside a tpc, indexed by (x cell, y cell, z cell) with z varying fastest
+     */
+    LArTPCBoxIndex(const EdgeVector& xEdges,
+                   const EdgeVector& yEdges,
+                   const EdgeVector& zEdges,
+                   const std::vector<bool>& isInsideCell);
+
+    /**
+     *  @brief  Whether the index has been populated
+     */
+    bool IsEmpty() const;
+
+    /**
+     *  @brief  Whether a position lies inside (or on the surface of) any tpc
+     *
+     *  @param  x the x coordinate
+     *  @param  y the y coordinate
+     *  @param  z the z coordinate
+     */
+    bool IsInsideTPC(const double x, const double y, const double z) const;
+
+  private:
+    /**
+     *  @brief  Get the range of cells whose closed intervals contain a coordinate, empty if outside all the cells
+     *
+     *  @param  edges the cell edges
+     *  @param  coordinate the coordinate
+     *  @param  firstCell to receive the first cell
+     *  @param  lastCell to receive the last cell (at most one after the first, for a coordinate on an edge)
+     */
+    static bool GetCellRange(const EdgeVector& edges,
+                             const double coordinate,
+                             size_t& firstCell,
+                             size_t& lastCell);
+
+    EdgeVector m_xEdges;
+    EdgeVector m_yEdges;
+    EdgeVector m_zEdges;
+    std::vector<bool> m_isInsideCell;
+  };
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  /**
+ *  @brief  geometry model class to hold the drift volumes and detector gaps derived from one geometry configuration
+ */
+  class LArGeometryModel {
+  public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  driftVolumeList the list of drift volumes
+     *  @param  daughterVolumeList the list of drift volumes in the global coordinate system
+     *  @param  driftVolumeMap the mapping between cryostat/tpc and the drift volumes in the global coordinate system
+     *  @param  detectorGapList the list of gaps between drift volumes
+     */
+    LArGeometryModel(const LArDriftVolumeList& driftVolumeList,
+                     const LArDriftVolumeList& daughterVolumeList,
+                     const LArDriftVolumeMap& driftVolumeMap,
+                     const LArDetectorGapList& detectorGapList);
+
+    /**
+     *  @brief  Return the list of drift volumes
+     */
+    const LArDriftVolumeList& GetDriftVolumeList() const;
+
+    /**
+     *  @brief  Return the list of drift volumes in the global coordinate system
+     */
+    const LArDriftVolumeList& GetDaughterVolumeList() const;
+
+    /**
+     *  @brief  Return the mapping between cryostat/tpc and the drift volumes in the global coordinate system
+     */
+    const LArDriftVolumeMap& GetDriftVolumeMap() const;
+
+    /**
+     *  @brief  Return the list of gaps between drift volumes
+     */
+    const LArDetectorGapList& GetDetectorGapList() const;
+
+  private:
+    LArDriftVolumeList m_driftVolumeList;
+    LArDriftVolumeList m_daughterVolumeList;
+    LArDriftVolumeMap m_driftVolumeMap;
+    LArDetectorGapList m_detectorGapList;
+  };
+
+  typedef std::shared_ptr<const LArGeometryModel> LArGeometryModelPtr;
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
   /**
  *  @brief  LArPandoraGeometry class
  */
@@ -333,6 +587,31 @@ private:
     static void LoadGeometry(LArDriftVolumeList& outputVolumeList,
                              LArDriftVolumeMap& outputVolumeMap);
 
+    /**
+     *  @brief Get the geometry model for the current geometry configuration. The model is built once per configuration
+     *         and shared by every module in the process, and may be read from and written to an on-disk cache.
+     *
+     *  @param cacheDirectory the directory in which to cache the model, keyed by a fingerprint of the geometry; empty to
+     *         disable the on-disk cache
+     */
+    static LArGeometryModelPtr GetGeometryModel(const std::string& cacheDirectory);
+
+    /**
+     *  @brief Load the per-wire geometry required to create pandora hits, so that it need not be queried hit by hit
+     *
+     *  @param driftVolumeMap the mapping between cryostat/tpc and drift volumes
+     *  @param wireGeometryTable the output table of wire geometry
+     */
+    static void LoadWireGeometry(const LArDriftVolumeMap& driftVolumeMap,
+                                 LArWireGeometryTable& wireGeometryTable);
+
+    /**
+     *  @brief Load the index of tpc bounding boxes, used to find the parts of MC particle trajectories inside the detector
+     *
+     *  @param tpcBoxIndex the output tpc box index
+     */
+    static void LoadTPCBoxIndex(LArTPCBoxIndex& tpcBoxIndex);
+
     /**
      *  @brief  Get drift volume ID from a specified cryostat/tpc pair
      *
@@ -407,6 +686,58 @@ private:
      */
     static void LoadGlobalDaughterGeometry(const LArDriftVolumeList& driftVolumeList,
                                            LArDriftVolumeList& daughterVolumeList);
+
+    /**
+     *  @brief  Find the 2D gaps between a list of drift volumes, comparing only the volumes that are neighbours in z
+     *
+     *  @param  driftVolumeList the input drift volume list
+     *  @param  listOfGaps to receive the list of 2D gaps
+     */
+    static void BuildDetectorGaps(const LArDriftVolumeList& driftVolumeList,
+                                  LArDetectorGapList& listOfGaps);
+
+    /**
+     *  @brief  Find the 2D gaps between a list of dual phase drift volumes, and between the tpcs within each of them
+     *
+     *  @param  driftVolumeList the input drift volume list
+     *  @param  listOfGaps to receive the list of 2D gaps
+     */
+    static void BuildDualPhaseDetectorGaps(const LArDriftVolumeList& driftVolumeList,
+                                           LArDetectorGapList& listOfGaps);
+
+    /**
+     *  @brief  Get a fingerprint of everything the geometry model depends upon: the tpc positions, dimensions and drift
+     *          directions, and the wire pitches and angles
+     */
+    static std::uint64_t GetGeometryFingerprint();
+
+    /**
+     *  @brief  Read a geometry model from file
+     *
+     *  @param  fileName the name of the file
+     *  @param  fingerprint the fingerprint the model must have been written with
+     *  @param  driftVolumeList to receive the list of drift volumes
+     *  @param  listOfGaps to receive the list of 2D gaps
+     *
+     *  @return whether a valid model with a matching fingerprint was read
+     */
+    static bool ReadGeometryModel(const std::string& fileName,
+                                  const std::uint64_t fingerprint,
+                                  LArDriftVolumeList& driftVolumeList,
+                                  LArDetectorGapList& listOfGaps);
+
+    /**
+     *  @brief  Write a geometry model to file
+     *
+     *  @param  fileName the name of the file
+     *  @param  fingerprint the fingerprint of the model
+     *  @param  driftVolumeList the list of drift volumes
+     *  @param  listOfGaps the list of 2D gaps
+     */
+    static void WriteGeometryModel(const std::string& fileName,
+                                   const std::uint64_t fingerprint,
+                                   const LArDriftVolumeList& driftVolumeList,
+                                   const LArDetectorGapList& listOfGaps);
   };
 
   //------------------------------------------------------------------------------------------------------------------------------------------
@@ -673,6 +1004,254 @@ private:
     return m_sigmaUVZ;
   }
 
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline LArWireGeometry::LArWireGeometry(const double centerY,
+                                          const double centerZ,
+                                          const float wirePitch,
+                                          const unsigned int volumeID,
+                                          const unsigned int daughterVolumeID,
+                                          const geo::View_t globalView)
+    : m_centerY(centerY)
+    , m_centerZ(centerZ)
+    , m_wirePitch(wirePitch)
+    , m_volumeID(volumeID)
+    , m_daughterVolumeID(daughterVolumeID)
+    , m_globalView(globalView)
+  {}
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline double
+  LArWireGeometry::GetCenterY() const
+  {
+    return m_centerY;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline double
+  LArWireGeometry::GetCenterZ() const
+  {
+    return m_centerZ;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline float
+  LArWireGeometry::GetWirePitch() const
+  {
+    return m_wirePitch;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline unsigned int
+  LArWireGeometry::GetVolumeID() const
+  {
+    return m_volumeID;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline unsigned int
+  LArWireGeometry::GetDaughterVolumeID() const
+  {
+    return m_daughterVolumeID;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline geo::View_t
+  LArWireGeometry::GetGlobalView() const
+  {
+    return m_globalView;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline LArWireGeometryTable::LArWireGeometryTable(const OffsetVector& cryostatOffsets,
+                                                    const OffsetVector& tpcOffsets,
+                                                    const OffsetVector& planeOffsets,
+                                                    const LArWireGeometryList& wireList)
+    : m_cryostatOffsets(cryostatOffsets)
+    , m_tpcOffsets(tpcOffsets)
+    , m_planeOffsets(planeOffsets)
+    , m_wireList(wireList)
+  {}
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline bool
+  LArWireGeometryTable::IsEmpty() const
+  {
+    return m_wireList.empty();
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline size_t
+  LArWireGeometryTable::GetNPlanes() const
+  {
+    return m_planeOffsets.empty() ? 0 : m_planeOffsets.size() - 1;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline size_t
+  LArWireGeometryTable::GetPlaneIndex(const geo::PlaneID& planeID) const
+  {
+    // ATTN Each offset vector carries a trailing entry, so the entry after an index always bounds its range
+    if (planeID.Cryostat + 1 >= m_cryostatOffsets.size())
+      throw cet::exception("LArPandora")
+        << " LArWireGeometryTable::GetPlaneIndex --- found a cryostat outside the wire geometry ";
+
+    const size_t tpcIndex(m_cryostatOffsets[planeID.Cryostat] + planeID.TPC);
+
+    if (tpcIndex >= m_cryostatOffsets[planeID.Cryostat + 1])
+      throw cet::exception("LArPandora")
+        << " LArWireGeometryTable::GetPlaneIndex --- found a tpc outside the wire geometry ";
+
+    const size_t planeIndex(m_tpcOffsets[tpcIndex] + planeID.Plane);
+
+    if (planeIndex >= m_tpcOffsets[tpcIndex + 1])
+      throw cet::exception("LArPandora")
+        << " LArWireGeometryTable::GetPlaneIndex --- found a plane outside the wire geometry ";
+
+    return planeIndex;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const LArWireGeometry&
+  LArWireGeometryTable::GetWireGeometry(const geo::WireID& wireID) const
+  {
+    return this->GetWireGeometry(this->GetPlaneIndex(wireID.planeID()), wireID.Wire);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const LArWireGeometry&
+  LArWireGeometryTable::GetWireGeometry(const size_t planeIndex, const unsigned int wire) const
+  {
+    if (planeIndex >= this->GetNPlanes())
+      throw cet::exception("LArPandora")
+        << " LArWireGeometryTable::GetWireGeometry --- found a plane outside the wire geometry ";
+
+    const size_t wireIndex(m_planeOffsets[planeIndex] + wire);
+
+    if (wireIndex >= m_planeOffsets[planeIndex + 1])
+      throw cet::exception("LArPandora")
+        << " LArWireGeometryTable::GetWireGeometry --- found a wire outside the wire geometry ";
+
+    return m_wireList[wireIndex];
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline LArTPCBoxIndex::LArTPCBoxIndex(const EdgeVector& xEdges,
+                                        const EdgeVector& yEdges,
+                                        const EdgeVector& zEdges,
+                                        const std::vector<bool>& isInsideCell)
+    : m_xEdges(xEdges), m_yEdges(yEdges), m_zEdges(zEdges), m_isInsideCell(isInsideCell)
+  {
+    if (m_xEdges.size() < 2 || m_yEdges.size() < 2 || m_zEdges.size() < 2 ||
+        m_isInsideCell.size() !=
+          (m_xEdges.size() - 1) * (m_yEdges.size() - 1) * (m_zEdges.size() - 1))
+      throw cet::exception("LArPandora")
+        << " LArTPCBoxIndex::LArTPCBoxIndex --- inconsistent cell edges and cell flags ";
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline bool
+  LArTPCBoxIndex::IsEmpty() const
+  {
+    return m_isInsideCell.empty();
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline bool
+  LArTPCBoxIndex::IsInsideTPC(const double x, const double y, const double z) const
+  {
+    size_t firstX(0), lastX(0), firstY(0), lastY(0), firstZ(0), lastZ(0);
+
+    if (!LArTPCBoxIndex::GetCellRange(m_xEdges, x, firstX, lastX) ||
+        !LArTPCBoxIndex::GetCellRange(m_yEdges, y, firstY, lastY) ||
+        !LArTPCBoxIndex::GetCellRange(m_zEdges, z, firstZ, lastZ))
+      return false;
+
+    const size_t nCellsY(m_yEdges.size() - 1), nCellsZ(m_zEdges.size() - 1);
+
+    for (size_t iX = firstX; iX <= lastX; ++iX) {
+      for (size_t iY = firstY; iY <= lastY; ++iY) {
+        for (size_t iZ = firstZ; iZ <= lastZ; ++iZ) {
+          if (m_isInsideCell[(iX * nCellsY + iY) * nCellsZ + iZ]) return true;
+        }
+      }
+    }
+
+    return false;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline bool
+  LArTPCBoxIndex::GetCellRange(const EdgeVector& edges,
+                               const double coordinate,
+                               size_t& firstCell,
+                               size_t& lastCell)
+  {
+    if (edges.empty() || !(coordinate >= edges.front()) || !(coordinate <= edges.back()))
+      return false;
+
+    // ATTN Cell i spans [edges[i], edges[i+1]], so a coordinate on an interior edge belongs to the cells either side
+    const size_t nCells(edges.size() - 1);
+    const size_t lower(std::lower_bound(edges.begin(), edges.end(), coordinate) - edges.begin());
+    const size_t upper(std::upper_bound(edges.begin(), edges.end(), coordinate) - edges.begin());
+
+    firstCell = (lower > 0) ? lower - 1 : 0;
+    lastCell = std::min(upper - 1, nCells - 1);
+    return true;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const LArDriftVolumeList&
+  LArGeometryModel::GetDriftVolumeList() const
+  {
+    return m_driftVolumeList;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const LArDriftVolumeList&
+  LArGeometryModel::GetDaughterVolumeList() const
+  {
+    return m_daughterVolumeList;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const LArDriftVolumeMap&
+  LArGeometryModel::GetDriftVolumeMap() const
+  {
+    return m_driftVolumeMap;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const LArDetectorGapList&
+  LArGeometryModel::GetDetectorGapList() const
+  {
+    return m_detectorGapList;
+  }
+
 } // namespace lar_pandora
 
 #endif // #ifndef LAR_PANDORA_GEOMETRY_H
@@ -36,7 +36,9 @@
 #include "Pandora/PandoraInternal.h"
 #include "Pandora/PdgTable.h"
 
+#include "larpandora/LArPandoraInterface/LArPandoraBacktracker.h"
 #include "larpandora/LArPandoraInterface/LArPandoraHelper.h"
+#include "larpandora/LArPandoraInterface/LArPandoraMCParticleIndex.h"
 
 #include <iostream>
 #include <limits>
@@ -885,8 +887,7 @@ namespace lar_pandora {
   void
   LArPandoraHelper::CollectMCParticles(const art::Event& evt,
                                        const std::string& label,
-                                       MCTruthToMCParticles& truthToParticles,
-                                       MCParticlesToMCTruth& particlesToTruth)
+                                       MCTruthToMCParticles& truthToParticles)
   {
     art::Handle<RawMCParticleVector> theParticles;
     evt.getByLabel(label, theParticles);
@@ -904,9 +905,23 @@ namespace lar_pandora {
 
     for (unsigned int i = 0, iEnd = theParticles->size(); i < iEnd; ++i) {
       const art::Ptr<simb::MCParticle> particle(theParticles, i);
-      const art::Ptr<simb::MCTruth> truth(theTruthAssns.at(i));
-      truthToParticles[truth].push_back(particle);
-      particlesToTruth[particle] = truth;
+      truthToParticles[theTruthAssns.at(i)].push_back(particle);
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraHelper::CollectMCParticles(const art::Event& evt,
+                                       const std::string& label,
+                                       MCTruthToMCParticles& truthToParticles,
+                                       MCParticlesToMCTruth& particlesToTruth)
+  {
+    LArPandoraHelper::CollectMCParticles(evt, label, truthToParticles);
+
+    for (const MCTruthToMCParticles::value_type& truthAndParticles : truthToParticles) {
+      for (const art::Ptr<simb::MCParticle>& particle : truthAndParticles.second)
+        particlesToTruth[particle] = truthAndParticles.first;
     }
   }
 
@@ -921,42 +936,52 @@ namespace lar_pandora {
     auto const clock_data =
       art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(evt);
 
-    SimChannelMap simChannelMap;
-
-    for (SimChannelVector::const_iterator iter = simChannelVector.begin(),
-                                          iterEnd = simChannelVector.end();
-         iter != iterEnd;
-         ++iter) {
-      const art::Ptr<sim::SimChannel> simChannel = *iter;
-      simChannelMap.insert(SimChannelMap::value_type(simChannel->Channel(), simChannel));
-    }
+    LArPandoraBacktracker backtracker(simChannelVector);
+    backtracker.Backtrack(clock_data, hitVector);
+    backtracker.FillHitsToTrackIDEs(hitVector, hitsToTrackIDEs);
+  }
 
-    for (HitVector::const_iterator iter = hitVector.begin(), iterEnd = hitVector.end();
-         iter != iterEnd;
-         ++iter) {
-      const art::Ptr<recob::Hit> hit = *iter;
+  //------------------------------------------------------------------------------------------------------------------------------------------
 
-      SimChannelMap::const_iterator sIter = simChannelMap.find(hit->Channel());
-      if (simChannelMap.end() == sIter) continue; // Hit has no truth information [continue]
+  void
+  LArPandoraHelper::BuildMCParticleHitMaps(const art::Event& evt,
+                                           const HitVector& hitVector,
+                                           const std::string& simChannelLabel,
+                                           const std::string& hitLabel,
+                                           const std::string& backtrackLabel,
+                                           HitsToTrackIDEs& hitsToTrackIDEs)
+  {
+    art::Handle<std::vector<sim::SimChannel>> theSimChannels;
+    evt.getByLabel(simChannelLabel, theSimChannels);
 
-      // ATTN: Need to convert TDCtick (integer) to TDC (unsigned integer) before passing to simChannel
-      const raw::TDCtick_t start_tick(clock_data.TPCTick2TDC(hit->PeakTimeMinusRMS()));
-      const raw::TDCtick_t end_tick(clock_data.TPCTick2TDC(hit->PeakTimePlusRMS()));
-      const unsigned int start_tdc((start_tick < 0) ? 0 : start_tick);
-      const unsigned int end_tdc(end_tick);
+    if (theSimChannels.isValid() && !theSimChannels->empty()) {
+      mf::LogDebug("LArPandora") << "  Found: " << theSimChannels->size() << " SimChannels "
+                                 << std::endl;
 
-      if (start_tdc > end_tdc) continue; // Hit undershoots the readout window [continue]
+      auto const clock_data =
+        art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(evt);
 
-      const art::Ptr<sim::SimChannel> simChannel = sIter->second;
-      const TrackIDEVector trackCollection(simChannel->TrackIDEs(start_tdc, end_tdc));
+      // ATTN The hits are backtracked directly from the SimChannel collection, without a vector of Ptrs to it
+      LArPandoraBacktracker backtracker(*theSimChannels);
+      backtracker.Backtrack(clock_data, hitVector);
+      backtracker.FillHitsToTrackIDEs(hitVector, hitsToTrackIDEs);
+    }
+    else if (!theSimChannels.isValid()) {
+      mf::LogDebug("LArPandora") << "  Failed to find sim channels... " << std::endl;
 
-      if (trackCollection.empty()) continue; // Hit has no truth information [continue]
+      if (backtrackLabel.empty())
+        throw cet::exception("LArPandora")
+          << "LArPandoraHelper::BuildMCParticleHitMaps - Can't build MCParticle to Hit map."
+          << std::endl
+          << "No SimChannels found with label \"" << simChannelLabel
+          << "\", and BackTrackerModuleLabel isn't set in FHiCL." << std::endl;
 
-      for (unsigned int iTrack = 0, iTrackEnd = trackCollection.size(); iTrack < iTrackEnd;
-           ++iTrack) {
-        const sim::TrackIDE trackIDE = trackCollection.at(iTrack);
-        hitsToTrackIDEs[hit].push_back(trackIDE);
-      }
+      LArPandoraHelper::BuildMCParticleHitMaps(evt, hitLabel, backtrackLabel, hitsToTrackIDEs);
+    }
+    else {
+      mf::LogDebug("LArPandora")
+        << " *** LArPandoraHelper::BuildMCParticleHitMaps - empty list of sim channels found "
+        << std::endl;
     }
   }
 
@@ -969,22 +994,8 @@ namespace lar_pandora {
                                            HitsToMCParticles& hitsToParticles,
                                            const DaughterMode daughterMode)
   {
-    // Build mapping between particles and track IDs for parent/daughter navigation
-    MCParticleMap particleMap;
-
-    for (MCTruthToMCParticles::const_iterator iter1 = truthToParticles.begin(),
-                                              iterEnd1 = truthToParticles.end();
-         iter1 != iterEnd1;
-         ++iter1) {
-      const MCParticleVector& particleVector = iter1->second;
-      for (MCParticleVector::const_iterator iter2 = particleVector.begin(),
-                                            iterEnd2 = particleVector.end();
-           iter2 != iterEnd2;
-           ++iter2) {
-        const art::Ptr<simb::MCParticle> particle = *iter2;
-        particleMap[particle->TrackId()] = particle;
-      }
-    }
+    // Build index of particles by track ID for parent/daughter navigation
+    const LArPandoraMCParticleIndex particleIndex(truthToParticles);
 
     // Loop over hits and build mapping between reconstructed hits and true particles
     for (HitsToTrackIDEs::const_iterator iter1 = hitsToTrackIDEs.begin(),
@@ -1012,15 +1023,15 @@ namespace lar_pandora {
       }
 
       if (bestTrackID >= 0) {
-        MCParticleMap::const_iterator iter3 = particleMap.find(bestTrackID);
-        if (particleMap.end() == iter3)
+        size_t bestIndex(0);
+        if (!particleIndex.FindTrackID(bestTrackID, bestIndex))
           throw cet::exception("LArPandora") << " PandoraCollector::BuildMCParticleHitMaps --- "
                                                 "Found a track ID without an MC Particle ";
 
         try {
-          const art::Ptr<simb::MCParticle> thisParticle = iter3->second;
+          const art::Ptr<simb::MCParticle> thisParticle = particleIndex.GetParticle(bestIndex);
           const art::Ptr<simb::MCParticle> primaryParticle(
-            LArPandoraHelper::GetFinalStateMCParticle(particleMap, thisParticle));
+            LArPandoraHelper::GetFinalStateMCParticle(particleIndex, thisParticle));
           const art::Ptr<simb::MCParticle> selectedParticle(
             (kAddDaughters == daughterMode) ? primaryParticle : thisParticle);
 
@@ -1344,6 +1355,38 @@ namespace lar_pandora {
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
+  art::Ptr<simb::MCParticle>
+  LArPandoraHelper::GetFinalStateMCParticle(const LArPandoraMCParticleIndex& particleIndex,
+                                            const art::Ptr<simb::MCParticle> inputParticle)
+  {
+    // Navigate upward through MC daughter/parent links - collect this particle and all its parents
+    MCParticleVector mcVector;
+
+    int trackID(inputParticle->TrackId());
+    size_t index(0);
+
+    while (particleIndex.FindTrackID(trackID, index)) {
+      const art::Ptr<simb::MCParticle>& particle = particleIndex.GetParticle(index);
+      mcVector.push_back(particle);
+
+      trackID = particle->Mother();
+    }
+
+    // Navigate downward through MC parent/daughter links - return the first long-lived charged particle
+    for (MCParticleVector::const_reverse_iterator iter = mcVector.rbegin(),
+                                                  iterEnd = mcVector.rend();
+         iter != iterEnd;
+         ++iter) {
+      const art::Ptr<simb::MCParticle> nextParticle = *iter;
+
+      if (LArPandoraHelper::IsVisible(nextParticle)) return nextParticle;
+    }
+
+    throw cet::exception("LArPandora"); // need to catch this exception
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
   art::Ptr<recob::Track>
   LArPandoraHelper::GetPrimaryTrack(const PFParticlesToTracks& particlesToTracks,
                                     const art::Ptr<recob::PFParticle> particle)
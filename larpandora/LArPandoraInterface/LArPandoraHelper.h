@@ -52,6 +52,8 @@ namespace simb {
 
 namespace lar_pandora {
 
+  class LArPandoraMCParticleIndex;
+
   typedef std::set<art::Ptr<recob::Hit>> HitList;
 
   typedef std::vector<art::Ptr<recob::Wire>> WireVector;
@@ -461,6 +463,17 @@ namespace lar_pandora {
                                             const std::string& label,
                                             RawMCParticleVector& particleVector);
 
+    /**
+     *  @brief Collect truth information from the ART event record
+     *
+     *  @param evt the ART event record
+     *  @param label the label for the truth information in the event
+     *  @param truthToParticles output map from MCTruth to MCParticle objects
+     */
+    static void CollectMCParticles(const art::Event& evt,
+                                   const std::string& label,
+                                   MCTruthToMCParticles& truthToParticles);
+
     /**
      *  @brief Collect truth information from the ART event record
      *
@@ -487,6 +500,24 @@ namespace lar_pandora {
                                        const SimChannelVector& simChannelVector,
                                        HitsToTrackIDEs& hitsToTrackIDEs);
 
+    /**
+     *  @brief Collect the links from reconstructed hits to their true energy deposits, using the SimChannels or, if they
+     *         do not exist, the back-tracker information. Throw an exception if neither is available.
+     *
+     *  @param evt the art event containers
+     *  @param hitVector the input vector of reconstructed hits
+     *  @param simChannelLabel the label of the collection of SimChannels
+     *  @param hitLabel the label of the collection of hits
+     *  @param backtrackLabel the label of the collection of back-tracker information, empty if there is none
+     *  @param hitsToTrackIDEs the out map from hits to true energy deposits
+     */
+    static void BuildMCParticleHitMaps(const art::Event& evt,
+                                       const HitVector& hitVector,
+                                       const std::string& simChannelLabel,
+                                       const std::string& hitLabel,
+                                       const std::string& backtrackLabel,
+                                       HitsToTrackIDEs& hitsToTrackIDEs);
+
     /**
      *  @brief Build mapping between Hits and MCParticles, starting from Hit/TrackIDE/MCParticle information
      *
@@ -651,6 +682,18 @@ namespace lar_pandora {
       const MCParticleMap& particleMap,
       const art::Ptr<simb::MCParticle> daughterParticle);
 
+    /**
+     *  @brief Return the final-state parent particle by navigating up the chain of parent/daughter associations
+     *
+     *  @param particleIndex the index of true particles by true track ID
+     *  @param daughterParticle the input MC particle
+     *
+     *  @return the final-state parent particle
+     */
+    static art::Ptr<simb::MCParticle> GetFinalStateMCParticle(
+      const LArPandoraMCParticleIndex& particleIndex,
+      const art::Ptr<simb::MCParticle> daughterParticle);
+
     /**
      *  @brief Return the primary track associated with a PFParticle
      *
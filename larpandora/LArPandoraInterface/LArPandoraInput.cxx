@@ -17,8 +17,6 @@
 
 #include "nusimdata/SimulationBase/MCTruth.h"
 
-#include "larsim/MCCheater/ParticleInventoryService.h"
-
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 #include "lardata/DetectorInfoServices/LArPropertiesService.h"
@@ -31,8 +29,13 @@
 #include "larpandoracontent/LArObjects/LArMCParticle.h"
 
 #include "larpandora/LArPandoraInterface/ILArPandora.h"
+#include "larpandora/LArPandoraInterface/LArPandoraCache.h"
 #include "larpandora/LArPandoraInterface/LArPandoraInput.h"
+#include "larpandora/LArPandoraInterface/LArPandoraMCParticleIndex.h"
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
 #include <limits>
 
 namespace lar_pandora {
@@ -40,7 +43,7 @@ namespace lar_pandora {
   void
   LArPandoraInput::CreatePandoraHits2D(const art::Event& e,
                                        const Settings& settings,
-                                       const LArDriftVolumeMap& driftVolumeMap,
+                                       const LArWireGeometryTable& wireGeometryTable,
                                        const HitVector& hitVector,
                                        IdToHitMap& idToHitMap)
   {
@@ -52,111 +55,128 @@ namespace lar_pandora {
         << "CreatePandoraHits2D - primary Pandora instance does not exist ";
 
     const pandora::Pandora* pPandora(settings.m_pPrimaryPandora);
+    const pandora::LArTransformationPlugin* const pTransformationPlugin(
+      pPandora->GetPlugins()->GetLArTransformationPlugin());
 
     art::ServiceHandle<geo::Geometry const> theGeometry;
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(e);
     const bool isDualPhase(theGeometry->MaxPlanes() == 2);
 
-    // Loop over ART hits
-    int hitCounter(settings.m_hitCounterOffset);
+    if (!std::isfinite(settings.m_dx_cm) || !std::isfinite(settings.m_dx_cm / settings.m_rad_cm) ||
+        !std::isfinite(settings.m_dx_cm / settings.m_int_cm) ||
+        !std::isfinite(settings.m_mips_to_gev))
+      throw cet::exception("LArPandora")
+        << "CreatePandoraHits2D - invalid default hit width, radiation length, interaction length "
+           "or MIP to GeV conversion ";
 
-    lar_content::LArCaloHitFactory caloHitFactory;
+    // Gather the properties of all the hits into the buffer, before passing any of them to pandora
+    const size_t nHits(hitVector.size());
 
-    for (HitVector::const_iterator iter = hitVector.begin(), iterEnd = hitVector.end();
-         iter != iterEnd;
-         ++iter) {
-      const art::Ptr<recob::Hit> hit = *iter;
-      const geo::WireID hit_WireID(hit->WireID());
+    CaloHitBuffer caloHitBuffer;
+    caloHitBuffer.Reserve(nHits);
 
-      // Get basic hit properties (view, time, charge)
-      const geo::View_t hit_View(hit->View());
-      const double hit_Charge(hit->Integral());
-      const double hit_Time(hit->PeakTime());
-      const double hit_TimeStart(hit->PeakTimeMinusRMS());
-      const double hit_TimeEnd(hit->PeakTimePlusRMS());
-
-      // Get hit X coordinate and, if using a single global drift volume, remove any out-of-time hits here
-      const double xpos_cm(
-        detProp.ConvertTicksToX(hit_Time, hit_WireID.Plane, hit_WireID.TPC, hit_WireID.Cryostat));
-      const double dxpos_cm(
-        std::fabs(detProp.ConvertTicksToX(
-                    hit_TimeEnd, hit_WireID.Plane, hit_WireID.TPC, hit_WireID.Cryostat) -
-                  detProp.ConvertTicksToX(
-                    hit_TimeStart, hit_WireID.Plane, hit_WireID.TPC, hit_WireID.Cryostat)));
+    std::vector<double> peakTimes, startTimes, endTimes, xOffsets, xCoefficients;
+    peakTimes.reserve(nHits);
+    startTimes.reserve(nHits);
+    endTimes.reserve(nHits);
+    xOffsets.reserve(nHits);
+    xCoefficients.reserve(nHits);
 
-      // Get hit Y and Z coordinates, based on central position of wire
-      double xyz[3];
-      theGeometry->Cryostat(hit_WireID.Cryostat)
-        .TPC(hit_WireID.TPC)
-        .Plane(hit_WireID.Plane)
-        .Wire(hit_WireID.Wire)
-        .GetCenter(xyz);
-      const double y0_cm(xyz[1]);
-      const double z0_cm(xyz[2]);
-
-      // Get other hit properties here
-      const double wire_pitch_cm(theGeometry->WirePitch(hit_View)); // cm
-      const double mips(LArPandoraInput::GetMips(detProp, settings, hit_Charge, hit_View));
-
-      // Create Pandora CaloHit
-      lar_content::LArCaloHitParameters caloHitParameters;
+    // ATTN The tick to X conversion is affine in ticks, so only needs to be evaluated twice per plane per event
+    const size_t nPlanes(wireGeometryTable.GetNPlanes());
+    std::vector<double> planeXOffsets(nPlanes, 0.), planeXCoefficients(nPlanes, 0.);
+    std::vector<bool> planeHasDriftConstants(nPlanes, false);
 
-      try {
-        caloHitParameters.m_expectedDirection = pandora::CartesianVector(0., 0., 1.);
-        caloHitParameters.m_cellNormalVector = pandora::CartesianVector(0., 0., 1.);
-        caloHitParameters.m_cellSize0 = settings.m_dx_cm;
-        caloHitParameters.m_cellSize1 = (settings.m_useHitWidths ? dxpos_cm : settings.m_dx_cm);
-        caloHitParameters.m_cellThickness = wire_pitch_cm;
-        caloHitParameters.m_cellGeometry = pandora::RECTANGULAR;
-        caloHitParameters.m_time = 0.;
-        caloHitParameters.m_nCellRadiationLengths = settings.m_dx_cm / settings.m_rad_cm;
-        caloHitParameters.m_nCellInteractionLengths = settings.m_dx_cm / settings.m_int_cm;
-        caloHitParameters.m_isDigital = false;
-        caloHitParameters.m_hitRegion = pandora::SINGLE_REGION;
-        caloHitParameters.m_layer = 0;
-        caloHitParameters.m_isInOuterSamplingLayer = false;
-        caloHitParameters.m_inputEnergy = hit_Charge;
-        caloHitParameters.m_mipEquivalentEnergy = mips;
-        caloHitParameters.m_electromagneticEnergy = mips * settings.m_mips_to_gev;
-        caloHitParameters.m_hadronicEnergy = mips * settings.m_mips_to_gev;
-        caloHitParameters.m_pParentAddress = (void*)((intptr_t)(++hitCounter));
-        caloHitParameters.m_larTPCVolumeId =
-          LArPandoraGeometry::GetVolumeID(driftVolumeMap, hit_WireID.Cryostat, hit_WireID.TPC);
-        caloHitParameters.m_daughterVolumeId = 
-          LArPandoraGeometry::GetDaughterVolumeID(driftVolumeMap, hit_WireID.Cryostat, hit_WireID.TPC);
-
-        const geo::View_t pandora_GlobalView(
-          LArPandoraGeometry::GetGlobalView(hit_WireID.Cryostat, hit_WireID.TPC, hit_View));
-        const geo::View_t pandora_View(
-          isDualPhase ? ((pandora_GlobalView == geo::kW) ?
-                           geo::kU :
-                           ((pandora_GlobalView == geo::kY) ? geo::kV : geo::kUnknown)) :
-                        pandora_GlobalView);
-
-        if (pandora_View == geo::kW || pandora_View == geo::kY) {
-          caloHitParameters.m_hitType = pandora::TPC_VIEW_W;
-          const double wpos_cm(
-            pPandora->GetPlugins()->GetLArTransformationPlugin()->YZtoW(y0_cm, z0_cm));
-          caloHitParameters.m_positionVector = pandora::CartesianVector(xpos_cm, 0., wpos_cm);
-        }
-        else if (pandora_View == geo::kU) {
-          caloHitParameters.m_hitType = pandora::TPC_VIEW_U;
-          const double upos_cm(
-            pPandora->GetPlugins()->GetLArTransformationPlugin()->YZtoU(y0_cm, z0_cm));
-          caloHitParameters.m_positionVector = pandora::CartesianVector(xpos_cm, 0., upos_cm);
-        }
-        else if (pandora_View == geo::kV) {
-          caloHitParameters.m_hitType = pandora::TPC_VIEW_V;
-          const double vpos_cm(
-            pPandora->GetPlugins()->GetLArTransformationPlugin()->YZtoV(y0_cm, z0_cm));
-          caloHitParameters.m_positionVector = pandora::CartesianVector(xpos_cm, 0., vpos_cm);
-        }
-        else {
-          throw cet::exception("LArPandora")
-            << "CreatePandoraHits2D - this wire view not recognised (View=" << hit_View << ") ";
-        }
+    for (const art::Ptr<recob::Hit>& hit : hitVector) {
+      const geo::WireID hit_WireID(hit->WireID());
+      const size_t planeIndex(wireGeometryTable.GetPlaneIndex(hit_WireID.planeID()));
+
+      if (!planeHasDriftConstants[planeIndex]) {
+        const double x0_cm(
+          detProp.ConvertTicksToX(0., hit_WireID.Plane, hit_WireID.TPC, hit_WireID.Cryostat));
+        const double x1_cm(
+          detProp.ConvertTicksToX(1., hit_WireID.Plane, hit_WireID.TPC, hit_WireID.Cryostat));
+        planeXOffsets[planeIndex] = x0_cm;
+        planeXCoefficients[planeIndex] = x1_cm - x0_cm;
+        planeHasDriftConstants[planeIndex] = true;
       }
-      catch (const pandora::StatusCodeException&) {
+
+      // Get hit Y and Z coordinates, based on central position of wire
+      const LArWireGeometry& wireGeometry(
+        wireGeometryTable.GetWireGeometry(planeIndex, hit_WireID.Wire));
+      const double y0_cm(wireGeometry.GetCenterY());
+      const double z0_cm(wireGeometry.GetCenterZ());
+
+      const geo::View_t pandora_GlobalView(wireGeometry.GetGlobalView());
+      const geo::View_t pandora_View(
+        isDualPhase ? ((pandora_GlobalView == geo::kW) ?
+                         geo::kU :
+                         ((pandora_GlobalView == geo::kY) ? geo::kV : geo::kUnknown)) :
+                      pandora_GlobalView);
+
+      pandora::HitType hitType(pandora::TPC_VIEW_W);
+      double viewpos_cm(0.);
+
+      if (pandora_View == geo::kW || pandora_View == geo::kY) {
+        hitType = pandora::TPC_VIEW_W;
+        viewpos_cm = pTransformationPlugin->YZtoW(y0_cm, z0_cm);
+      }
+      else if (pandora_View == geo::kU) {
+        hitType = pandora::TPC_VIEW_U;
+        viewpos_cm = pTransformationPlugin->YZtoU(y0_cm, z0_cm);
+      }
+      else if (pandora_View == geo::kV) {
+        hitType = pandora::TPC_VIEW_V;
+        viewpos_cm = pTransformationPlugin->YZtoV(y0_cm, z0_cm);
+      }
+      else {
+        throw cet::exception("LArPandora")
+          << "CreatePandoraHits2D - this wire view not recognised (View=" << hit->View() << ") ";
+      }
+
+      caloHitBuffer.m_hits.push_back(hit);
+      caloHitBuffer.m_hitTypes.push_back(hitType);
+      caloHitBuffer.m_viewPositions.push_back(viewpos_cm);
+      caloHitBuffer.m_wirePitches.push_back(wireGeometry.GetWirePitch());
+      caloHitBuffer.m_charges.push_back(hit->Integral());
+      caloHitBuffer.m_larTPCVolumeIds.push_back(wireGeometry.GetVolumeID());
+      caloHitBuffer.m_daughterVolumeIds.push_back(wireGeometry.GetDaughterVolumeID());
+
+      peakTimes.push_back(hit->PeakTime());
+      startTimes.push_back(hit->PeakTimeMinusRMS());
+      endTimes.push_back(hit->PeakTimePlusRMS());
+      xOffsets.push_back(planeXOffsets[planeIndex]);
+      xCoefficients.push_back(planeXCoefficients[planeIndex]);
+    }
+
+    // Convert the hit times and charges for all the hits at once
+    LArPandoraInput::ConvertTicksToX(settings,
+                                     peakTimes,
+                                     startTimes,
+                                     endTimes,
+                                     xOffsets,
+                                     xCoefficients,
+                                     caloHitBuffer.m_xPositions,
+                                     caloHitBuffer.m_widths);
+    LArPandoraInput::GetMips(detProp,
+                             settings,
+                             caloHitBuffer.m_charges,
+                             caloHitBuffer.m_wirePitches,
+                             caloHitBuffer.m_mips);
+
+    // ATTN Check here that the values are finite, as pandora requires, so that no hit can fail part way through submission
+    std::vector<bool> isValidHit(nHits, false);
+    size_t nValidHits(0);
+
+    for (size_t iHit = 0; iHit < nHits; ++iHit) {
+      const double mips(caloHitBuffer.m_mips[iHit]);
+
+      if (!std::isfinite(caloHitBuffer.m_xPositions[iHit]) ||
+          !std::isfinite(caloHitBuffer.m_viewPositions[iHit]) ||
+          !std::isfinite(caloHitBuffer.m_widths[iHit]) ||
+          !std::isfinite(caloHitBuffer.m_wirePitches[iHit]) ||
+          !std::isfinite(caloHitBuffer.m_charges[iHit]) || !std::isfinite(mips) ||
+          !std::isfinite(mips * settings.m_mips_to_gev)) {
         mf::LogWarning("LArPandora")
           << "CreatePandoraHits2D - invalid calo hit parameter provided, all assigned values must "
              "be finite, calo hit omitted "
@@ -164,27 +184,68 @@ namespace lar_pandora {
         continue;
       }
 
-      // Store the hit address
-      if (hitCounter >= settings.m_uidOffset)
-        throw cet::exception("LArPandora")
-          << "CreatePandoraHits2D - detected an excessive number of hits (" << hitCounter << ") ";
+      isValidHit[iHit] = true;
+      ++nValidHits;
+    }
 
-      idToHitMap[hitCounter] = hit;
+    if (settings.m_hitCounterOffset + static_cast<long>(nValidHits) >= settings.m_uidOffset)
+      throw cet::exception("LArPandora")
+        << "CreatePandoraHits2D - detected an excessive number of hits ("
+        << settings.m_hitCounterOffset + nValidHits << ") ";
 
-      // Create the Pandora hit
-      try {
-        PANDORA_THROW_RESULT_IF(
-          pandora::STATUS_CODE_SUCCESS,
-          !=,
-          PandoraApi::CaloHit::Create(*pPandora, caloHitParameters, caloHitFactory));
-      }
-      catch (const pandora::StatusCodeException&) {
-        mf::LogWarning("LArPandora") << "CreatePandoraHits2D - unable to create calo hit, "
-                                        "insufficient or invalid information supplied "
-                                     << std::endl;
-        continue;
+    // Create the Pandora hits, the properties shared by all hits are only set once
+    int hitCounter(settings.m_hitCounterOffset);
+    idToHitMap.Reserve(nValidHits);
+
+    lar_content::LArCaloHitFactory caloHitFactory;
+    lar_content::LArCaloHitParameters caloHitParameters;
+
+    try {
+      caloHitParameters.m_expectedDirection = pandora::CartesianVector(0., 0., 1.);
+      caloHitParameters.m_cellNormalVector = pandora::CartesianVector(0., 0., 1.);
+      caloHitParameters.m_cellSize0 = settings.m_dx_cm;
+      caloHitParameters.m_cellGeometry = pandora::RECTANGULAR;
+      caloHitParameters.m_time = 0.;
+      caloHitParameters.m_nCellRadiationLengths = settings.m_dx_cm / settings.m_rad_cm;
+      caloHitParameters.m_nCellInteractionLengths = settings.m_dx_cm / settings.m_int_cm;
+      caloHitParameters.m_isDigital = false;
+      caloHitParameters.m_hitRegion = pandora::SINGLE_REGION;
+      caloHitParameters.m_layer = 0;
+      caloHitParameters.m_isInOuterSamplingLayer = false;
+
+      for (size_t iHit = 0; iHit < nHits; ++iHit) {
+        if (!isValidHit[iHit]) continue;
+
+        const double mips(caloHitBuffer.m_mips[iHit]);
+
+        caloHitParameters.m_cellSize1 = caloHitBuffer.m_widths[iHit];
+        caloHitParameters.m_cellThickness = caloHitBuffer.m_wirePitches[iHit];
+        caloHitParameters.m_inputEnergy = caloHitBuffer.m_charges[iHit];
+        caloHitParameters.m_mipEquivalentEnergy = mips;
+        caloHitParameters.m_electromagneticEnergy = mips * settings.m_mips_to_gev;
+        caloHitParameters.m_hadronicEnergy = mips * settings.m_mips_to_gev;
+        caloHitParameters.m_pParentAddress = (void*)((intptr_t)(++hitCounter));
+        caloHitParameters.m_larTPCVolumeId = caloHitBuffer.m_larTPCVolumeIds[iHit];
+        caloHitParameters.m_daughterVolumeId = caloHitBuffer.m_daughterVolumeIds[iHit];
+        caloHitParameters.m_hitType = caloHitBuffer.m_hitTypes[iHit];
+        caloHitParameters.m_positionVector = pandora::CartesianVector(
+          caloHitBuffer.m_xPositions[iHit], 0., caloHitBuffer.m_viewPositions[iHit]);
+
+        // Store the hit address
+        idToHitMap.Add(hitCounter, caloHitBuffer.m_hits[iHit]);
+
+        if (pandora::STATUS_CODE_SUCCESS !=
+            PandoraApi::CaloHit::Create(*pPandora, caloHitParameters, caloHitFactory)) {
+          mf::LogWarning("LArPandora") << "CreatePandoraHits2D - unable to create calo hit, "
+                                          "insufficient or invalid information supplied "
+                                       << std::endl;
+        }
       }
     }
+    catch (const pandora::StatusCodeException& statusCodeException) {
+      throw cet::exception("LArPandora") << "CreatePandoraHits2D - unable to create calo hits, "
+                                         << statusCodeException.ToString();
+    }
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
@@ -332,154 +393,87 @@ namespace lar_pandora {
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandoraInput::CreatePandoraReadoutGaps(const Settings& settings,
-                                            const LArDriftVolumeMap& driftVolumeMap)
+  LArPandoraInput::LoadReadoutGaps(const Settings& settings,
+                                   const LArDriftVolumeMap& driftVolumeMap,
+                                   LArReadoutGapList& readoutGapList)
   {
-    mf::LogDebug("LArPandora") << " *** LArPandoraInput::CreatePandoraReadoutGaps(...) *** "
-                               << std::endl;
+    mf::LogDebug("LArPandora") << " *** LArPandoraInput::LoadReadoutGaps(...) *** " << std::endl;
 
     if (!settings.m_pPrimaryPandora)
       throw cet::exception("LArPandora")
-        << "CreatePandoraReadoutGaps - primary Pandora instance does not exist ";
+        << "LoadReadoutGaps - primary Pandora instance does not exist ";
 
-    const pandora::Pandora* pPandora(settings.m_pPrimaryPandora);
-
-    art::ServiceHandle<geo::Geometry const> theGeometry;
     const lariov::ChannelStatusProvider& channelStatus(
       art::ServiceHandle<lariov::ChannelStatusService const>()->GetProvider());
+    const lariov::ChannelStatusProvider::ChannelSet_t badChannels(channelStatus.BadChannels());
 
-    const bool isDualPhase(theGeometry->MaxPlanes() == 2);
-
-    for (unsigned int icstat = 0; icstat < theGeometry->Ncryostats(); ++icstat) {
-      for (unsigned int itpc = 0; itpc < theGeometry->NTPC(icstat); ++itpc) {
-        const geo::TPCGeo& TPC(theGeometry->TPC(itpc));
+    readoutGapList.clear();
 
-        for (unsigned int iplane = 0; iplane < TPC.Nplanes(); ++iplane) {
-          const geo::PlaneGeo& plane(TPC.Plane(iplane));
-          const float halfWirePitch(0.5f * theGeometry->WirePitch(plane.View()));
-          const unsigned int nWires(theGeometry->Nwires(plane.ID()));
+    if (settings.m_readoutGapCacheDirectory.empty()) {
+      LArPandoraInput::BuildReadoutGaps(settings, driftVolumeMap, badChannels, readoutGapList);
+      return;
+    }
 
-          int firstBadWire(-1), lastBadWire(-1);
+    const std::uint64_t fingerprint(
+      LArPandoraInput::GetReadoutGapFingerprint(settings, driftVolumeMap, badChannels));
 
-          for (unsigned int iwire = 0; iwire < nWires; ++iwire) {
-            const raw::ChannelID_t channel(
-              theGeometry->PlaneWireToChannel(iplane, iwire, itpc, icstat));
-            const bool isBadChannel(channelStatus.IsBad(channel));
-            const bool isLastWire(nWires == (iwire + 1));
+    const std::string fileName(LArPandoraCache::GetFileName(
+      settings.m_readoutGapCacheDirectory, "LArPandoraReadoutGaps", fingerprint));
 
-            if (isBadChannel && (firstBadWire < 0)) firstBadWire = iwire;
+    if (LArPandoraInput::ReadReadoutGaps(fileName, fingerprint, readoutGapList)) {
+      mf::LogDebug("LArPandora") << "LoadReadoutGaps - read " << readoutGapList.size()
+                                 << " readout gaps from " << fileName << std::endl;
+      return;
+    }
 
-            if (isBadChannel || isLastWire) lastBadWire = iwire;
+    readoutGapList.clear();
+    LArPandoraInput::BuildReadoutGaps(settings, driftVolumeMap, badChannels, readoutGapList);
+    LArPandoraInput::WriteReadoutGaps(fileName, fingerprint, readoutGapList);
+  }
 
-            if (isBadChannel && !isLastWire) continue;
+  //------------------------------------------------------------------------------------------------------------------------------------------
 
-            if ((firstBadWire < 0) || (lastBadWire < 0)) continue;
+  void
+  LArPandoraInput::CreatePandoraReadoutGaps(const Settings& settings,
+                                            const LArReadoutGapList& readoutGapList)
+  {
+    mf::LogDebug("LArPandora") << " *** LArPandoraInput::CreatePandoraReadoutGaps(...) *** "
+                               << std::endl;
 
-            double firstXYZ[3], lastXYZ[3];
-            theGeometry->Cryostat(icstat)
-              .TPC(itpc)
-              .Plane(iplane)
-              .Wire(firstBadWire)
-              .GetCenter(firstXYZ);
-            theGeometry->Cryostat(icstat)
-              .TPC(itpc)
-              .Plane(iplane)
-              .Wire(lastBadWire)
-              .GetCenter(lastXYZ);
+    if (!settings.m_pPrimaryPandora)
+      throw cet::exception("LArPandora")
+        << "CreatePandoraReadoutGaps - primary Pandora instance does not exist ";
 
-            firstBadWire = -1;
-            lastBadWire = -1;
+    const pandora::Pandora* pPandora(settings.m_pPrimaryPandora);
 
-            PandoraApi::Geometry::LineGap::Parameters parameters;
+    for (const LArReadoutGap& readoutGap : readoutGapList) {
+      PandoraApi::Geometry::LineGap::Parameters parameters;
 
-            try {
-              parameters.m_lineStartX = -std::numeric_limits<float>::max();
-              parameters.m_lineEndX = std::numeric_limits<float>::max();
-
-              const unsigned int volumeId(
-                LArPandoraGeometry::GetVolumeID(driftVolumeMap, icstat, itpc));
-              LArDriftVolumeMap::const_iterator volumeIter(driftVolumeMap.find(volumeId));
-
-              if (driftVolumeMap.end() != volumeIter) {
-                parameters.m_lineStartX =
-                  volumeIter->second.GetCenterX() - 0.5f * volumeIter->second.GetWidthX();
-                parameters.m_lineEndX =
-                  volumeIter->second.GetCenterX() + 0.5f * volumeIter->second.GetWidthX();
-              }
-
-              const geo::View_t iview = plane.View();
-              const geo::View_t pandoraView(LArPandoraGeometry::GetGlobalView(icstat, itpc, iview));
-
-              if (isDualPhase) {
-                if (pandoraView == geo::kW || pandoraView == geo::kZ) {
-                  const float firstW(firstXYZ[2]);
-                  const float lastW(lastXYZ[2]);
-
-                  parameters.m_lineGapType = pandora::TPC_WIRE_GAP_VIEW_U;
-                  parameters.m_lineStartZ = std::min(firstW, lastW) - halfWirePitch;
-                  parameters.m_lineEndZ = std::max(firstW, lastW) + halfWirePitch;
-                }
-                else if (pandoraView == geo::kY) {
-                  const float firstY(firstXYZ[1]);
-                  const float lastY(lastXYZ[1]);
-
-                  parameters.m_lineGapType = pandora::TPC_WIRE_GAP_VIEW_V;
-                  parameters.m_lineStartZ = std::min(firstY, lastY) - halfWirePitch;
-                  parameters.m_lineEndZ = std::max(firstY, lastY) + halfWirePitch;
-                }
-              }
-              else {
-                if (pandoraView == geo::kW || pandoraView == geo::kY) {
-                  const float firstW(firstXYZ[2]);
-                  const float lastW(lastXYZ[2]);
-
-                  parameters.m_lineGapType = pandora::TPC_WIRE_GAP_VIEW_W;
-                  parameters.m_lineStartZ = std::min(firstW, lastW) - halfWirePitch;
-                  parameters.m_lineEndZ = std::max(firstW, lastW) + halfWirePitch;
-                }
-                else if (pandoraView == geo::kU) {
-                  const float firstU(pPandora->GetPlugins()->GetLArTransformationPlugin()->YZtoU(
-                    firstXYZ[1], firstXYZ[2]));
-                  const float lastU(pPandora->GetPlugins()->GetLArTransformationPlugin()->YZtoU(
-                    lastXYZ[1], lastXYZ[2]));
-
-                  parameters.m_lineGapType = pandora::TPC_WIRE_GAP_VIEW_U;
-                  parameters.m_lineStartZ = std::min(firstU, lastU) - halfWirePitch;
-                  parameters.m_lineEndZ = std::max(firstU, lastU) + halfWirePitch;
-                }
-                else if (pandoraView == geo::kV) {
-                  const float firstV(pPandora->GetPlugins()->GetLArTransformationPlugin()->YZtoV(
-                    firstXYZ[1], firstXYZ[2]));
-                  const float lastV(pPandora->GetPlugins()->GetLArTransformationPlugin()->YZtoV(
-                    lastXYZ[1], lastXYZ[2]));
-
-                  parameters.m_lineGapType = pandora::TPC_WIRE_GAP_VIEW_V;
-                  parameters.m_lineStartZ = std::min(firstV, lastV) - halfWirePitch;
-                  parameters.m_lineEndZ = std::max(firstV, lastV) + halfWirePitch;
-                }
-              }
-            }
-            catch (const pandora::StatusCodeException&) {
-              mf::LogWarning("LArPandora")
-                << "CreatePandoraReadoutGaps - invalid line gap parameter provided, all assigned "
-                   "values must be finite, line gap omitted "
-                << std::endl;
-              continue;
-            }
+      try {
+        parameters.m_lineGapType = readoutGap.GetLineGapType();
+        parameters.m_lineStartX = readoutGap.GetLineStartX();
+        parameters.m_lineEndX = readoutGap.GetLineEndX();
+        parameters.m_lineStartZ = readoutGap.GetLineStartZ();
+        parameters.m_lineEndZ = readoutGap.GetLineEndZ();
+      }
+      catch (const pandora::StatusCodeException&) {
+        mf::LogWarning("LArPandora")
+          << "CreatePandoraReadoutGaps - invalid line gap parameter provided, all assigned "
+             "values must be finite, line gap omitted "
+          << std::endl;
+        continue;
+      }
 
-            try {
-              PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS,
-                                      !=,
-                                      PandoraApi::Geometry::LineGap::Create(*pPandora, parameters));
-            }
-            catch (const pandora::StatusCodeException&) {
-              mf::LogWarning("LArPandora") << "CreatePandoraReadoutGaps - unable to create line "
-                                              "gap, insufficient or invalid information supplied "
-                                           << std::endl;
-              continue;
-            }
-          }
-        }
+      try {
+        PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS,
+                                !=,
+                                PandoraApi::Geometry::LineGap::Create(*pPandora, parameters));
+      }
+      catch (const pandora::StatusCodeException&) {
+        mf::LogWarning("LArPandora") << "CreatePandoraReadoutGaps - unable to create line "
+                                        "gap, insufficient or invalid information supplied "
+                                     << std::endl;
+        continue;
       }
     }
   }
@@ -488,30 +482,25 @@ namespace lar_pandora {
 
   void
   LArPandoraInput::CreatePandoraMCParticles(const Settings& settings,
+                                            const LArTPCBoxIndex& tpcBoxIndex,
                                             const MCTruthToMCParticles& truthToParticleMap,
-                                            const MCParticlesToMCTruth& particleToTruthMap,
                                             const RawMCParticleVector& generatorMCParticleVector)
   {
     mf::LogDebug("LArPandora") << " *** LArPandoraInput::CreatePandoraMCParticles(...) *** "
                                << std::endl;
-    art::ServiceHandle<cheat::ParticleInventoryService const> particleInventoryService;
 
     if (!settings.m_pPrimaryPandora)
       throw cet::exception("LArPandora")
         << "CreatePandoraMCParticles - primary Pandora instance does not exist ";
 
-    const pandora::Pandora* pPandora(settings.m_pPrimaryPandora);
+    if (tpcBoxIndex.IsEmpty())
+      throw cet::exception("LArPandora")
+        << "CreatePandoraMCParticles - the tpc box index has not been loaded ";
 
-    // Make indexed list of MC particles
-    MCParticleMap particleMap;
+    const pandora::Pandora* pPandora(settings.m_pPrimaryPandora);
 
-    for (MCParticlesToMCTruth::const_iterator iter = particleToTruthMap.begin(),
-                                              iterEnd = particleToTruthMap.end();
-         iter != iterEnd;
-         ++iter) {
-      const art::Ptr<simb::MCParticle> particle = iter->first;
-      particleMap[particle->TrackId()] = particle;
-    }
+    // Make indexed list of MC particles, with their origins and whether they match primary generator particles
+    const LArPandoraMCParticleIndex particleIndex(truthToParticleMap, generatorMCParticleVector);
 
     // Loop over MC truth objects
     int neutrinoCounter(0);
@@ -608,18 +597,9 @@ namespace lar_pandora {
     // Loop over G4 particles
     int particleCounter(0);
 
-    // Find Primary Generator Particles
-    std::map<const simb::MCParticle, bool> primaryGeneratorMCParticleMap;
-    LArPandoraInput::FindPrimaryParticles(generatorMCParticleVector, primaryGeneratorMCParticleMap);
-
-    for (MCParticleMap::const_iterator iterI = particleMap.begin(), iterEndI = particleMap.end();
-         iterI != iterEndI;
-         ++iterI) {
-      const art::Ptr<simb::MCParticle> particle = iterI->second;
-
-      if (particle->TrackId() != iterI->first)
-        throw cet::exception("LArPandora") << "CreatePandoraMCParticles - mc truth information "
-                                              "appears to be scrambled in this event";
+    for (size_t particleIndexI = 0; particleIndexI < particleIndex.GetNParticles();
+         ++particleIndexI) {
+      const art::Ptr<simb::MCParticle>& particle = particleIndex.GetParticle(particleIndexI);
 
       if (particle->TrackId() >= settings.m_uidOffset)
         throw cet::exception("LArPandora")
@@ -630,7 +610,7 @@ namespace lar_pandora {
 
       // Find start and end trajectory points
       int firstT(-1), lastT(-1);
-      LArPandoraInput::GetTrueStartAndEndPoints(settings, particle, firstT, lastT);
+      LArPandoraInput::GetTrueStartAndEndPoints(tpcBoxIndex, particle, firstT, lastT);
 
       if (firstT < 0 && lastT < 0) {
         firstT = 0;
@@ -653,10 +633,9 @@ namespace lar_pandora {
 
       // Find the source of the mc particle
       int nuanceCode(0);
-      const int trackID(particle->TrackId());
-      const simb::Origin_t origin(particleInventoryService->TrackIdToMCTruth(trackID).Origin());
+      const simb::Origin_t origin(particleIndex.GetOrigin(particleIndexI));
 
-      if (LArPandoraInput::IsPrimaryMCParticle(particle, primaryGeneratorMCParticleMap)) {
+      if (particleIndex.IsPrimary(particleIndexI)) {
         nuanceCode = 2001;
       }
       else if (simb::kCosmicRay == origin) {
@@ -702,9 +681,9 @@ namespace lar_pandora {
 
       // Create Mother/Daughter Links between 3D MC Particles
       const int id_mother(particle->Mother());
-      MCParticleMap::const_iterator iterJ = particleMap.find(id_mother);
+      size_t particleIndexJ(0);
 
-      if (iterJ != particleMap.end()) {
+      if (particleIndex.FindTrackID(id_mother, particleIndexJ)) {
         try {
           PANDORA_THROW_RESULT_IF(
             pandora::STATUS_CODE_SUCCESS,
@@ -726,44 +705,6 @@ namespace lar_pandora {
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
-  void
-  LArPandoraInput::FindPrimaryParticles(
-    const RawMCParticleVector& mcParticleVector,
-    std::map<const simb::MCParticle, bool>& primaryMCParticleMap)
-  {
-    for (const simb::MCParticle& mcParticle : mcParticleVector) {
-      if ("primary" == mcParticle.Process()) {
-        primaryMCParticleMap.emplace(std::make_pair(mcParticle, false));
-      }
-    }
-  }
-
-  //------------------------------------------------------------------------------------------------------------------------------------------
-
-  bool
-  LArPandoraInput::IsPrimaryMCParticle(const art::Ptr<simb::MCParticle>& mcParticle,
-                                       std::map<const simb::MCParticle, bool>& primaryMCParticleMap)
-  {
-    for (auto& mcParticleIter : primaryMCParticleMap) {
-      if (!mcParticleIter.second) {
-        const simb::MCParticle primaryMCParticle(mcParticleIter.first);
-
-        if (std::fabs(primaryMCParticle.Px() - mcParticle->Px()) <
-              std::numeric_limits<double>::epsilon() &&
-            std::fabs(primaryMCParticle.Py() - mcParticle->Py()) <
-              std::numeric_limits<double>::epsilon() &&
-            std::fabs(primaryMCParticle.Pz() - mcParticle->Pz()) <
-              std::numeric_limits<double>::epsilon()) {
-          mcParticleIter.second = true;
-          return true;
-        }
-      }
-    }
-    return false;
-  }
-
-  //------------------------------------------------------------------------------------------------------------------------------------------
-
   void
   LArPandoraInput::CreatePandoraMCLinks2D(const Settings& settings,
                                           const IdToHitMap& idToHitMap,
@@ -778,11 +719,11 @@ namespace lar_pandora {
 
     const pandora::Pandora* pPandora(settings.m_pPrimaryPandora);
 
-    for (IdToHitMap::const_iterator iterI = idToHitMap.begin(), iterEndI = idToHitMap.end();
-         iterI != iterEndI;
-         ++iterI) {
-      const int hitID(iterI->first);
-      const art::Ptr<recob::Hit> hit(iterI->second);
+    for (int hitID = idToHitMap.GetFirstId(), endHitID = idToHitMap.GetEndId(); hitID != endHitID;
+         ++hitID) {
+      if (!idToHitMap.Contains(hitID)) continue;
+
+      const art::Ptr<recob::Hit>& hit(idToHitMap.GetHit(hitID));
       //  const geo::WireID hit_WireID(hit->WireID());
 
       // Get list of associated MC particles
@@ -822,57 +763,266 @@ namespace lar_pandora {
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandoraInput::GetTrueStartAndEndPoints(const Settings& settings,
-                                            const art::Ptr<simb::MCParticle>& particle,
-                                            int& firstT,
-                                            int& lastT)
+  LArPandoraInput::BuildReadoutGaps(const Settings& settings,
+                                    const LArDriftVolumeMap& driftVolumeMap,
+                                    const lariov::ChannelStatusProvider::ChannelSet_t& badChannels,
+                                    LArReadoutGapList& readoutGapList)
+  {
+    art::ServiceHandle<geo::Geometry const> theGeometry;
+    const pandora::LArTransformationPlugin* const pTransformationPlugin(
+      settings.m_pPrimaryPandora->GetPlugins()->GetLArTransformationPlugin());
+
+    const bool isDualPhase(theGeometry->MaxPlanes() == 2);
+
+    // Collect the bad wires on each plane from the set of bad channels, rather than checking the status of every wire
+    std::map<geo::PlaneID, std::vector<unsigned int>> planeToBadWires;
+
+    for (const raw::ChannelID_t channel : badChannels) {
+      if (!theGeometry->HasChannel(channel)) continue;
+
+      for (const geo::WireID& wireID : theGeometry->ChannelToWire(channel))
+        planeToBadWires[wireID.planeID()].push_back(wireID.Wire);
+    }
+
+    for (auto& planeAndBadWires : planeToBadWires) {
+      const geo::PlaneID& planeID(planeAndBadWires.first);
+      std::vector<unsigned int>& badWires(planeAndBadWires.second);
+      std::sort(badWires.begin(), badWires.end());
+      badWires.erase(std::unique(badWires.begin(), badWires.end()), badWires.end());
+
+      const geo::PlaneGeo& plane(theGeometry->Plane(planeID));
+      const float halfWirePitch(0.5f * theGeometry->WirePitch(plane.View()));
+      const unsigned int nWires(theGeometry->Nwires(planeID));
+
+      float lineStartX(-std::numeric_limits<float>::max());
+      float lineEndX(std::numeric_limits<float>::max());
+
+      const unsigned int volumeId(
+        LArPandoraGeometry::GetVolumeID(driftVolumeMap, planeID.Cryostat, planeID.TPC));
+      LArDriftVolumeMap::const_iterator volumeIter(driftVolumeMap.find(volumeId));
+
+      if (driftVolumeMap.end() != volumeIter) {
+        lineStartX = volumeIter->second.GetCenterX() - 0.5f * volumeIter->second.GetWidthX();
+        lineEndX = volumeIter->second.GetCenterX() + 0.5f * volumeIter->second.GetWidthX();
+      }
+
+      const geo::View_t pandoraView(
+        LArPandoraGeometry::GetGlobalView(planeID.Cryostat, planeID.TPC, plane.View()));
+
+      for (size_t iRun = 0; iRun < badWires.size();) {
+        size_t iRunEnd(iRun);
+
+        while ((iRunEnd + 1 < badWires.size()) && (badWires[iRunEnd + 1] == badWires[iRunEnd] + 1))
+          ++iRunEnd;
+
+        const unsigned int firstBadWire(badWires[iRun]);
+        unsigned int lastBadWire(badWires[iRunEnd]);
+        iRun = iRunEnd + 1;
+
+        // ATTN A run ending on the penultimate wire is extended to the last wire, as for the original wire-by-wire scan
+        if (lastBadWire + 2 == nWires) lastBadWire = nWires - 1;
+
+        double firstXYZ[3], lastXYZ[3];
+        plane.Wire(firstBadWire).GetCenter(firstXYZ);
+        plane.Wire(lastBadWire).GetCenter(lastXYZ);
+
+        pandora::LineGapType lineGapType(pandora::TPC_WIRE_GAP_VIEW_U);
+        float first(0.f), last(0.f);
+
+        if (isDualPhase) {
+          if (pandoraView == geo::kW || pandoraView == geo::kZ) {
+            lineGapType = pandora::TPC_WIRE_GAP_VIEW_U;
+            first = firstXYZ[2];
+            last = lastXYZ[2];
+          }
+          else if (pandoraView == geo::kY) {
+            lineGapType = pandora::TPC_WIRE_GAP_VIEW_V;
+            first = firstXYZ[1];
+            last = lastXYZ[1];
+          }
+          else {
+            continue;
+          }
+        }
+        else {
+          if (pandoraView == geo::kW || pandoraView == geo::kY) {
+            lineGapType = pandora::TPC_WIRE_GAP_VIEW_W;
+            first = firstXYZ[2];
+            last = lastXYZ[2];
+          }
+          else if (pandoraView == geo::kU) {
+            lineGapType = pandora::TPC_WIRE_GAP_VIEW_U;
+            first = pTransformationPlugin->YZtoU(firstXYZ[1], firstXYZ[2]);
+            last = pTransformationPlugin->YZtoU(lastXYZ[1], lastXYZ[2]);
+          }
+          else if (pandoraView == geo::kV) {
+            lineGapType = pandora::TPC_WIRE_GAP_VIEW_V;
+            first = pTransformationPlugin->YZtoV(firstXYZ[1], firstXYZ[2]);
+            last = pTransformationPlugin->YZtoV(lastXYZ[1], lastXYZ[2]);
+          }
+          else {
+            continue;
+          }
+        }
+
+        readoutGapList.emplace_back(lineGapType,
+                                    lineStartX,
+                                    lineEndX,
+                                    std::min(first, last) - halfWirePitch,
+                                    std::max(first, last) + halfWirePitch);
+      }
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  std::uint64_t
+  LArPandoraInput::GetReadoutGapFingerprint(
+    const Settings& settings,
+    const LArDriftVolumeMap& driftVolumeMap,
+    const lariov::ChannelStatusProvider::ChannelSet_t& badChannels)
   {
     art::ServiceHandle<geo::Geometry const> theGeometry;
-    firstT = -1;
-    lastT = -1;
+    const pandora::LArTransformationPlugin* const pTransformationPlugin(
+      settings.m_pPrimaryPandora->GetPlugins()->GetLArTransformationPlugin());
+
+    LArPandoraFingerprint fingerprint;
+    fingerprint.AddString(theGeometry->DetectorName());
+    fingerprint.AddValue(theGeometry->MaxPlanes());
+
+    for (const float yz : {0.f, 1.f}) {
+      fingerprint.AddValue(pTransformationPlugin->YZtoU(yz, 1.f - yz));
+      fingerprint.AddValue(pTransformationPlugin->YZtoV(yz, 1.f - yz));
+    }
+
+    for (const geo::PlaneID& planeID : theGeometry->IteratePlaneIDs()) {
+      const geo::PlaneGeo& plane(theGeometry->Plane(planeID));
+      const unsigned int nWires(theGeometry->Nwires(planeID));
+
+      fingerprint.AddValue(planeID.Cryostat);
+      fingerprint.AddValue(planeID.TPC);
+      fingerprint.AddValue(planeID.Plane);
+      fingerprint.AddValue(nWires);
+      fingerprint.AddValue(plane.View());
+      fingerprint.AddValue(theGeometry->WirePitch(plane.View()));
+
+      if (nWires > 0) {
+        double firstXYZ[3], lastXYZ[3];
+        plane.Wire(0).GetCenter(firstXYZ);
+        plane.Wire(nWires - 1).GetCenter(lastXYZ);
+        fingerprint.AddBytes(firstXYZ, sizeof(firstXYZ));
+        fingerprint.AddBytes(lastXYZ, sizeof(lastXYZ));
+      }
+    }
+
+    for (const LArDriftVolumeMap::value_type& mapEntry : driftVolumeMap) {
+      fingerprint.AddValue(mapEntry.first);
+      fingerprint.AddValue(mapEntry.second.GetCenterX());
+      fingerprint.AddValue(mapEntry.second.GetWidthX());
+    }
+
+    for (const raw::ChannelID_t channel : badChannels)
+      fingerprint.AddValue(channel);
+
+    return fingerprint.GetValue();
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
 
-    for (unsigned int icstat = 0; icstat < theGeometry->Ncryostats(); ++icstat) {
-      for (unsigned int itpc = 0; itpc < theGeometry->NTPC(icstat); ++itpc) {
-        int thisfirstT(-1), thislastT(-1);
-        LArPandoraInput::GetTrueStartAndEndPoints(icstat, itpc, particle, thisfirstT, thislastT);
+  bool
+  LArPandoraInput::ReadReadoutGaps(const std::string& fileName,
+                                   const std::uint64_t fingerprint,
+                                   LArReadoutGapList& readoutGapList)
+  {
+    std::ifstream inputFile(fileName);
+
+    if (!inputFile) return false;
+
+    size_t nGaps(0);
 
-        if (thisfirstT < 0) continue;
+    if (!LArPandoraCache::ReadHeader(inputFile, "LArPandoraReadoutGaps", fingerprint) ||
+        !(inputFile >> nGaps)) {
+      mf::LogWarning("LArPandora") << "ReadReadoutGaps - ignoring invalid readout gap table "
+                                   << fileName << std::endl;
+      return false;
+    }
+
+    LArReadoutGapList fileGapList;
+    fileGapList.reserve(nGaps);
 
-        if (firstT < 0 || thisfirstT < firstT) firstT = thisfirstT;
+    for (size_t iGap = 0; iGap < nGaps; ++iGap) {
+      int lineGapType(0);
+      float lineStartX(0.f), lineEndX(0.f), lineStartZ(0.f), lineEndZ(0.f);
 
-        if (lastT < 0 || thislastT > lastT) lastT = thislastT;
+      if (!(inputFile >> lineGapType >> lineStartX >> lineEndX >> lineStartZ >> lineEndZ)) {
+        mf::LogWarning("LArPandora")
+          << "ReadReadoutGaps - ignoring truncated readout gap table " << fileName << std::endl;
+        return false;
       }
+
+      fileGapList.emplace_back(static_cast<pandora::LineGapType>(lineGapType),
+                               lineStartX,
+                               lineEndX,
+                               lineStartZ,
+                               lineEndZ);
     }
+
+    readoutGapList.swap(fileGapList);
+    return true;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraInput::WriteReadoutGaps(const std::string& fileName,
+                                    const std::uint64_t fingerprint,
+                                    const LArReadoutGapList& readoutGapList)
+  {
+    auto writeContents = [&readoutGapList](std::ostream& outputFile) {
+      outputFile << readoutGapList.size() << "\n";
+
+      for (const LArReadoutGap& readoutGap : readoutGapList) {
+        outputFile << static_cast<int>(readoutGap.GetLineGapType()) << " "
+                   << readoutGap.GetLineStartX() << " " << readoutGap.GetLineEndX() << " "
+                   << readoutGap.GetLineStartZ() << " " << readoutGap.GetLineEndZ() << "\n";
+      }
+    };
+
+    if (LArPandoraCache::WriteFile(fileName, "LArPandoraReadoutGaps", fingerprint, writeContents))
+      return;
+
+    mf::LogWarning("LArPandora") << "WriteReadoutGaps - unable to write readout gap table "
+                                 << fileName << std::endl;
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandoraInput::GetTrueStartAndEndPoints(const unsigned int cstat,
-                                            const unsigned int tpc,
+  LArPandoraInput::GetTrueStartAndEndPoints(const LArTPCBoxIndex& tpcBoxIndex,
                                             const art::Ptr<simb::MCParticle>& particle,
                                             int& startT,
                                             int& endT)
   {
-    art::ServiceHandle<geo::Geometry const> theGeometry;
+    startT = -1;
+    endT = -1;
 
-    bool foundStartPosition(false);
     const int numTrajectoryPoints(static_cast<int>(particle->NumberTrajectoryPoints()));
 
     for (int nt = 0; nt < numTrajectoryPoints; ++nt) {
-      const double pos[3] = {particle->Vx(nt), particle->Vy(nt), particle->Vz(nt)};
-      geo::TPCID tpcID = theGeometry->FindTPCAtPosition(pos);
+      if (!tpcBoxIndex.IsInsideTPC(particle->Vx(nt), particle->Vy(nt), particle->Vz(nt))) continue;
 
-      if (!tpcID.isValid) continue;
+      startT = nt;
+      break;
+    }
 
-      if (!(cstat == tpcID.Cryostat && tpc == tpcID.TPC)) continue;
+    if (startT < 0) return;
 
-      endT = nt;
+    // ATTN The last point inside the detector is found searching backwards, so each point is tested at most once
+    for (int nt = numTrajectoryPoints - 1; nt >= startT; --nt) {
+      if (!tpcBoxIndex.IsInsideTPC(particle->Vx(nt), particle->Vy(nt), particle->Vz(nt))) continue;
 
-      if (!foundStartPosition) {
-        startT = endT;
-        foundStartPosition = true;
-      }
+      endT = nt;
+      break;
     }
   }
 
@@ -904,33 +1054,130 @@ namespace lar_pandora {
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
-  double
-  LArPandoraInput::GetMips(detinfo::DetectorPropertiesData const& detProp,
-                           const Settings& settings,
-                           const double hit_Charge,
-                           const geo::View_t hit_View)
+  void
+  LArPandoraInput::ConvertTicksToX(const Settings& settings,
+                                   const std::vector<double>& peakTimes,
+                                   const std::vector<double>& startTimes,
+                                   const std::vector<double>& endTimes,
+                                   const std::vector<double>& xOffsets,
+                                   const std::vector<double>& xCoefficients,
+                                   std::vector<double>& xPositions,
+                                   std::vector<double>& widths)
   {
-    art::ServiceHandle<geo::Geometry const> theGeometry;
+    const size_t nHits(peakTimes.size());
+    xPositions.resize(nHits);
+    widths.resize(nHits);
+
+    // ATTN Plain loops over contiguous arrays, with no function calls, so that the compiler can vectorise them
+    const double* const pPeakTimes(peakTimes.data());
+    const double* const pStartTimes(startTimes.data());
+    const double* const pEndTimes(endTimes.data());
+    const double* const pXOffsets(xOffsets.data());
+    const double* const pXCoefficients(xCoefficients.data());
+    double* const pXPositions(xPositions.data());
+    double* const pWidths(widths.data());
+
+    for (size_t iHit = 0; iHit < nHits; ++iHit)
+      pXPositions[iHit] = pXOffsets[iHit] + pXCoefficients[iHit] * pPeakTimes[iHit];
+
+    if (settings.m_useHitWidths) {
+      for (size_t iHit = 0; iHit < nHits; ++iHit)
+        pWidths[iHit] = std::fabs(pXCoefficients[iHit] * (pEndTimes[iHit] - pStartTimes[iHit]));
+    }
+    else {
+      for (size_t iHit = 0; iHit < nHits; ++iHit)
+        pWidths[iHit] = settings.m_dx_cm;
+    }
+  }
 
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraInput::GetMips(const detinfo::DetectorPropertiesData& detProp,
+                           const Settings& settings,
+                           const std::vector<double>& charges,
+                           const std::vector<double>& wirePitches,
+                           std::vector<double>& mips)
+  {
     // TODO: Unite this procedure with other calorimetry procedures under development
-    const double dQdX(hit_Charge / (theGeometry->WirePitch(hit_View))); // ADC/cm
-    const double dQdX_e(dQdX /
-                        (detProp.ElectronsToADC() * settings.m_recombination_factor)); // e/cm
-    const double dEdX(settings.m_useBirksCorrection ?
-                        detProp.BirksCorrection(dQdX_e) :
-                        dQdX_e * 1000. / util::kGeVToElectrons); // MeV/cm
-    double mips(dEdX / settings.m_dEdX_mip);
+    LArPandoraInput::GetdQdX(settings, detProp.ElectronsToADC(), charges, wirePitches, mips);
+
+    const size_t nHits(mips.size());
+    double* const pMips(mips.data());
+
+    // dEdX in MeV/cm
+    if (settings.m_useBirksCorrection) {
+      for (size_t iHit = 0; iHit < nHits; ++iHit)
+        pMips[iHit] = detProp.BirksCorrection(pMips[iHit]);
+    }
+    else {
+      for (size_t iHit = 0; iHit < nHits; ++iHit)
+        pMips[iHit] = pMips[iHit] * 1000. / util::kGeVToElectrons;
+    }
+
+    LArPandoraInput::ConvertdEdXToMips(settings, mips);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraInput::GetdQdX(const Settings& settings,
+                           const double electronsToADC,
+                           const std::vector<double>& charges,
+                           const std::vector<double>& wirePitches,
+                           std::vector<double>& dQdXs)
+  {
+    const size_t nHits(charges.size());
+    dQdXs.resize(nHits);
+
+    const double adcPerElectron(electronsToADC * settings.m_recombination_factor);
+    const double* const pCharges(charges.data());
+    const double* const pWirePitches(wirePitches.data());
+    double* const pdQdXs(dQdXs.data());
+
+    for (size_t iHit = 0; iHit < nHits; ++iHit)
+      pdQdXs[iHit] = (pCharges[iHit] / pWirePitches[iHit]) / adcPerElectron;
+  }
 
-    if (mips < 0.) mips = settings.m_mips_if_negative;
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraInput::ConvertdEdXToMips(const Settings& settings, std::vector<double>& values)
+  {
+    const size_t nHits(values.size());
+    double* const pValues(values.data());
 
-    if (mips > settings.m_mips_max) mips = settings.m_mips_max;
+    const double dEdXMip(settings.m_dEdX_mip);
+    const double mipsIfNegative(settings.m_mips_if_negative);
+    const double mipsMax(settings.m_mips_max);
 
-    return mips;
+    for (size_t iHit = 0; iHit < nHits; ++iHit) {
+      const double hitMips(pValues[iHit] / dEdXMip);
+      const double positiveMips(hitMips < 0. ? mipsIfNegative : hitMips);
+      pValues[iHit] = (positiveMips > mipsMax ? mipsMax : positiveMips);
+    }
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
   //------------------------------------------------------------------------------------------------------------------------------------------
 
+  void
+  LArPandoraInput::CaloHitBuffer::Reserve(const size_t nHits)
+  {
+    m_hits.reserve(nHits);
+    m_hitTypes.reserve(nHits);
+    m_xPositions.reserve(nHits);
+    m_viewPositions.reserve(nHits);
+    m_widths.reserve(nHits);
+    m_wirePitches.reserve(nHits);
+    m_charges.reserve(nHits);
+    m_mips.reserve(nHits);
+    m_larTPCVolumeIds.reserve(nHits);
+    m_daughterVolumeIds.reserve(nHits);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
   LArPandoraInput::Settings::Settings()
     : m_pPrimaryPandora(nullptr)
     , m_useHitWidths(true)
@@ -945,6 +1192,7 @@ namespace lar_pandora {
     , m_mips_if_negative(0.)
     , m_mips_to_gev(3.5e-4)
     , m_recombination_factor(0.63)
+    , m_readoutGapCacheDirectory("")
   {}
 
 } // namespace lar_pandora
@@ -12,12 +12,77 @@ namespace detinfo {
   class DetectorPropertiesData;
 }
 
+#include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h"
+
+#include "Pandora/PandoraEnumeratedTypes.h"
+
 #include "larpandora/LArPandoraInterface/ILArPandora.h"
 #include "larpandora/LArPandoraInterface/LArPandoraGeometry.h"
 #include "larpandora/LArPandoraInterface/LArPandoraHelper.h"
 
+#include <cstdint>
+#include <string>
+
 namespace lar_pandora {
 
+  /**
+ *  @brief  readout gap class to hold the extent of a continuous region of bad channels, in the coordinates of a pandora view
+ */
+  class LArReadoutGap {
+  public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  lineGapType the line gap type, identifying the pandora view
+     *  @param  lineStartX the lower X coordinate
+     *  @param  lineEndX the upper X coordinate
+     *  @param  lineStartZ the lower coordinate in the pandora view
+     *  @param  lineEndZ the upper coordinate in the pandora view
+     */
+    LArReadoutGap(const pandora::LineGapType lineGapType,
+                  const float lineStartX,
+                  const float lineEndX,
+                  const float lineStartZ,
+                  const float lineEndZ);
+
+    /**
+     *  @brief Get the line gap type
+     */
+    pandora::LineGapType GetLineGapType() const;
+
+    /**
+     *  @brief Get the lower X coordinate
+     */
+    float GetLineStartX() const;
+
+    /**
+     *  @brief Get the upper X coordinate
+     */
+    float GetLineEndX() const;
+
+    /**
+     *  @brief Get the lower coordinate in the pandora view
+     */
+    float GetLineStartZ() const;
+
+    /**
+     *  @brief Get the upper coordinate in the pandora view
+     */
+    float GetLineEndZ() const;
+
+  private:
+    pandora::LineGapType m_lineGapType;
+    float m_lineStartX;
+    float m_lineEndX;
+    float m_lineStartZ;
+    float m_lineEndZ;
+  };
+
+  typedef std::vector<LArReadoutGap> LArReadoutGapList;
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
   /**
  *  @brief  LArPandoraInput class
  */
@@ -46,6 +111,7 @@ namespace lar_pandora {
       double m_mips_if_negative;                 ///<
       double m_mips_to_gev;                      ///<
       double m_recombination_factor;             ///<
+      std::string m_readoutGapCacheDirectory; ///< Directory holding cached readout gap tables, empty to disable
     };
 
     /**
@@ -53,13 +119,13 @@ namespace lar_pandora {
      *
      *  @param  evt art event being processed
      *  @param  settings the settings
-     *  @param  driftVolumeMap the mapping from volume id to drift volume
+     *  @param  wireGeometryTable the cached per-wire geometry
      *  @param  hits the input list of ART hits for this event
      *  @param  idToHitMap to receive the mapping from Pandora hit ID to ART hit
      */
     static void CreatePandoraHits2D(const art::Event& evt,
                                     const Settings& settings,
-                                    const LArDriftVolumeMap& driftVolumeMap,
+                                    const LArWireGeometryTable& wireGeometryTable,
                                     const HitVector& hitVector,
                                     IdToHitMap& idToHitMap);
 
@@ -84,80 +150,195 @@ namespace lar_pandora {
                                           const LArDetectorGapList& listOfGaps);
 
     /**
-     *  @brief  Create pandora line gaps to cover any (continuous regions of) bad channels
+     *  @brief  Load the readout gaps covering any (continuous regions of) bad channels, using the cached gap table if
+     *          the fingerprint of the geometry and bad channel set matches
      *
      *  @param  settings the settings
      *  @param  driftVolumeMap the mapping from volume id to drift volume
+     *  @param  readoutGapList to receive the list of readout gaps
+     */
+    static void LoadReadoutGaps(const Settings& settings,
+                                const LArDriftVolumeMap& driftVolumeMap,
+                                LArReadoutGapList& readoutGapList);
+
+    /**
+     *  @brief  Create pandora line gaps to cover any (continuous regions of) bad channels
+     *
+     *  @param  settings the settings
+     *  @param  readoutGapList the list of readout gaps
      */
     static void CreatePandoraReadoutGaps(const Settings& settings,
-                                         const LArDriftVolumeMap& driftVolumeMap);
+                                         const LArReadoutGapList& readoutGapList);
 
     /**
      *  @brief  Create the Pandora MC particles from the MC particles
      *
      *  @param  settings the settings
+     *  @param  tpcBoxIndex the index of tpc bounding boxes
      *  @param  truthToParticles  mapping from MC truth to MC particles
-     *  @param  particlesToTruth  mapping from MC particles to MC truth
+     *  @param  generatorMCParticleVector the generator MC particles
      */
     static void CreatePandoraMCParticles(const Settings& settings,
+                                         const LArTPCBoxIndex& tpcBoxIndex,
                                          const MCTruthToMCParticles& truthToParticles,
-                                         const MCParticlesToMCTruth& particlesToTruth,
                                          const RawMCParticleVector& generatorMCParticleVector);
 
     /**
-     *  @brief Find all primary MCParticles in a given vector of MCParticles
+     *  @brief  Create links between the 2D hits and Pandora MC particles
      *
-     *  @param mcParticleVector vector of all MCParticles to consider
-     *  @param primaryMCParticleMap map containing primary MCParticles and bool indicating whether particle has been accounted for
+     *  @param  settings the settings
+     *  @param  hitMap mapping from Pandora hit addresses to ART hits
+     *  @param  hitToParticleMap mapping from each ART hit to its underlying G4 track ID
      */
-    static void FindPrimaryParticles(const RawMCParticleVector& mcParticleVector,
-                                     std::map<const simb::MCParticle, bool>& primaryMCParticleMap);
+    static void CreatePandoraMCLinks2D(const Settings& settings,
+                                       const HitMap& hitMap,
+                                       const HitsToTrackIDEs& hitToParticleMap);
 
     /**
-     *  @brief Check whether an MCParticle can be found in a given map
+     *  @brief  Convert hit times in ticks to drift coordinates and widths, using the tick to X conversion of the plane of
+     *          each hit, which is affine in ticks
      *
-     *  @param mcParticle target MCParticle
-     *  @param primaryMCParticleMap map containing primary MCParticles and bool indicating whether particle has been accounted for
+     *  @param  settings the settings
+     *  @param  peakTimes the hit peak times
+     *  @param  startTimes the hit start times (peak time minus rms)
+     *  @param  endTimes the hit end times (peak time plus rms)
+     *  @param  xOffsets the drift coordinate at zero ticks, for the plane of each hit
+     *  @param  xCoefficients the change in drift coordinate per tick, for the plane of each hit
+     *  @param  xPositions to receive the drift coordinates
+     *  @param  widths to receive the drift coordinate widths
      */
-    static bool IsPrimaryMCParticle(const art::Ptr<simb::MCParticle>& mcParticle,
-                                    std::map<const simb::MCParticle, bool>& primaryMCParticleMap);
+    static void ConvertTicksToX(const Settings& settings,
+                                const std::vector<double>& peakTimes,
+                                const std::vector<double>& startTimes,
+                                const std::vector<double>& endTimes,
+                                const std::vector<double>& xOffsets,
+                                const std::vector<double>& xCoefficients,
+                                std::vector<double>& xPositions,
+                                std::vector<double>& widths);
 
     /**
-     *  @brief  Create links between the 2D hits and Pandora MC particles
+     *  @brief  Convert hit charges in ADCs to approximate MIPs, using GetdQdX and ConvertdEdXToMips either side of the
+     *          conversion to energy
      *
+     *  @param  detProp the detector properties for the event
      *  @param  settings the settings
-     *  @param  hitMap mapping from Pandora hit addresses to ART hits
-     *  @param  hitToParticleMap mapping from each ART hit to its underlying G4 track ID
+     *  @param  charges the hit charges
+     *  @param  wirePitches the wire pitches of the hit views
+     *  @param  mips to receive the MIP equivalent energies
      */
-    static void CreatePandoraMCLinks2D(const Settings& settings,
-                                       const HitMap& hitMap,
-                                       const HitsToTrackIDEs& hitToParticleMap);
+    static void GetMips(const detinfo::DetectorPropertiesData& detProp,
+                        const Settings& settings,
+                        const std::vector<double>& charges,
+                        const std::vector<double>& wirePitches,
+                        std::vector<double>& mips);
+
+    /**
+     *  @brief  Convert hit charges in ADCs to charges per unit length in electrons per cm
+     *
+     *  @param  settings the settings
+     *  @param  electronsToADC the number of ADCs per electron
+     *  @param  charges the hit charges
+     *  @param  wirePitches the wire pitches of the hit views
+     *  @param  dQdXs to receive the charges per unit length
+     */
+    static void GetdQdX(const Settings& settings,
+                        const double electronsToADC,
+                        const std::vector<double>& charges,
+                        const std::vector<double>& wirePitches,
+                        std::vector<double>& dQdXs);
+
+    /**
+     *  @brief  Convert hit energies per unit length, in MeV per cm, to MIPs, in place
+     *
+     *  @param  settings the settings
+     *  @param  values the energies per unit length, to receive the MIP equivalent energies
+     */
+    static void ConvertdEdXToMips(const Settings& settings, std::vector<double>& values);
 
   private:
     /**
-     *  @brief  Loop over MC trajectory points and identify start and end points within the detector
+     *  @brief  CaloHitBuffer class, holding the properties of all the pandora 2D hits for an event, one array per property
+     */
+    class CaloHitBuffer {
+    public:
+      /**
+         *  @brief  Reserve space for a number of hits
+         *
+         *  @param  nHits the number of hits
+         */
+      void Reserve(const size_t nHits);
+
+      HitVector m_hits;                         ///< The ART hits
+      std::vector<pandora::HitType> m_hitTypes; ///< The pandora hit types (views)
+      std::vector<double> m_xPositions;         ///< The drift coordinates
+      std::vector<double> m_viewPositions;      ///< The wire coordinates in the pandora views
+      std::vector<double> m_widths;             ///< The drift coordinate widths
+      std::vector<double> m_wirePitches;        ///< The wire pitches
+      std::vector<double> m_charges;            ///< The hit integrals
+      std::vector<double> m_mips;               ///< The MIP equivalent energies
+      std::vector<unsigned int> m_larTPCVolumeIds;   ///< The LArTPC volume ids
+      std::vector<unsigned int> m_daughterVolumeIds; ///< The daughter volume ids
+    };
+
+    /**
+     *  @brief  Build the readout gaps by run-length encoding the bad wires on each plane
      *
      *  @param  settings the settings
-     *  @param  particle the true particle
-     *  @param  startT the first trajectory point in the detector
-     *  @param  endT the last trajectory point in the detector
+     *  @param  driftVolumeMap the mapping from volume id to drift volume
+     *  @param  badChannels the set of bad channels
+     *  @param  readoutGapList to receive the list of readout gaps
      */
-    static void GetTrueStartAndEndPoints(const Settings& settings,
-                                         const art::Ptr<simb::MCParticle>& particle,
-                                         int& startT,
-                                         int& endT);
+    static void BuildReadoutGaps(const Settings& settings,
+                                 const LArDriftVolumeMap& driftVolumeMap,
+                                 const lariov::ChannelStatusProvider::ChannelSet_t& badChannels,
+                                 LArReadoutGapList& readoutGapList);
+
+    /**
+     *  @brief  Get a fingerprint of everything the readout gaps depend upon: the wire geometry, the drift volumes, the
+     *          pandora view transformations and the bad channel set
+     *
+     *  @param  settings the settings
+     *  @param  driftVolumeMap the mapping from volume id to drift volume
+     *  @param  badChannels the set of bad channels
+     */
+    static std::uint64_t GetReadoutGapFingerprint(
+      const Settings& settings,
+      const LArDriftVolumeMap& driftVolumeMap,
+      const lariov::ChannelStatusProvider::ChannelSet_t& badChannels);
 
     /**
-     *  @brief  Loop over MC trajectory points and identify start and end points within a given cryostat and TPC
+     *  @brief  Read a readout gap table from file
      *
-     *  @param  cstat the cryostat
-     *  @param  tpc the TPC
+     *  @param  fileName the name of the file
+     *  @param  fingerprint the fingerprint the table must have been written with
+     *  @param  readoutGapList to receive the list of readout gaps
+     *
+     *  @return whether a valid table with a matching fingerprint was read
+     */
+    static bool ReadReadoutGaps(const std::string& fileName,
+                                const std::uint64_t fingerprint,
+                                LArReadoutGapList& readoutGapList);
+
+    /**
+     *  @brief  Write a readout gap table to file
+     *
+     *  @param  fileName the name of the file
+     *  @param  fingerprint the fingerprint of the table
+     *  @param  readoutGapList the list of readout gaps
+     */
+    static void WriteReadoutGaps(const std::string& fileName,
+                                 const std::uint64_t fingerprint,
+                                 const LArReadoutGapList& readoutGapList);
+
+    /**
+     *  @brief  Loop over MC trajectory points and identify start and end points within the detector
+     *
+     *  @param  tpcBoxIndex the index of tpc bounding boxes
      *  @param  particle the true particle
      *  @param  startT the first trajectory point in the detector
      *  @param  endT the last trajectory point in the detector
      */
-    static void GetTrueStartAndEndPoints(const unsigned int cstat,
-                                         const unsigned int tpc,
+    static void GetTrueStartAndEndPoints(const LArTPCBoxIndex& tpcBoxIndex,
                                          const art::Ptr<simb::MCParticle>& particle,
                                          int& startT,
                                          int& endT);
@@ -172,20 +353,63 @@ namespace lar_pandora {
     static float GetTrueX0(const art::Event& evt,
                            const art::Ptr<simb::MCParticle>& particle,
                            const int nT);
-
-    /**
-     *  @brief  Convert charge in ADCs to approximate MIPs
-     *
-     *  @param  settings the settings
-     *  @param  hit_Charge the input charge
-     *  @param  hit_View the input view number
-     */
-    static double GetMips(const detinfo::DetectorPropertiesData& detProp,
-                          const Settings& settings,
-                          const double hit_Charge,
-                          const geo::View_t hit_View);
   };
 
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline LArReadoutGap::LArReadoutGap(const pandora::LineGapType lineGapType,
+                                      const float lineStartX,
+                                      const float lineEndX,
+                                      const float lineStartZ,
+                                      const float lineEndZ)
+    : m_lineGapType(lineGapType)
+    , m_lineStartX(lineStartX)
+    , m_lineEndX(lineEndX)
+    , m_lineStartZ(lineStartZ)
+    , m_lineEndZ(lineEndZ)
+  {}
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline pandora::LineGapType
+  LArReadoutGap::GetLineGapType() const
+  {
+    return m_lineGapType;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline float
+  LArReadoutGap::GetLineStartX() const
+  {
+    return m_lineStartX;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline float
+  LArReadoutGap::GetLineEndX() const
+  {
+    return m_lineEndX;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline float
+  LArReadoutGap::GetLineStartZ() const
+  {
+    return m_lineStartZ;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline float
+  LArReadoutGap::GetLineEndZ() const
+  {
+    return m_lineEndZ;
+  }
+
 } // namespace lar_pandora
 
 #endif // #ifndef LAR_PANDORA_INPUT_H
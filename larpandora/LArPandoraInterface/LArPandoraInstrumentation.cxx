@@ -0,0 +1,201 @@
+/**
+ *  @file   larpandora/LArPandoraInterface/LArPandoraInstrumentation.cxx
+ *
+ *  @brief  Optional timing and memory instrumentation of the stages of the LArPandora producer
+ */
+
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "art_root_io/TFileService.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "TTree.h"
+
+#include "larpandora/LArPandoraInterface/LArPandoraInstrumentation.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace lar_pandora {
+
+  LArPandoraInstrumentation::Measurement::Measurement() : m_wallTime(0.), m_cpuTime(0.), m_rssDelta(0)
+  {}
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArPandoraInstrumentation::StageTimer::StageTimer(StageMeasurements* const pStageMeasurements)
+    : m_pStageMeasurements(pStageMeasurements), m_residentMemory(0)
+  {
+    if (!m_pStageMeasurements) return;
+
+    m_residentMemory = LArPandoraInstrumentation::GetResidentMemory();
+    m_timer.start();
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraInstrumentation::StageTimer::Mark(const std::string& stageName)
+  {
+    if (!m_pStageMeasurements) return;
+
+    m_timer.stop();
+    const long residentMemory(LArPandoraInstrumentation::GetResidentMemory());
+
+    Measurement measurement;
+    measurement.m_wallTime = m_timer.accumulated_real_time();
+    measurement.m_cpuTime = m_timer.accumulated_cpu_time();
+    measurement.m_rssDelta = residentMemory - m_residentMemory;
+    LArPandoraInstrumentation::AddMeasurement(stageName, measurement, *m_pStageMeasurements);
+
+    m_residentMemory = residentMemory;
+    m_timer.reset();
+    m_timer.start();
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArPandoraInstrumentation::LArPandoraInstrumentation()
+    : m_pStageTree(nullptr)
+    , m_pSummaryTree(nullptr)
+    , m_run(0)
+    , m_subRun(0)
+    , m_event(0)
+    , m_percentile(0.)
+    , m_nEvents(0)
+  {
+    art::ServiceHandle<art::TFileService const> tfs;
+
+    m_pStageTree = tfs->make<TTree>("pandoraStages", "LArPandora stage measurements");
+    m_pStageTree->Branch("run", &m_run, "run/I");
+    m_pStageTree->Branch("subRun", &m_subRun, "subRun/I");
+    m_pStageTree->Branch("event", &m_event, "event/I");
+    m_pStageTree->Branch("stage", &m_stageName);
+    m_pStageTree->Branch("wallTime", &m_measurement.m_wallTime, "wallTime/D");
+    m_pStageTree->Branch("cpuTime", &m_measurement.m_cpuTime, "cpuTime/D");
+    m_pStageTree->Branch("rssDelta", &m_measurement.m_rssDelta, "rssDelta/L");
+
+    m_pSummaryTree =
+      tfs->make<TTree>("pandoraStageSummary", "LArPandora stage measurement percentiles");
+    m_pSummaryTree->Branch("stage", &m_stageName);
+    m_pSummaryTree->Branch("nEvents", &m_nEvents, "nEvents/I");
+    m_pSummaryTree->Branch("percentile", &m_percentile, "percentile/D");
+    m_pSummaryTree->Branch("wallTime", &m_measurement.m_wallTime, "wallTime/D");
+    m_pSummaryTree->Branch("cpuTime", &m_measurement.m_cpuTime, "cpuTime/D");
+    m_pSummaryTree->Branch("rssDelta", &m_measurement.m_rssDelta, "rssDelta/L");
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraInstrumentation::FillEvent(const art::Event& evt,
+                                       const StageMeasurements& stageMeasurements)
+  {
+    m_run = evt.run();
+    m_subRun = evt.subRun();
+    m_event = evt.event();
+
+    for (const StageMeasurements::value_type& stageMeasurement : stageMeasurements) {
+      m_stageName = stageMeasurement.first;
+      m_measurement = stageMeasurement.second;
+      m_pStageTree->Fill();
+
+      StageToMeasurementsMap::iterator iter(m_stageToMeasurementsMap.find(m_stageName));
+
+      if (m_stageToMeasurementsMap.end() == iter) {
+        m_stageNames.push_back(m_stageName);
+        iter = m_stageToMeasurementsMap.emplace(m_stageName, std::vector<Measurement>()).first;
+      }
+
+      iter->second.push_back(m_measurement);
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraInstrumentation::Summarise()
+  {
+    mf::LogInfo log("LArPandora");
+    log << " *** LArPandora stage measurements, percentiles over events (wall time [s], cpu time [s], "
+           "resident memory change [kB]) *** "
+        << std::endl;
+
+    for (const std::string& stageName : m_stageNames) {
+      const std::vector<Measurement>& measurements(m_stageToMeasurementsMap.at(stageName));
+      const size_t nMeasurements(measurements.size());
+
+      std::vector<double> wallTimes, cpuTimes;
+      std::vector<long> rssDeltas;
+
+      for (const Measurement& measurement : measurements) {
+        wallTimes.push_back(measurement.m_wallTime);
+        cpuTimes.push_back(measurement.m_cpuTime);
+        rssDeltas.push_back(measurement.m_rssDelta);
+      }
+
+      std::sort(wallTimes.begin(), wallTimes.end());
+      std::sort(cpuTimes.begin(), cpuTimes.end());
+      std::sort(rssDeltas.begin(), rssDeltas.end());
+
+      m_stageName = stageName;
+      m_nEvents = nMeasurements;
+      log << std::setw(30) << std::left << stageName << " events " << nMeasurements;
+
+      for (const double percentile : {50., 90., 99., 100.}) {
+        // ATTN Nearest-rank percentile, so each summary value is one of the measurements
+        const size_t rank(std::max(
+          static_cast<size_t>(1), static_cast<size_t>(std::ceil(0.01 * percentile * nMeasurements))));
+
+        m_percentile = percentile;
+        m_measurement.m_wallTime = wallTimes.at(rank - 1);
+        m_measurement.m_cpuTime = cpuTimes.at(rank - 1);
+        m_measurement.m_rssDelta = rssDeltas.at(rank - 1);
+        m_pSummaryTree->Fill();
+
+        log << ", p" << percentile << " (" << m_measurement.m_wallTime << ", "
+            << m_measurement.m_cpuTime << ", " << m_measurement.m_rssDelta << ")";
+      }
+
+      log << std::endl;
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraInstrumentation::AddMeasurement(const std::string& stageName,
+                                            const Measurement& measurement,
+                                            StageMeasurements& stageMeasurements)
+  {
+    for (StageMeasurements::value_type& stageMeasurement : stageMeasurements) {
+      if (stageMeasurement.first != stageName) continue;
+
+      stageMeasurement.second.m_wallTime += measurement.m_wallTime;
+      stageMeasurement.second.m_cpuTime += measurement.m_cpuTime;
+      stageMeasurement.second.m_rssDelta += measurement.m_rssDelta;
+      return;
+    }
+
+    stageMeasurements.emplace_back(stageName, measurement);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  long
+  LArPandoraInstrumentation::GetResidentMemory()
+  {
+    // ATTN Linux specific; the second field of statm is the number of resident pages
+    std::ifstream statmFile("/proc/self/statm");
+    long totalPages(0), residentPages(0);
+
+    if (!(statmFile >> totalPages >> residentPages)) return 0;
+
+    return residentPages * (::sysconf(_SC_PAGESIZE) / 1024);
+  }
+
+} // namespace lar_pandora
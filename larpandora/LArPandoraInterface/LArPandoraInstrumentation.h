@@ -0,0 +1,131 @@
+/**
+ *  @file   larpandora/LArPandoraInterface/LArPandoraInstrumentation.h
+ *
+ *  @brief  Optional timing and memory instrumentation of the stages of the LArPandora producer
+ */
+
+#ifndef LAR_PANDORA_INSTRUMENTATION_H
+#define LAR_PANDORA_INSTRUMENTATION_H 1
+
+#include "cetlib/cpu_timer.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace art {
+  class Event;
+}
+
+class TTree;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_pandora {
+
+  /**
+ *  @brief  LArPandoraInstrumentation class, collecting the wall time, cpu time and resident memory change of each stage of
+ *          each event, writing them to a tree through the TFileService and summarising them at the end of the job. The
+ *          producer serialises its events on the TFileService while instrumented, so events are filled one at a time.
+ */
+  class LArPandoraInstrumentation {
+  public:
+    /**
+     *  @brief  Measurement class, holding the cost of a stage
+     */
+    class Measurement {
+    public:
+      /**
+         *  @brief  Default constructor
+         */
+      Measurement();
+
+      double m_wallTime; ///< The wall time, in seconds
+      double m_cpuTime;  ///< The cpu time, in seconds
+      long m_rssDelta;   ///< The change in resident memory, in kB
+    };
+
+    typedef std::vector<std::pair<std::string, Measurement>>
+      StageMeasurements; ///< The measurement of each stage of an event, in the order the stages first ran
+
+    /**
+     *  @brief  StageTimer class, measuring a sequence of stages, each of which ends when the next mark is made
+     */
+    class StageTimer {
+    public:
+      /**
+         *  @brief  Constructor, starting the first stage
+         *
+         *  @param  pStageMeasurements to receive the stage measurements, nullptr if instrumentation is disabled
+         */
+      explicit StageTimer(StageMeasurements* const pStageMeasurements);
+
+      /**
+         *  @brief  End the current stage, recording its measurement, and start the next stage
+         *
+         *  @param  stageName the name of the stage that has just ended
+         */
+      void Mark(const std::string& stageName);
+
+    private:
+      StageMeasurements* m_pStageMeasurements; ///< The stage measurements, nullptr if instrumentation is disabled
+      cet::cpu_timer m_timer;                  ///< The timer for the current stage
+      long m_residentMemory;                   ///< The resident memory at the start of the current stage, in kB
+    };
+
+    /**
+     *  @brief  Constructor, creating the output tree through the TFileService
+     */
+    LArPandoraInstrumentation();
+
+    /**
+     *  @brief  Record the stage measurements for an event
+     *
+     *  @param  evt the art event
+     *  @param  stageMeasurements the stage measurements for the event
+     */
+    void FillEvent(const art::Event& evt, const StageMeasurements& stageMeasurements);
+
+    /**
+     *  @brief  Write the percentiles of the stage measurements, over all events in the job, to a tree and to the log
+     */
+    void Summarise();
+
+    /**
+     *  @brief  Add a measurement to the measurements of the named stage, for stages that run more than once per event
+     *
+     *  @param  stageName the stage name
+     *  @param  measurement the measurement
+     *  @param  stageMeasurements the stage measurements
+     */
+    static void AddMeasurement(const std::string& stageName,
+                               const Measurement& measurement,
+                               StageMeasurements& stageMeasurements);
+
+    /**
+     *  @brief  Get the resident memory of the process, in kB, or zero if it is not available
+     */
+    static long GetResidentMemory();
+
+  private:
+    typedef std::map<std::string, std::vector<Measurement>> StageToMeasurementsMap;
+
+    TTree* m_pStageTree;   ///< The tree holding the measurement of each stage of each event
+    TTree* m_pSummaryTree; ///< The tree holding the percentiles of the measurements of each stage
+
+    int m_run;                ///< The run number, for the trees
+    int m_subRun;             ///< The subrun number, for the trees
+    int m_event;              ///< The event number, for the trees
+    std::string m_stageName;  ///< The stage name, for the trees
+    double m_percentile;      ///< The percentile, for the summary tree
+    int m_nEvents;            ///< The number of events, for the summary tree
+    Measurement m_measurement; ///< The measurement, for the trees
+
+    std::vector<std::string> m_stageNames;            ///< The stage names, in the order they first ran
+    StageToMeasurementsMap m_stageToMeasurementsMap; ///< The measurements of each stage over the job
+  };
+
+} // namespace lar_pandora
+
+#endif // #ifndef LAR_PANDORA_INSTRUMENTATION_H
@@ -0,0 +1,34 @@
+/**
+ *  @file   larpandora/LArPandoraInterface/LArPandoraMCInput.cxx
+ *
+ *  @brief  Gathering of the MC truth products of an event, as required to create the pandora MC input
+ */
+
+#include "larpandora/LArPandoraInterface/LArPandoraMCInput.h"
+
+namespace lar_pandora {
+
+  LArPandoraMCInput::LArPandoraMCInput(const art::Event& evt,
+                                       const Settings& settings,
+                                       const HitVector& hitVector,
+                                       LArPandoraInstrumentation::StageTimer& stageTimer)
+  {
+    LArPandoraHelper::CollectMCParticles(evt, settings.m_geantModuleLabel, m_truthToParticles);
+    stageTimer.Mark("CollectMCParticles");
+
+    if (!settings.m_generatorModuleLabel.empty()) {
+      LArPandoraHelper::CollectGeneratorMCParticles(
+        evt, settings.m_generatorModuleLabel, m_generatorParticles);
+      stageTimer.Mark("CollectGeneratorMCParticles");
+    }
+
+    LArPandoraHelper::BuildMCParticleHitMaps(evt,
+                                             hitVector,
+                                             settings.m_simChannelModuleLabel,
+                                             settings.m_hitfinderModuleLabel,
+                                             settings.m_backtrackerModuleLabel,
+                                             m_hitsToTrackIDEs);
+    stageTimer.Mark("BacktrackHits");
+  }
+
+} // namespace lar_pandora
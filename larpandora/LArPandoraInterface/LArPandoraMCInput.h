@@ -0,0 +1,101 @@
+/**
+ *  @file   larpandora/LArPandoraInterface/LArPandoraMCInput.h
+ *
+ *  @brief  Gathering of the MC truth products of an event, as required to create the pandora MC input
+ */
+
+#ifndef LAR_PANDORA_MC_INPUT_H
+#define LAR_PANDORA_MC_INPUT_H 1
+
+#include "larpandora/LArPandoraInterface/LArPandoraHelper.h"
+#include "larpandora/LArPandoraInterface/LArPandoraInstrumentation.h"
+
+#include <string>
+
+namespace art {
+  class Event;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_pandora {
+
+  /**
+ *  @brief  LArPandoraMCInput class. The generator, Geant4 and SimChannel (or backtracker) products are each read once per
+ *          event, and every view of them needed to create the pandora MC particles and MC links is built from that read.
+ */
+  class LArPandoraMCInput {
+  public:
+    /**
+     *  @brief  Settings class
+     */
+    class Settings {
+    public:
+      std::string m_geantModuleLabel;       ///< The geant module label
+      std::string m_generatorModuleLabel;   ///< The generator module label, empty if the generator particles are not used
+      std::string m_simChannelModuleLabel;  ///< The SimChannel producer module label
+      std::string m_hitfinderModuleLabel;   ///< The hit finder module label
+      std::string m_backtrackerModuleLabel; ///< The back tracker module label, used if the SimChannels do not exist
+    };
+
+    /**
+     *  @brief  Constructor, gathering the MC truth products of an event
+     *
+     *  @param  evt the art event
+     *  @param  settings the settings
+     *  @param  hitVector the reconstructed hits to be backtracked
+     *  @param  stageTimer the timer with which to measure each step
+     */
+    LArPandoraMCInput(const art::Event& evt,
+                      const Settings& settings,
+                      const HitVector& hitVector,
+                      LArPandoraInstrumentation::StageTimer& stageTimer);
+
+    /**
+     *  @brief  Get the mapping from MC truth to the Geant4 MC particles
+     */
+    const MCTruthToMCParticles& GetMCTruthToMCParticles() const;
+
+    /**
+     *  @brief  Get the generator MC particles
+     */
+    const RawMCParticleVector& GetGeneratorMCParticles() const;
+
+    /**
+     *  @brief  Get the mapping from the reconstructed hits to their true energy deposits
+     */
+    const HitsToTrackIDEs& GetHitsToTrackIDEs() const;
+
+  private:
+    MCTruthToMCParticles m_truthToParticles;  ///< The mapping from MC truth to the Geant4 MC particles
+    RawMCParticleVector m_generatorParticles; ///< The generator MC particles
+    HitsToTrackIDEs m_hitsToTrackIDEs;        ///< The mapping from the reconstructed hits to their true energy deposits
+  };
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const MCTruthToMCParticles&
+  LArPandoraMCInput::GetMCTruthToMCParticles() const
+  {
+    return m_truthToParticles;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const RawMCParticleVector&
+  LArPandoraMCInput::GetGeneratorMCParticles() const
+  {
+    return m_generatorParticles;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const HitsToTrackIDEs&
+  LArPandoraMCInput::GetHitsToTrackIDEs() const
+  {
+    return m_hitsToTrackIDEs;
+  }
+
+} // namespace lar_pandora
+
+#endif // #ifndef LAR_PANDORA_MC_INPUT_H
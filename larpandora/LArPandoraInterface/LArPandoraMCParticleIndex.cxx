@@ -0,0 +1,153 @@
+/**
+ *  @file   larpandora/LArPandoraInterface/LArPandoraMCParticleIndex.cxx
+ *
+ *  @brief  Index of the MC particles of an event, by track id, with their origins and generator primary flags
+ */
+
+#include "nusimdata/SimulationBase/MCParticle.h"
+
+#include "larpandora/LArPandoraInterface/LArPandoraMCParticleIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+
+namespace lar_pandora {
+
+  LArPandoraMCParticleIndex::LArPandoraMCParticleIndex(const MCTruthToMCParticles& truthToParticles)
+  {
+    this->Fill(truthToParticles);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArPandoraMCParticleIndex::LArPandoraMCParticleIndex(
+    const MCTruthToMCParticles& truthToParticles,
+    const RawMCParticleVector& generatorMCParticleVector)
+  {
+    this->Fill(truthToParticles);
+    this->FlagPrimaries(generatorMCParticleVector);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraMCParticleIndex::Fill(const MCTruthToMCParticles& truthToParticles)
+  {
+    MCParticleVector particles;
+    std::vector<simb::Origin_t> origins;
+    TrackIDToIndexMap trackIDToIndexMap;
+
+    for (const MCTruthToMCParticles::value_type& truthToParticlesEntry : truthToParticles) {
+      const simb::Origin_t origin(truthToParticlesEntry.first->Origin());
+
+      for (const art::Ptr<simb::MCParticle>& particle : truthToParticlesEntry.second) {
+        const std::pair<TrackIDToIndexMap::iterator, bool> insertion(
+          trackIDToIndexMap.emplace(particle->TrackId(), particles.size()));
+
+        // ATTN A repeated track id replaces the earlier particle, as it would in a MCParticleMap
+        if (!insertion.second) {
+          particles[insertion.first->second] = particle;
+          origins[insertion.first->second] = origin;
+          continue;
+        }
+
+        particles.push_back(particle);
+        origins.push_back(origin);
+      }
+    }
+
+    std::vector<size_t> order(particles.size());
+
+    for (size_t index = 0; index < order.size(); ++index)
+      order[index] = index;
+
+    std::sort(order.begin(), order.end(), [&particles](const size_t lhs, const size_t rhs) {
+      return particles[lhs]->TrackId() < particles[rhs]->TrackId();
+    });
+
+    m_particles.clear();
+    m_origins.clear();
+    m_trackIDToIndexMap.clear();
+    m_particles.reserve(order.size());
+    m_origins.reserve(order.size());
+    m_trackIDToIndexMap.reserve(order.size());
+
+    for (const size_t index : order) {
+      m_trackIDToIndexMap.emplace(particles[index]->TrackId(), m_particles.size());
+      m_particles.push_back(particles[index]);
+      m_origins.push_back(origins[index]);
+    }
+
+    m_isPrimary.assign(m_particles.size(), false);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraMCParticleIndex::FlagPrimaries(const RawMCParticleVector& generatorMCParticleVector)
+  {
+    // Primary generator particles, unique by track id, ordered by x momentum so that matching candidates are adjacent
+    std::vector<const simb::MCParticle*> primaries;
+    std::set<int> primaryTrackIDs;
+
+    for (const simb::MCParticle& mcParticle : generatorMCParticleVector) {
+      if ("primary" != mcParticle.Process()) continue;
+
+      if (!primaryTrackIDs.insert(mcParticle.TrackId()).second) continue;
+
+      primaries.push_back(&mcParticle);
+    }
+
+    std::sort(primaries.begin(),
+              primaries.end(),
+              [](const simb::MCParticle* const pLhs, const simb::MCParticle* const pRhs) {
+                return (pLhs->Px() < pRhs->Px()) ||
+                       (!(pRhs->Px() < pLhs->Px()) && pLhs->TrackId() < pRhs->TrackId());
+              });
+
+    std::vector<bool> isMatched(primaries.size(), false);
+    const double epsilon(std::numeric_limits<double>::epsilon());
+
+    for (size_t index = 0; index < m_particles.size(); ++index) {
+      const art::Ptr<simb::MCParticle>& particle(m_particles[index]);
+      const double px(particle->Px()), py(particle->Py()), pz(particle->Pz());
+
+      // ATTN Momenta must agree to within epsilon, the search window is widened to allow for rounding of its limits
+      const std::vector<const simb::MCParticle*>::const_iterator iterBegin(std::lower_bound(
+        primaries.begin(),
+        primaries.end(),
+        px - 2. * epsilon,
+        [](const simb::MCParticle* const pPrimary, const double value) {
+          return pPrimary->Px() < value;
+        }));
+
+      size_t bestMatch(primaries.size());
+
+      for (std::vector<const simb::MCParticle*>::const_iterator iter = iterBegin;
+           iter != primaries.end() && (*iter)->Px() <= px + 2. * epsilon;
+           ++iter) {
+        const size_t primaryIndex(iter - primaries.begin());
+        const simb::MCParticle* const pPrimary(*iter);
+
+        if (isMatched[primaryIndex]) continue;
+
+        if (!(std::fabs(pPrimary->Px() - px) < epsilon && std::fabs(pPrimary->Py() - py) < epsilon &&
+              std::fabs(pPrimary->Pz() - pz) < epsilon))
+          continue;
+
+        // Of the matching primaries, take the one with the lowest track id
+        if (bestMatch == primaries.size() ||
+            pPrimary->TrackId() < primaries[bestMatch]->TrackId())
+          bestMatch = primaryIndex;
+      }
+
+      if (bestMatch == primaries.size()) continue;
+
+      isMatched[bestMatch] = true;
+      m_isPrimary[index] = true;
+    }
+  }
+
+} // namespace lar_pandora
@@ -0,0 +1,150 @@
+/**
+ *  @file   larpandora/LArPandoraInterface/LArPandoraMCParticleIndex.h
+ *
+ *  @brief  Index of the MC particles of an event, by track id, with their origins and generator primary flags
+ */
+
+#ifndef LAR_PANDORA_MC_PARTICLE_INDEX_H
+#define LAR_PANDORA_MC_PARTICLE_INDEX_H 1
+
+#include "nusimdata/SimulationBase/MCTruth.h"
+
+#include "larpandora/LArPandoraInterface/LArPandoraHelper.h"
+
+#include <unordered_map>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_pandora {
+
+  /**
+ *  @brief  LArPandoraMCParticleIndex class, built in a single pass over the MC truth to MC particle map. The particles are
+ *          held in order of track id, and can be found from their track id through a hash table.
+ */
+  class LArPandoraMCParticleIndex {
+  public:
+    /**
+     *  @brief  Constructor, no particle is flagged as a generator primary
+     *
+     *  @param  truthToParticles mapping from MC truth to MC particles
+     */
+    LArPandoraMCParticleIndex(const MCTruthToMCParticles& truthToParticles);
+
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  truthToParticles mapping from MC truth to MC particles
+     *  @param  generatorMCParticleVector the generator MC particles, used to flag the generator primaries
+     */
+    LArPandoraMCParticleIndex(const MCTruthToMCParticles& truthToParticles,
+                              const RawMCParticleVector& generatorMCParticleVector);
+
+    /**
+     *  @brief  Get the number of particles in the index
+     */
+    size_t GetNParticles() const;
+
+    /**
+     *  @brief  Get a particle, the particles are in order of track id
+     *
+     *  @param  index the position of the particle in the index
+     */
+    const art::Ptr<simb::MCParticle>& GetParticle(const size_t index) const;
+
+    /**
+     *  @brief  Get the origin of the MC truth of a particle
+     *
+     *  @param  index the position of the particle in the index
+     */
+    simb::Origin_t GetOrigin(const size_t index) const;
+
+    /**
+     *  @brief  Whether a particle matches a primary generator particle
+     *
+     *  @param  index the position of the particle in the index
+     */
+    bool IsPrimary(const size_t index) const;
+
+    /**
+     *  @brief  Find the position in the index of the particle with a given track id
+     *
+     *  @param  trackID the track id
+     *  @param  index to receive the position of the particle in the index
+     *
+     *  @return whether a particle with the track id exists
+     */
+    bool FindTrackID(const int trackID, size_t& index) const;
+
+  private:
+    /**
+     *  @brief  Fill the index from the MC truth to MC particle map
+     *
+     *  @param  truthToParticles mapping from MC truth to MC particles
+     */
+    void Fill(const MCTruthToMCParticles& truthToParticles);
+
+    /**
+     *  @brief  Flag the particles matching the primary generator particles. Each primary generator particle is matched
+     *          to at most one particle, the first in order of track id with the same momentum.
+     *
+     *  @param  generatorMCParticleVector the generator MC particles
+     */
+    void FlagPrimaries(const RawMCParticleVector& generatorMCParticleVector);
+
+    typedef std::unordered_map<int, size_t> TrackIDToIndexMap;
+
+    MCParticleVector m_particles;          ///< The particles, in order of track id
+    std::vector<simb::Origin_t> m_origins; ///< The origin of the MC truth of each particle
+    std::vector<bool> m_isPrimary;         ///< Whether each particle matches a primary generator particle
+    TrackIDToIndexMap m_trackIDToIndexMap; ///< The position of each particle in the index, from its track id
+  };
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline size_t
+  LArPandoraMCParticleIndex::GetNParticles() const
+  {
+    return m_particles.size();
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const art::Ptr<simb::MCParticle>&
+  LArPandoraMCParticleIndex::GetParticle(const size_t index) const
+  {
+    return m_particles.at(index);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline simb::Origin_t
+  LArPandoraMCParticleIndex::GetOrigin(const size_t index) const
+  {
+    return m_origins.at(index);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline bool
+  LArPandoraMCParticleIndex::IsPrimary(const size_t index) const
+  {
+    return m_isPrimary.at(index);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline bool
+  LArPandoraMCParticleIndex::FindTrackID(const int trackID, size_t& index) const
+  {
+    const TrackIDToIndexMap::const_iterator iter(m_trackIDToIndexMap.find(trackID));
+
+    if (m_trackIDToIndexMap.end() == iter) return false;
+
+    index = iter->second;
+    return true;
+  }
+
+} // namespace lar_pandora
+
+#endif // #ifndef LAR_PANDORA_MC_PARTICLE_INDEX_H
@@ -26,6 +26,8 @@
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 
 #include "Api/PandoraApi.h"
+#include "Managers/PluginManager.h"
+#include "Plugins/LArTransformationPlugin.h"
 
 #include "Objects/CaloHit.h"
 #include "Objects/Cluster.h"
@@ -36,9 +38,14 @@
 #include "larpandoracontent/LArHelpers/LArClusterHelper.h"
 #include "larpandoracontent/LArHelpers/LArPfoHelper.h"
 
+#include "larpandora/LArPandoraInterface/LArPandoraCache.h"
 #include "larpandora/LArPandoraInterface/LArPandoraOutput.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iterator>
 #include <limits>
@@ -51,8 +58,58 @@ namespace lar_pandora {
                                      art::Event& evt)
   {
     settings.Validate();
-    const std::string instanceLabel(
-      settings.m_shouldProduceAllOutcomes ? settings.m_allOutcomesInstanceLabel : "");
+
+    LArPandoraInstrumentation::StageTimer stageTimer(settings.m_pStageMeasurements);
+
+    // ATTN The clusters are only kept if there is a second view in which they may be found
+    ConversionCache conversionCache(evt, settings.m_shouldProduceAllOutcomes);
+    ArtHitTable artHitTable(idToHitMap);
+    const SpacePointErrorModel spacePointErrorModel(*settings.m_pPrimaryPandora);
+
+    // Collect immutable lists of pandora collections that we should convert to ART format
+    const pandora::PfoVector pfoVector(LArPandoraOutput::CollectPfos(settings.m_pPrimaryPandora));
+    stageTimer.Mark("CollectPfos");
+
+    LArPandoraOutput::ProduceArtOutput(settings,
+                                       "",
+                                       pfoVector,
+                                       idToHitMap,
+                                       artHitTable,
+                                       conversionCache,
+                                       spacePointErrorModel,
+                                       stageTimer,
+                                       evt);
+
+    if (!settings.m_shouldProduceAllOutcomes) return;
+
+    const pandora::PfoVector allOutcomesPfoVector(
+      LArPandoraOutput::CollectAllPfoOutcomes(settings.m_pPrimaryPandora, pfoVector));
+    stageTimer.Mark("CollectPfos");
+
+    LArPandoraOutput::ProduceArtOutput(settings,
+                                       settings.m_allOutcomesInstanceLabel,
+                                       allOutcomesPfoVector,
+                                       idToHitMap,
+                                       artHitTable,
+                                       conversionCache,
+                                       spacePointErrorModel,
+                                       stageTimer,
+                                       evt);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraOutput::ProduceArtOutput(const Settings& settings,
+                                     const std::string& instanceLabel,
+                                     const pandora::PfoVector& pfoVector,
+                                     const IdToHitMap& idToHitMap,
+                                     ArtHitTable& artHitTable,
+                                     ConversionCache& conversionCache,
+                                     const SpacePointErrorModel& spacePointErrorModel,
+                                     LArPandoraInstrumentation::StageTimer& stageTimer,
+                                     art::Event& evt)
+  {
     const std::string testBeamInteractionVertexInstanceLabel(
       instanceLabel + settings.m_testBeamInteractionVerticesInstanceLabel);
 
@@ -96,12 +153,7 @@ namespace lar_pandora {
     PFParticleToSliceCollection outputParticlesToSlices(
       settings.m_shouldProduceSlices ? new art::Assns<recob::PFParticle, recob::Slice> : nullptr);
 
-    // Collect immutable lists of pandora collections that we should convert to ART format
-    const pandora::PfoVector pfoVector(
-      settings.m_shouldProduceAllOutcomes ?
-        LArPandoraOutput::CollectAllPfoOutcomes(settings.m_pPrimaryPandora) :
-        LArPandoraOutput::CollectPfos(settings.m_pPrimaryPandora));
-
+    // Collect immutable lists of the other pandora collections that we should convert to ART format
     IdToIdVectorMap pfoToVerticesMap, pfoToTestBeamInteractionVerticesMap;
     const pandora::VertexVector vertexVector(LArPandoraOutput::CollectVertices(
       pfoVector, pfoToVerticesMap, lar_content::LArPfoHelper::GetVertex));
@@ -111,19 +163,30 @@ namespace lar_pandora {
                                           pfoToTestBeamInteractionVerticesMap,
                                           lar_content::LArPfoHelper::GetTestBeamInteractionVertex) :
         pandora::VertexVector());
+    stageTimer.Mark("CollectVertices");
 
     IdToIdVectorMap pfoToClustersMap;
     const pandora::ClusterList clusterList(
       LArPandoraOutput::CollectClusters(pfoVector, pfoToClustersMap));
+    stageTimer.Mark("CollectClusters");
 
     IdToIdVectorMap pfoToThreeDHitsMap;
     const pandora::CaloHitList threeDHitList(
       LArPandoraOutput::Collect3DHits(pfoVector, pfoToThreeDHitsMap));
+    stageTimer.Mark("Collect3DHits");
 
-    // Get mapping from pandora hits to art hits
-    CaloHitToArtHitMap pandoraHitToArtHitMap;
-    LArPandoraOutput::GetPandoraToArtHitMap(
-      clusterList, threeDHitList, idToHitMap, pandoraHitToArtHitMap);
+    // Index the pandora objects once, so that their ids can be found without searching the collections
+    const IdIndex idIndex(pfoVector, vertexVector, clusterList, threeDHitList);
+
+    // Resolve the root parent of each pfo, and the properties of that parent, once
+    const PfoAncestry pfoAncestry(pfoVector, idIndex);
+
+    // Create the PtrMakers for the output products once, and share them between all of the associations
+    const OutputContext context(evt, instanceLabel);
+
+    // Resolve the art hit of each pandora hit once, reusing those resolved for an earlier output view
+    artHitTable.AddView(clusterList, threeDHitList);
+    stageTimer.Mark("BuildArtHitTable");
 
     // Build the ART outputs from the pandora objects
     LArPandoraOutput::BuildVertices(vertexVector, outputVertices);
@@ -131,58 +194,66 @@ namespace lar_pandora {
     if (settings.m_shouldProduceTestBeamInteractionVertices)
       LArPandoraOutput::BuildVertices(testBeamInteractionVertexVector,
                                       outputTestBeamInteractionVertices);
+    stageTimer.Mark("BuildVertices");
 
-    LArPandoraOutput::BuildSpacePoints(evt,
-                                       instanceLabel,
+    LArPandoraOutput::BuildSpacePoints(context,
                                        threeDHitList,
-                                       pandoraHitToArtHitMap,
+                                       artHitTable,
+                                       spacePointErrorModel,
                                        outputSpacePoints,
                                        outputSpacePointsToHits);
+    stageTimer.Mark("BuildSpacePoints");
 
     IdToIdVectorMap pfoToArtClustersMap;
-    LArPandoraOutput::BuildClusters(evt,
-                                    instanceLabel,
+    LArPandoraOutput::BuildClusters(context,
                                     clusterList,
-                                    pandoraHitToArtHitMap,
+                                    artHitTable,
+                                    conversionCache,
                                     pfoToClustersMap,
                                     outputClusters,
                                     outputClustersToHits,
                                     pfoToArtClustersMap);
+    stageTimer.Mark("BuildClusters");
 
-    LArPandoraOutput::BuildPFParticles(evt,
-                                       instanceLabel,
+    LArPandoraOutput::BuildPFParticles(context,
                                        pfoVector,
                                        pfoToVerticesMap,
                                        pfoToThreeDHitsMap,
                                        pfoToArtClustersMap,
+                                       idIndex,
                                        outputParticles,
                                        outputParticlesToVertices,
                                        outputParticlesToSpacePoints,
                                        outputParticlesToClusters);
+    stageTimer.Mark("BuildPFParticles");
 
     LArPandoraOutput::BuildParticleMetadata(
-      evt, instanceLabel, pfoVector, outputParticleMetadata, outputParticlesToMetadata);
+      context, pfoVector, outputParticleMetadata, outputParticlesToMetadata);
+    stageTimer.Mark("BuildParticleMetadata");
 
     if (settings.m_shouldProduceSlices)
       LArPandoraOutput::BuildSlices(settings,
                                     settings.m_pPrimaryPandora,
-                                    evt,
-                                    instanceLabel,
+                                    context,
                                     pfoVector,
+                                    pfoAncestry,
                                     idToHitMap,
                                     outputSlices,
                                     outputParticlesToSlices,
                                     outputSlicesToHits);
+    stageTimer.Mark("BuildSlices");
 
     if (settings.m_shouldRunStitching)
-      LArPandoraOutput::BuildT0s(evt, instanceLabel, pfoVector, outputT0s, outputParticlesToT0s);
+      LArPandoraOutput::BuildT0s(
+        context, conversionCache, pfoVector, pfoAncestry, outputT0s, outputParticlesToT0s);
+    stageTimer.Mark("BuildT0s");
 
     if (settings.m_shouldProduceTestBeamInteractionVertices)
-      LArPandoraOutput::AssociateAdditionalVertices(evt,
-                                                    instanceLabel,
+      LArPandoraOutput::AssociateAdditionalVertices(context,
                                                     pfoVector,
                                                     pfoToTestBeamInteractionVerticesMap,
                                                     outputParticlesToTestBeamInteractionVertices);
+    stageTimer.Mark("AssociateAdditionalVertices");
 
     // Add the outputs to the event
     evt.put(std::move(outputParticles), instanceLabel);
@@ -214,6 +285,7 @@ namespace lar_pandora {
       evt.put(std::move(outputSlices), instanceLabel);
       evt.put(std::move(outputSlicesToHits), instanceLabel);
     }
+    stageTimer.Mark("PutOutputs");
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
@@ -273,7 +345,8 @@ namespace lar_pandora {
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   pandora::PfoVector
-  LArPandoraOutput::CollectAllPfoOutcomes(const pandora::Pandora* const pPrimaryPandora)
+  LArPandoraOutput::CollectAllPfoOutcomes(const pandora::Pandora* const pPrimaryPandora,
+                                          const pandora::PfoVector& pfoVector)
   {
     pandora::PfoList collectedPfos;
 
@@ -313,16 +386,20 @@ namespace lar_pandora {
                             !=,
                             PandoraApi::GetCurrentPfoList(*pPrimaryPandora, pParentPfoList));
 
-    // Collect clear cosmic-rays
+    // Collect clear cosmic-rays, resolving the root parent of each hierarchy of the master instance once
+    const IdIndex idIndex(
+      pfoVector, pandora::VertexVector(), pandora::ClusterList(), pandora::CaloHitList());
+    const PfoAncestry pfoAncestry(pfoVector, idIndex);
+
     for (const pandora::ParticleFlowObject* const pPfo : *pParentPfoList) {
-      if (LArPandoraOutput::IsClearCosmic(pPfo)) collectedPfos.push_back(pPfo);
+      if (pfoAncestry.IsClearCosmic(idIndex.GetId(pPfo))) collectedPfos.push_back(pPfo);
     }
 
     // Collect all pfos that are downstream of the parents we have collected
-    pandora::PfoVector pfoVector;
-    LArPandoraOutput::CollectPfos(collectedPfos, pfoVector);
+    pandora::PfoVector allOutcomesPfoVector;
+    LArPandoraOutput::CollectPfos(collectedPfos, allOutcomesPfoVector);
 
-    return pfoVector;
+    return allOutcomesPfoVector;
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
@@ -410,6 +487,7 @@ namespace lar_pandora {
     std::function<const pandora::Vertex* const(const pandora::ParticleFlowObject* const)> fCriteria)
   {
     pandora::VertexVector vertexVector;
+    IdMap<pandora::Vertex> vertexIdMap;
 
     for (unsigned int pfoId = 0; pfoId < pfoVector.size(); ++pfoId) {
       const pandora::ParticleFlowObject* const pPfo(pfoVector.at(pfoId));
@@ -420,12 +498,10 @@ namespace lar_pandora {
         const pandora::Vertex* const pVertex(fCriteria(pPfo));
 
         // Get the vertex ID and add it to the vertex list if required
-        const auto it(std::find(vertexVector.begin(), vertexVector.end(), pVertex));
-        const bool isInList(it != vertexVector.end());
-        const size_t vertexId(isInList ? std::distance(vertexVector.begin(), it) :
-                                         vertexVector.size());
+        const auto insertion(vertexIdMap.emplace(pVertex, vertexVector.size()));
+        const size_t vertexId(insertion.first->second);
 
-        if (!isInList) vertexVector.push_back(pVertex);
+        if (insertion.second) vertexVector.push_back(pVertex);
 
         if (!pfoToVerticesMap.insert(IdToIdVectorMap::value_type(pfoId, {vertexId})).second)
           throw cet::exception("LArPandora")
@@ -518,74 +594,23 @@ namespace lar_pandora {
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
-  void
-  LArPandoraOutput::GetPandoraToArtHitMap(const pandora::ClusterList& clusterList,
-                                          const pandora::CaloHitList& threeDHitList,
-                                          const IdToHitMap& idToHitMap,
-                                          CaloHitToArtHitMap& pandoraHitToArtHitMap)
-  {
-    // Collect 2D hits from clusters
-    for (const pandora::Cluster* const pCluster : clusterList) {
-      if (pandora::TPC_3D == lar_content::LArClusterHelper::GetClusterHitType(pCluster))
-        throw cet::exception("LArPandora")
-          << " LArPandoraOutput::GetPandoraToArtHitMap --- found a 3D input cluster ";
-
-      pandora::CaloHitVector sortedHits;
-      LArPandoraOutput::GetHitsInCluster(pCluster, sortedHits);
-
-      for (const pandora::CaloHit* const pCaloHit : sortedHits) {
-        if (!pandoraHitToArtHitMap
-               .insert(CaloHitToArtHitMap::value_type(
-                 pCaloHit, LArPandoraOutput::GetHit(idToHitMap, pCaloHit)))
-               .second)
-          throw cet::exception("LArPandora")
-            << " LArPandoraOutput::GetPandoraToArtHitMap --- found repeated input hits ";
-      }
-    }
-
-    for (const pandora::CaloHit* const pCaloHit : threeDHitList) {
-      if (pCaloHit->GetHitType() != pandora::TPC_3D)
-        throw cet::exception("LArPandora")
-          << " LArPandoraOutput::GetPandoraToArtHitMap --- found a non-3D hit in the input list ";
-
-      // ATTN get the 2D calo hit from the 3D calo hit then find the art hit!
-      if (!pandoraHitToArtHitMap
-             .insert(CaloHitToArtHitMap::value_type(
-               pCaloHit,
-               LArPandoraOutput::GetHit(
-                 idToHitMap, static_cast<const pandora::CaloHit*>(pCaloHit->GetParentAddress()))))
-             .second)
-        throw cet::exception("LArPandora")
-          << " LArPandoraOutput::GetPandoraToArtHitMap --- found repeated input hits ";
-    }
-  }
-
-  //------------------------------------------------------------------------------------------------------------------------------------------
-
   art::Ptr<recob::Hit>
   LArPandoraOutput::GetHit(const IdToHitMap& idToHitMap, const pandora::CaloHit* const pCaloHit)
   {
-    //  TODO make this less evil
+    // ATTN The CaloHit can come from the primary pandora instance (depth = 0), whose parent address is the id of the ART hit,
+    //      or one of its daughters (depth = 1), whose parent address is the CaloHit in the primary instance. An id is only
+    //      accepted if the parent address converts to it exactly, so that a truncated CaloHit address is never taken for one
+    const pandora::CaloHit* pParentCaloHit(pCaloHit);
 
-    // ATTN The CaloHit can come from the primary pandora instance (depth = 0) or one of its daughers (depth = 1).
-    //      Here we keep trying to access the ART hit increasing the depth step-by-step
     for (unsigned int depth = 0, maxDepth = 2; depth < maxDepth; ++depth) {
-      // Navigate to the hit address in the pandora master instance (assuming the depth is correct)
-      const pandora::CaloHit* pParentCaloHit = pCaloHit;
-      for (unsigned int i = 0; i < depth; ++i)
-        pParentCaloHit = static_cast<const pandora::CaloHit*>(pCaloHit->GetParentAddress());
-
-      // Attempt to find the mapping from the "parent" calo hit to the ART hit
-      const void* const pHitAddress(pParentCaloHit->GetParentAddress());
-      const intptr_t hitID_temp((intptr_t)(pHitAddress));
-      const int hitID((int)(hitID_temp));
-
-      IdToHitMap::const_iterator artIter = idToHitMap.find(hitID);
+      const intptr_t parentAddress(reinterpret_cast<intptr_t>(pParentCaloHit->GetParentAddress()));
+      const int hitID(static_cast<int>(parentAddress));
 
-      // If there is no such mapping from "parent" calo hit to the ART hit, then increase the depth and try again!
-      if (idToHitMap.end() == artIter) continue;
+      if ((static_cast<intptr_t>(hitID) == parentAddress) && idToHitMap.Contains(hitID))
+        return idToHitMap.GetHit(hitID);
 
-      return artIter->second;
+      // Otherwise navigate to the hit address in the parent pandora instance and try again
+      pParentCaloHit = static_cast<const pandora::CaloHit*>(pParentCaloHit->GetParentAddress());
     }
 
     throw cet::exception("LArPandora")
@@ -605,10 +630,10 @@ namespace lar_pandora {
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandoraOutput::BuildSpacePoints(const art::Event& event,
-                                     const std::string& instanceLabel,
+  LArPandoraOutput::BuildSpacePoints(const OutputContext& context,
                                      const pandora::CaloHitList& threeDHitList,
-                                     const CaloHitToArtHitMap& pandoraHitToArtHitMap,
+                                     const ArtHitTable& artHitTable,
+                                     const SpacePointErrorModel& spacePointErrorModel,
                                      SpacePointCollection& outputSpacePoints,
                                      SpacePointToHitCollection& outputSpacePointsToHits)
   {
@@ -618,62 +643,53 @@ namespace lar_pandora {
     for (unsigned int hitId = 0; hitId < threeDHitVector.size(); hitId++) {
       const pandora::CaloHit* const pCaloHit(threeDHitVector.at(hitId));
 
-      CaloHitToArtHitMap::const_iterator it(pandoraHitToArtHitMap.find(pCaloHit));
-      if (it == pandoraHitToArtHitMap.end())
-        throw cet::exception("LArPandora") << " LArPandoraOutput::BuildSpacePoints --- found a "
-                                              "pandora hit without a corresponding art hit ";
-
-      LArPandoraOutput::AddAssociation(
-        event, instanceLabel, hitId, {it->second}, outputSpacePointsToHits);
-      outputSpacePoints->push_back(LArPandoraOutput::BuildSpacePoint(pCaloHit, hitId));
+      context.AddAssociation(hitId, artHitTable.GetThreeDArtHit(pCaloHit), outputSpacePointsToHits);
+      outputSpacePoints->push_back(
+        LArPandoraOutput::BuildSpacePoint(pCaloHit, hitId, spacePointErrorModel));
     }
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandoraOutput::BuildClusters(const art::Event& event,
-                                  const std::string& instanceLabel,
+  LArPandoraOutput::BuildClusters(const OutputContext& context,
                                   const pandora::ClusterList& clusterList,
-                                  const CaloHitToArtHitMap& pandoraHitToArtHitMap,
+                                  const ArtHitTable& artHitTable,
+                                  ConversionCache& conversionCache,
                                   const IdToIdVectorMap& pfoToClustersMap,
                                   ClusterCollection& outputClusters,
                                   ClusterToHitCollection& outputClustersToHits,
                                   IdToIdVectorMap& pfoToArtClustersMap)
   {
-    cluster::StandardClusterParamsAlg clusterParamAlgo;
+    // Split the hits of the pandora clusters by drift volume, one art cluster per part
+    std::vector<HitVector> hitVectors;
+    HitList isolatedHits;
+    IdToIdVectorMap pandoraClusterToArtClustersMap;
 
-    art::ServiceHandle<geo::Geometry const> geom{};
-    auto const clock_data =
-      art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
-    auto const det_prop =
-      art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event, clock_data);
-    util::GeometryUtilities const gser{*geom, clock_data, det_prop};
+    size_t clusterIndex(0);
 
-    // Produce the art clusters
-    size_t nextClusterId(0);
-    IdToIdVectorMap pandoraClusterToArtClustersMap;
-    for (const pandora::Cluster* const pCluster : clusterList) {
-      std::vector<HitVector> hitVectors;
-      const std::vector<recob::Cluster> clusters(
-        LArPandoraOutput::BuildClusters(gser,
-                                        pCluster,
-                                        clusterList,
-                                        pandoraHitToArtHitMap,
-                                        pandoraClusterToArtClustersMap,
-                                        hitVectors,
-                                        nextClusterId,
-                                        clusterParamAlgo));
-
-      if (hitVectors.size() != clusters.size())
-        throw cet::exception("LArPandora")
-          << " LArPandoraOutput::BuildClusters --- invalid hit vectors for clusters produced ";
+    for (const pandora::Cluster* const pCluster : clusterList)
+      LArPandoraOutput::SplitCluster(clusterIndex++,
+                                     pCluster,
+                                     artHitTable,
+                                     pandoraClusterToArtClustersMap,
+                                     hitVectors,
+                                     isolatedHits);
 
-      for (unsigned int i = 0; i < clusters.size(); ++i) {
-        LArPandoraOutput::AddAssociation(
-          event, instanceLabel, nextClusterId - 1, hitVectors.at(i), outputClustersToHits);
-        outputClusters->push_back(clusters.at(i));
-      }
+    // Produce the art clusters, whose parameters are calculated concurrently
+    std::vector<recob::Cluster> clusters;
+    conversionCache.GetClusters(hitVectors, isolatedHits, clusters);
+
+    if (hitVectors.size() != clusters.size())
+      throw cet::exception("LArPandora")
+        << " LArPandoraOutput::BuildClusters --- invalid hit vectors for clusters produced ";
+
+    // Add the art clusters and their associations in order of id
+    outputClusters->reserve(clusters.size());
+
+    for (size_t clusterId = 0; clusterId < clusters.size(); ++clusterId) {
+      context.AddAssociation(clusterId, hitVectors[clusterId], outputClustersToHits);
+      outputClusters->push_back(std::move(clusters[clusterId]));
     }
 
     // Get mapping from pfo id to art cluster id
@@ -700,12 +716,12 @@ namespace lar_pandora {
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandoraOutput::BuildPFParticles(const art::Event& event,
-                                     const std::string& instanceLabel,
+  LArPandoraOutput::BuildPFParticles(const OutputContext& context,
                                      const pandora::PfoVector& pfoVector,
                                      const IdToIdVectorMap& pfoToVerticesMap,
                                      const IdToIdVectorMap& pfoToThreeDHitsMap,
                                      const IdToIdVectorMap& pfoToArtClustersMap,
+                                     const IdIndex& idIndex,
                                      PFParticleCollection& outputParticles,
                                      PFParticleToVertexCollection& outputParticlesToVertices,
                                      PFParticleToSpacePointCollection& outputParticlesToSpacePoints,
@@ -714,20 +730,20 @@ namespace lar_pandora {
     for (unsigned int pfoId = 0; pfoId < pfoVector.size(); ++pfoId) {
       const pandora::ParticleFlowObject* const pPfo(pfoVector.at(pfoId));
 
-      outputParticles->push_back(LArPandoraOutput::BuildPFParticle(pPfo, pfoId, pfoVector));
+      outputParticles->push_back(LArPandoraOutput::BuildPFParticle(pPfo, pfoId, idIndex));
 
       // Associations from PFParticle
-      if (pfoToVerticesMap.find(pfoId) != pfoToVerticesMap.end())
-        LArPandoraOutput::AddAssociation(
-          event, instanceLabel, pfoId, pfoToVerticesMap, outputParticlesToVertices);
+      const IdToIdVectorMap::const_iterator verticesIter(pfoToVerticesMap.find(pfoId));
+      if (pfoToVerticesMap.end() != verticesIter)
+        context.AddAssociation(pfoId, verticesIter->second, outputParticlesToVertices);
 
-      if (pfoToThreeDHitsMap.find(pfoId) != pfoToThreeDHitsMap.end())
-        LArPandoraOutput::AddAssociation(
-          event, instanceLabel, pfoId, pfoToThreeDHitsMap, outputParticlesToSpacePoints);
+      const IdToIdVectorMap::const_iterator threeDHitsIter(pfoToThreeDHitsMap.find(pfoId));
+      if (pfoToThreeDHitsMap.end() != threeDHitsIter)
+        context.AddAssociation(pfoId, threeDHitsIter->second, outputParticlesToSpacePoints);
 
-      if (pfoToArtClustersMap.find(pfoId) != pfoToArtClustersMap.end())
-        LArPandoraOutput::AddAssociation(
-          event, instanceLabel, pfoId, pfoToArtClustersMap, outputParticlesToClusters);
+      const IdToIdVectorMap::const_iterator clustersIter(pfoToArtClustersMap.find(pfoId));
+      if (pfoToArtClustersMap.end() != clustersIter)
+        context.AddAssociation(pfoId, clustersIter->second, outputParticlesToClusters);
     }
   }
 
@@ -735,24 +751,22 @@ namespace lar_pandora {
 
   void
   LArPandoraOutput::AssociateAdditionalVertices(
-    const art::Event& event,
-    const std::string& instanceLabel,
+    const OutputContext& context,
     const pandora::PfoVector& pfoVector,
     const IdToIdVectorMap& pfoToVerticesMap,
     PFParticleToVertexCollection& outputParticlesToVertices)
   {
     for (unsigned int pfoId = 0; pfoId < pfoVector.size(); ++pfoId) {
-      if (pfoToVerticesMap.find(pfoId) != pfoToVerticesMap.end())
-        LArPandoraOutput::AddAssociation(
-          event, instanceLabel, pfoId, pfoToVerticesMap, outputParticlesToVertices);
+      const IdToIdVectorMap::const_iterator verticesIter(pfoToVerticesMap.find(pfoId));
+      if (pfoToVerticesMap.end() != verticesIter)
+        context.AddAssociation(pfoId, verticesIter->second, outputParticlesToVertices);
     }
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandoraOutput::BuildParticleMetadata(const art::Event& event,
-                                          const std::string& instanceLabel,
+  LArPandoraOutput::BuildParticleMetadata(const OutputContext& context,
                                           const pandora::PfoVector& pfoVector,
                                           PFParticleMetadataCollection& outputParticleMetadata,
                                           PFParticleToMetadataCollection& outputParticlesToMetadata)
@@ -760,11 +774,7 @@ namespace lar_pandora {
     for (unsigned int pfoId = 0; pfoId < pfoVector.size(); ++pfoId) {
       const pandora::ParticleFlowObject* const pPfo(pfoVector.at(pfoId));
 
-      LArPandoraOutput::AddAssociation(event,
-                                       instanceLabel,
-                                       pfoId,
-                                       outputParticleMetadata->size(),
-                                       outputParticlesToMetadata);
+      context.AddAssociation(pfoId, outputParticleMetadata->size(), outputParticlesToMetadata);
       larpandoraobj::PFParticleMetadata pPFParticleMetadata(
         LArPandoraHelper::GetPFParticleMetadata(pPfo));
       outputParticleMetadata->push_back(pPFParticleMetadata);
@@ -776,9 +786,9 @@ namespace lar_pandora {
   void
   LArPandoraOutput::BuildSlices(const Settings& settings,
                                 const pandora::Pandora* const pPrimaryPandora,
-                                const art::Event& event,
-                                const std::string& instanceLabel,
+                                const OutputContext& context,
                                 const pandora::PfoVector& pfoVector,
+                                const PfoAncestry& pfoAncestry,
                                 const IdToHitMap& idToHitMap,
                                 SliceCollection& outputSlices,
                                 PFParticleToSliceCollection& outputParticlesToSlices,
@@ -787,8 +797,7 @@ namespace lar_pandora {
     // Check for the special case in which there are no slices, and only the neutrino reconstruction was used on all hits
     if (settings.m_isNeutrinoRecoOnlyNoSlicing) {
       LArPandoraOutput::CopyAllHitsToSingleSlice(settings,
-                                                 event,
-                                                 instanceLabel,
+                                                 context,
                                                  pfoVector,
                                                  idToHitMap,
                                                  outputSlices,
@@ -804,22 +813,20 @@ namespace lar_pandora {
     // Make one slice per Pandora Slice pfo
     for (const pandora::ParticleFlowObject* const pSlicePfo : slicePfos)
       LArPandoraOutput::BuildSlice(
-        pSlicePfo, event, instanceLabel, idToHitMap, outputSlices, outputSlicesToHits);
+        pSlicePfo, context, idToHitMap, outputSlices, outputSlicesToHits);
 
     // Make a slice for every remaining pfo hierarchy that wasn't already in a slice
-    std::unordered_map<const pandora::ParticleFlowObject*, unsigned int> parentPfoToSliceIndexMap;
+    std::unordered_map<size_t, unsigned int> parentPfoIdToSliceIndexMap;
     for (unsigned int pfoId = 0; pfoId < pfoVector.size(); ++pfoId) {
-      const pandora::ParticleFlowObject* const pPfo(pfoVector.at(pfoId));
-
       // If this PFO is the parent of a hierarchy we have yet to use, then add a new slice
-      if (LArPandoraOutput::IsFromSlice(pPfo)) continue;
+      if (pfoAncestry.IsFromSlice(pfoId)) continue;
 
-      if (lar_content::LArPfoHelper::GetParentPfo(pPfo) != pPfo) continue;
+      if (pfoAncestry.GetRootId(pfoId) != pfoId) continue;
 
-      if (!parentPfoToSliceIndexMap
-             .emplace(pPfo,
+      if (!parentPfoIdToSliceIndexMap
+             .emplace(pfoId,
                       LArPandoraOutput::BuildSlice(
-                        pPfo, event, instanceLabel, idToHitMap, outputSlices, outputSlicesToHits))
+                        pfoVector[pfoId], context, idToHitMap, outputSlices, outputSlicesToHits))
              .second)
         throw cet::exception("LArPandora")
           << " LArPandoraOutput::BuildSlices --- found repeated primary particles ";
@@ -827,28 +834,20 @@ namespace lar_pandora {
 
     // Add the associations from PFOs to slices
     for (unsigned int pfoId = 0; pfoId < pfoVector.size(); ++pfoId) {
-      const pandora::ParticleFlowObject* const pPfo(pfoVector.at(pfoId));
-
       // For PFOs that are from a Pandora slice, add the association and move on to the next PFO
-      if (LArPandoraOutput::IsFromSlice(pPfo)) {
-        LArPandoraOutput::AddAssociation(event,
-                                         instanceLabel,
-                                         pfoId,
-                                         LArPandoraOutput::GetSliceIndex(pPfo),
-                                         outputParticlesToSlices);
+      if (pfoAncestry.IsFromSlice(pfoId)) {
+        context.AddAssociation(pfoId, pfoAncestry.GetSliceIndex(pfoId), outputParticlesToSlices);
         continue;
       }
 
       // Get the parent of the particle
-      const pandora::ParticleFlowObject* const pParent(
-        lar_content::LArPfoHelper::GetParentPfo(pPfo));
-      if (parentPfoToSliceIndexMap.find(pParent) == parentPfoToSliceIndexMap.end())
+      const auto it(parentPfoIdToSliceIndexMap.find(pfoAncestry.GetRootId(pfoId)));
+      if (it == parentPfoIdToSliceIndexMap.end())
         throw cet::exception("LArPandora")
           << " LArPandoraOutput::BuildSlices --- found pfo without a parent in the input list ";
 
       // Add the association from the PFO to the slice
-      LArPandoraOutput::AddAssociation(
-        event, instanceLabel, pfoId, parentPfoToSliceIndexMap.at(pParent), outputParticlesToSlices);
+      context.AddAssociation(pfoId, it->second, outputParticlesToSlices);
     }
   }
 
@@ -873,8 +872,7 @@ namespace lar_pandora {
 
   void
   LArPandoraOutput::CopyAllHitsToSingleSlice(const Settings& settings,
-                                             const art::Event& event,
-                                             const std::string& instanceLabel,
+                                             const OutputContext& context,
                                              const pandora::PfoVector& pfoVector,
                                              const IdToHitMap& idToHitMap,
                                              SliceCollection& outputSlices,
@@ -885,8 +883,8 @@ namespace lar_pandora {
 
     // Add all of the hits in the events to the slice
     HitVector hits;
-    LArPandoraHelper::CollectHits(event, settings.m_hitfinderModuleLabel, hits);
-    LArPandoraOutput::AddAssociation(event, instanceLabel, sliceIndex, hits, outputSlicesToHits);
+    LArPandoraHelper::CollectHits(context.GetEvent(), settings.m_hitfinderModuleLabel, hits);
+    context.AddAssociation(sliceIndex, hits, outputSlicesToHits);
 
     mf::LogDebug("LArPandora") << "Finding hits with label: " << settings.m_hitfinderModuleLabel
                                << std::endl;
@@ -896,16 +894,14 @@ namespace lar_pandora {
 
     // Add all of the PFOs to the slice
     for (unsigned int pfoId = 0; pfoId < pfoVector.size(); ++pfoId)
-      LArPandoraOutput::AddAssociation(
-        event, instanceLabel, pfoId, sliceIndex, outputParticlesToSlices);
+      context.AddAssociation(pfoId, sliceIndex, outputParticlesToSlices);
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   unsigned int
   LArPandoraOutput::BuildSlice(const pandora::ParticleFlowObject* const pParentPfo,
-                               const art::Event& event,
-                               const std::string& instanceLabel,
+                               const OutputContext& context,
                                const IdToHitMap& idToHitMap,
                                SliceCollection& outputSlices,
                                SliceToHitCollection& outputSlicesToHits)
@@ -928,12 +924,13 @@ namespace lar_pandora {
     }
 
     // Add the associations to the hits
+    HitVector sliceHits;
+    sliceHits.reserve(hits.size());
+
     for (const pandora::CaloHit* const pCaloHit : hits)
-      LArPandoraOutput::AddAssociation(event,
-                                       instanceLabel,
-                                       sliceIndex,
-                                       {LArPandoraOutput::GetHit(idToHitMap, pCaloHit)},
-                                       outputSlicesToHits);
+      sliceHits.push_back(LArPandoraOutput::GetHit(idToHitMap, pCaloHit));
+
+    context.AddAssociation(sliceIndex, sliceHits, outputSlicesToHits);
 
     return sliceIndex;
   }
@@ -941,21 +938,24 @@ namespace lar_pandora {
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   void
-  LArPandoraOutput::BuildT0s(const art::Event& event,
-                             const std::string& instanceLabel,
+  LArPandoraOutput::BuildT0s(const OutputContext& context,
+                             const ConversionCache& conversionCache,
                              const pandora::PfoVector& pfoVector,
+                             const PfoAncestry& pfoAncestry,
                              T0Collection& outputT0s,
                              PFParticleToT0Collection& outputParticlesToT0s)
   {
+    // ATTN The detector clocks and properties are taken once for the event, not requested from the services for each pfo
+    const detinfo::DetectorClocksData& clockData(conversionCache.GetDetectorClocksData());
+    const detinfo::DetectorPropertiesData& detProp(conversionCache.GetDetectorPropertiesData());
+
     size_t nextT0Id(0);
     for (unsigned int pfoId = 0; pfoId < pfoVector.size(); ++pfoId) {
-      const pandora::ParticleFlowObject* const pPfo(pfoVector.at(pfoId));
-
       anab::T0 t0;
-      if (!LArPandoraOutput::BuildT0(event, pPfo, pfoVector, nextT0Id, t0)) continue;
+      if (!LArPandoraOutput::BuildT0(clockData, detProp, pfoAncestry, pfoId, nextT0Id, t0))
+        continue;
 
-      LArPandoraOutput::AddAssociation(
-        event, instanceLabel, pfoId, nextT0Id - 1, outputParticlesToT0s);
+      context.AddAssociation(pfoId, nextT0Id - 1, outputParticlesToT0s);
       outputT0s->push_back(t0);
     }
   }
@@ -965,7 +965,7 @@ namespace lar_pandora {
   recob::PFParticle
   LArPandoraOutput::BuildPFParticle(const pandora::ParticleFlowObject* const pPfo,
                                     const size_t pfoId,
-                                    const pandora::PfoVector& pfoVector)
+                                    const IdIndex& idIndex)
   {
     // Get parent Pfo ID
     const pandora::PfoList& parentList(pPfo->GetParentPfoList());
@@ -975,12 +975,12 @@ namespace lar_pandora {
 
     const size_t parentId(parentList.empty() ?
                             recob::PFParticle::kPFParticlePrimary :
-                            LArPandoraOutput::GetId(parentList.front(), pfoVector));
+                            idIndex.GetId(parentList.front()));
 
     // Get daughters Pfo IDs
     std::vector<size_t> daughterIds;
     for (const pandora::ParticleFlowObject* const pDaughterPfo : pPfo->GetDaughterPfoList())
-      daughterIds.push_back(LArPandoraOutput::GetId(pDaughterPfo, pfoVector));
+      daughterIds.push_back(idIndex.GetId(pDaughterPfo));
 
     std::sort(daughterIds.begin(), daughterIds.end());
 
@@ -1020,37 +1020,28 @@ namespace lar_pandora {
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
-  std::vector<recob::Cluster>
-  LArPandoraOutput::BuildClusters(util::GeometryUtilities const& gser,
-                                  const pandora::Cluster* const pCluster,
-                                  const pandora::ClusterList& clusterList,
-                                  const CaloHitToArtHitMap& pandoraHitToArtHitMap,
-                                  IdToIdVectorMap& pandoraClusterToArtClustersMap,
-                                  std::vector<HitVector>& hitVectors,
-                                  size_t& nextId,
-                                  cluster::ClusterParamsAlgBase& algo)
+  void
+  LArPandoraOutput::SplitCluster(const size_t clusterIndex,
+                                 const pandora::Cluster* const pCluster,
+                                 const ArtHitTable& artHitTable,
+                                 IdToIdVectorMap& pandoraClusterToArtClustersMap,
+                                 std::vector<HitVector>& hitVectors,
+                                 HitList& isolatedHits)
   {
-    std::vector<recob::Cluster> clusters;
-
-    // Get the cluster ID and set up the map entry
-    const size_t clusterId(LArPandoraOutput::GetId(pCluster, clusterList));
-    if (!pandoraClusterToArtClustersMap.insert(IdToIdVectorMap::value_type(clusterId, {})).second)
+    // Set up the map entry; the cluster ID is its position in the input list of 2D clusters
+    if (!pandoraClusterToArtClustersMap.insert(IdToIdVectorMap::value_type(clusterIndex, {})).second)
       throw cet::exception("LArPandora")
         << " LArPandoraOutput::BuildClusters --- repeated clusters in input list ";
 
-    pandora::CaloHitVector sortedHits;
-    LArPandoraOutput::GetHitsInCluster(pCluster, sortedHits);
-
     HitArray hitArray; // hits organised by drift volume
-    HitList isolatedHits;
-
-    for (const pandora::CaloHit* const pCaloHit2D : sortedHits) {
-      CaloHitToArtHitMap::const_iterator it(pandoraHitToArtHitMap.find(pCaloHit2D));
-      if (it == pandoraHitToArtHitMap.end())
-        throw cet::exception("LArPandora")
-          << " LArPandoraOutput::BuildClusters --- couldn't find art hit for input pandora hit ";
 
-      const art::Ptr<recob::Hit> hit(it->second);
+    // ATTN The hits of the cluster are held in the art hit table, already sorted by position
+    for (size_t hitIndex = artHitTable.GetClusterBegin(pCluster),
+                hitIndexEnd = artHitTable.GetClusterEnd(pCluster);
+         hitIndex < hitIndexEnd;
+         ++hitIndex) {
+      const pandora::CaloHit* const pCaloHit2D(artHitTable.GetTwoDCaloHit(hitIndex));
+      const art::Ptr<recob::Hit>& hit(artHitTable.GetTwoDArtHit(hitIndex));
 
       const geo::WireID wireID(hit->WireID());
       const unsigned int volID(100000 * wireID.Cryostat + wireID.TPC);
@@ -1063,18 +1054,10 @@ namespace lar_pandora {
       throw cet::exception("LArPandora")
         << " LArPandoraOutput::BuildClusters --- found a cluster with no hits ";
 
-    for (const HitArray::value_type& hitArrayEntry : hitArray) {
-      const HitVector& clusterHits(hitArrayEntry.second);
-
-      clusters.push_back(
-        LArPandoraOutput::BuildCluster(gser, nextId, clusterHits, isolatedHits, algo));
-      hitVectors.push_back(clusterHits);
-      pandoraClusterToArtClustersMap.at(clusterId).push_back(nextId);
-
-      nextId++;
+    for (HitArray::value_type& hitArrayEntry : hitArray) {
+      pandoraClusterToArtClustersMap.at(clusterIndex).push_back(hitVectors.size());
+      hitVectors.push_back(std::move(hitArrayEntry.second));
     }
-
-    return clusters;
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
@@ -1163,9 +1146,42 @@ namespace lar_pandora {
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
+  recob::Cluster
+  LArPandoraOutput::CopyCluster(const recob::Cluster& cluster, const size_t id)
+  {
+    return recob::Cluster(cluster.StartWire(),
+                          cluster.SigmaStartWire(),
+                          cluster.StartTick(),
+                          cluster.SigmaStartTick(),
+                          cluster.StartCharge(),
+                          cluster.StartAngle(),
+                          cluster.StartOpeningAngle(),
+                          cluster.EndWire(),
+                          cluster.SigmaEndWire(),
+                          cluster.EndTick(),
+                          cluster.SigmaEndTick(),
+                          cluster.EndCharge(),
+                          cluster.EndAngle(),
+                          cluster.EndOpeningAngle(),
+                          cluster.Integral(),
+                          cluster.IntegralStdDev(),
+                          cluster.SummedADC(),
+                          cluster.SummedADCstdDev(),
+                          cluster.NHits(),
+                          cluster.MultipleHitDensity(),
+                          cluster.Width(),
+                          id,
+                          cluster.View(),
+                          cluster.Plane(),
+                          recob::Cluster::Sentry);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
   recob::SpacePoint
   LArPandoraOutput::BuildSpacePoint(const pandora::CaloHit* const pCaloHit,
-                                    const size_t spacePointId)
+                                    const size_t spacePointId,
+                                    const SpacePointErrorModel& spacePointErrorModel)
   {
     if (pandora::TPC_3D != pCaloHit->GetHitType())
       throw cet::exception("LArPandora")
@@ -1174,8 +1190,10 @@ namespace lar_pandora {
     const pandora::CartesianVector point(pCaloHit->GetPositionVector());
     double xyz[3] = {point.GetX(), point.GetY(), point.GetZ()};
 
-    // ATTN using dummy information
-    double dxdydz[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0}; // TODO: Fill in the error matrix
+    double dxdydz[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    spacePointErrorModel.GetErrorMatrix(pCaloHit, dxdydz);
+
+    // ATTN using dummy information, as pandora provides no goodness of fit for its 3D hits
     double chi2(0.0);
 
     return recob::SpacePoint(xyz, dxdydz, chi2, spacePointId);
@@ -1184,21 +1202,17 @@ namespace lar_pandora {
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   bool
-  LArPandoraOutput::BuildT0(const art::Event& e,
-                            const pandora::ParticleFlowObject* const pPfo,
-                            const pandora::PfoVector& pfoVector,
+  LArPandoraOutput::BuildT0(const detinfo::DetectorClocksData& clockData,
+                            const detinfo::DetectorPropertiesData& detProp,
+                            const PfoAncestry& pfoAncestry,
+                            const size_t pfoId,
                             size_t& nextId,
                             anab::T0& t0)
   {
-    const pandora::ParticleFlowObject* const pParent(lar_content::LArPfoHelper::GetParentPfo(pPfo));
-    const float x0(pParent->GetPropertiesMap().count("X0") ? pParent->GetPropertiesMap().at("X0") :
-                                                             0.f);
+    const float x0(pfoAncestry.GetX0(pfoId));
 
-    auto const clock_data = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(e);
-    auto const det_prop =
-      art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(e, clock_data);
-    const double cm_per_tick(det_prop.GetXTicksCoefficient());
-    const double ns_per_tick(sampling_rate(clock_data));
+    const double cm_per_tick(detProp.GetXTicksCoefficient());
+    const double ns_per_tick(sampling_rate(clockData));
 
     // ATTN: T0 values are currently calculated in nanoseconds relative to the trigger offset. Only non-zero values are outputted.
     const double T0(x0 * ns_per_tick / cm_per_tick);
@@ -1206,7 +1220,7 @@ namespace lar_pandora {
     if (std::fabs(T0) <= std::numeric_limits<double>::epsilon()) return false;
 
     // Output T0 objects [arguments are:  time (nanoseconds);  trigger type (3 for TPC stitching!);  pfparticle SelfID code;  T0 ID code]
-    t0 = anab::T0(T0, 3, LArPandoraOutput::GetId(pPfo, pfoVector), nextId++);
+    t0 = anab::T0(T0, 3, pfoId, nextId++);
 
     return true;
   }
@@ -1214,12 +1228,403 @@ namespace lar_pandora {
   //------------------------------------------------------------------------------------------------------------------------------------------
   //------------------------------------------------------------------------------------------------------------------------------------------
 
+  LArPandoraOutput::IdIndex::IdIndex(const pandora::PfoVector& pfoVector,
+                                     const pandora::VertexVector& vertexVector,
+                                     const pandora::ClusterList& clusterList,
+                                     const pandora::CaloHitList& threeDHitList)
+  {
+    LArPandoraOutput::FillIdMap(pfoVector, m_pfoIdMap);
+    LArPandoraOutput::FillIdMap(vertexVector, m_vertexIdMap);
+    LArPandoraOutput::FillIdMap(clusterList, m_clusterIdMap);
+    LArPandoraOutput::FillIdMap(threeDHitList, m_threeDHitIdMap);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  size_t
+  LArPandoraOutput::IdIndex::GetId(const pandora::ParticleFlowObject* const pPfo) const
+  {
+    return LArPandoraOutput::GetId(pPfo, m_pfoIdMap);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  size_t
+  LArPandoraOutput::IdIndex::GetId(const pandora::Vertex* const pVertex) const
+  {
+    return LArPandoraOutput::GetId(pVertex, m_vertexIdMap);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  size_t
+  LArPandoraOutput::IdIndex::GetId(const pandora::Cluster* const pCluster) const
+  {
+    return LArPandoraOutput::GetId(pCluster, m_clusterIdMap);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  size_t
+  LArPandoraOutput::IdIndex::GetId(const pandora::CaloHit* const pCaloHit) const
+  {
+    return LArPandoraOutput::GetId(pCaloHit, m_threeDHitIdMap);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArPandoraOutput::PfoAncestry::PfoAncestry(const pandora::PfoVector& pfoVector,
+                                             const IdIndex& idIndex)
+    : m_rootIds(pfoVector.size(), std::numeric_limits<size_t>::max())
+    , m_sliceIndices(pfoVector.size(), std::numeric_limits<unsigned int>::max())
+    , m_x0s(pfoVector.size(), 0.f)
+    , m_isClearCosmics(pfoVector.size(), false)
+  {
+    // The property names are looked up once, rather than converted to strings for every query
+    static const std::string sliceIndexName("SliceIndex"), x0Name("X0"), isClearCosmicName("IsClearCosmic");
+
+    IdVector chainIds;
+    for (size_t pfoId = 0; pfoId < pfoVector.size(); ++pfoId) {
+      // Walk up the hierarchy until reaching the root parent, or a pfo whose root parent is already known
+      size_t rootId(pfoId);
+      chainIds.clear();
+
+      while (std::numeric_limits<size_t>::max() == m_rootIds[rootId]) {
+        const pandora::PfoList& parentList(pfoVector[rootId]->GetParentPfoList());
+
+        if (parentList.empty()) {
+          m_rootIds[rootId] = rootId;
+          break;
+        }
+
+        chainIds.push_back(rootId);
+        rootId = idIndex.GetId(parentList.front());
+      }
+
+      rootId = m_rootIds[rootId];
+
+      for (const size_t chainId : chainIds)
+        m_rootIds[chainId] = rootId;
+
+      if (rootId != pfoId) continue;
+
+      // Read the properties of the root parent
+      const auto& properties(pfoVector[pfoId]->GetPropertiesMap());
+      const auto sliceIndexIter(properties.find(sliceIndexName));
+      const auto x0Iter(properties.find(x0Name));
+      const auto isClearCosmicIter(properties.find(isClearCosmicName));
+
+      if (sliceIndexIter != properties.end())
+        m_sliceIndices[pfoId] = static_cast<unsigned int>(std::round(sliceIndexIter->second));
+
+      if (x0Iter != properties.end()) m_x0s[pfoId] = x0Iter->second;
+
+      if (isClearCosmicIter != properties.end())
+        m_isClearCosmics[pfoId] = static_cast<bool>(std::round(isClearCosmicIter->second));
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArPandoraOutput::ArtHitTable::ArtHitTable(const IdToHitMap& idToHitMap)
+    : m_idToHitMap(idToHitMap), m_clusterOffsets(1, 0)
+  {}
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraOutput::ArtHitTable::AddView(const pandora::ClusterList& clusterList,
+                                         const pandora::CaloHitList& threeDHitList)
+  {
+    pandora::CaloHitVector inputHits;
+
+    // Collect 2D hits from clusters
+    for (const pandora::Cluster* const pCluster : clusterList) {
+      if (pandora::TPC_3D == lar_content::LArClusterHelper::GetClusterHitType(pCluster))
+        throw cet::exception("LArPandora")
+          << " LArPandoraOutput::ArtHitTable --- found a 3D input cluster ";
+
+      const auto insertion(m_clusterIdMap.emplace(pCluster, m_clusterOffsets.size() - 1));
+      const size_t clusterId(insertion.first->second);
+
+      if (insertion.second) {
+        pandora::CaloHitVector sortedHits;
+        LArPandoraOutput::GetHitsInCluster(pCluster, sortedHits);
+
+        for (const pandora::CaloHit* const pCaloHit : sortedHits) {
+          m_twoDCaloHits.push_back(pCaloHit);
+          m_twoDArtHits.push_back(LArPandoraOutput::GetHit(m_idToHitMap, pCaloHit));
+        }
+
+        m_clusterOffsets.push_back(m_twoDCaloHits.size());
+      }
+
+      inputHits.insert(inputHits.end(),
+                       m_twoDCaloHits.begin() + m_clusterOffsets[clusterId],
+                       m_twoDCaloHits.begin() + m_clusterOffsets[clusterId + 1]);
+    }
+
+    for (const pandora::CaloHit* const pCaloHit : threeDHitList) {
+      if (pCaloHit->GetHitType() != pandora::TPC_3D)
+        throw cet::exception("LArPandora")
+          << " LArPandoraOutput::ArtHitTable --- found a non-3D hit in the input list ";
+
+      // ATTN get the 2D calo hit from the 3D calo hit then find the art hit!
+      if (m_threeDHitIdMap.emplace(pCaloHit, m_threeDArtHits.size()).second)
+        m_threeDArtHits.push_back(LArPandoraOutput::GetHit(
+          m_idToHitMap, static_cast<const pandora::CaloHit*>(pCaloHit->GetParentAddress())));
+
+      inputHits.push_back(pCaloHit);
+    }
+
+    // Each pandora hit may be output only once by a view; check by sorting the hit addresses, rather than inserting them into a map
+    std::sort(inputHits.begin(), inputHits.end());
+
+    if (inputHits.end() != std::adjacent_find(inputHits.begin(), inputHits.end()))
+      throw cet::exception("LArPandora")
+        << " LArPandoraOutput::ArtHitTable --- found repeated input hits ";
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArPandoraOutput::OutputContext::OutputContext(const art::Event& event,
+                                                 const std::string& instanceLabel)
+    : m_event(event), m_instanceLabel(instanceLabel)
+  {}
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArPandoraOutput::ConversionCache::ConversionCache(const art::Event& event,
+                                                     const bool shouldStoreClusters)
+    : m_clockData(art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event))
+    , m_detProp(
+        art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event, m_clockData))
+    , m_geometryUtilities(*art::ServiceHandle<geo::Geometry const>(), m_clockData, m_detProp)
+    , m_shouldStoreClusters(shouldStoreClusters)
+  {}
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraOutput::ConversionCache::GetClusters(const std::vector<HitVector>& hitVectors,
+                                                 const HitList& isolatedHits,
+                                                 std::vector<recob::Cluster>& clusters)
+  {
+    clusters.assign(hitVectors.size(), recob::Cluster());
+
+    // Copy the clusters already built from the same hits, by an earlier output view
+    IdVector buildIds;
+    std::vector<std::uint64_t> buildKeys;
+    std::vector<std::vector<bool>> buildIsolatedFlags;
+
+    for (size_t id = 0; id < hitVectors.size(); ++id) {
+      if (m_shouldStoreClusters) {
+        std::vector<bool> isolatedFlags;
+        isolatedFlags.reserve(hitVectors[id].size());
+
+        for (const art::Ptr<recob::Hit>& hit : hitVectors[id])
+          isolatedFlags.push_back(isolatedHits.count(hit) > 0);
+
+        const std::uint64_t clusterKey(ConversionCache::GetClusterKey(hitVectors[id], isolatedFlags));
+        const recob::Cluster* const pStoredCluster(
+          this->FindCluster(clusterKey, hitVectors[id], isolatedFlags));
+
+        // ATTN The cluster parameters depend only upon the hits, so a stored cluster need only be given the new id
+        if (pStoredCluster) {
+          clusters[id] = LArPandoraOutput::CopyCluster(*pStoredCluster, id);
+          continue;
+        }
+
+        buildKeys.push_back(clusterKey);
+        buildIsolatedFlags.push_back(std::move(isolatedFlags));
+      }
+
+      buildIds.push_back(id);
+    }
+
+    // Build the remaining clusters; the parameters of each are independent, so are calculated concurrently
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, buildIds.size()),
+                      [&](const tbb::blocked_range<size_t>& range) {
+                        cluster::StandardClusterParamsAlg& algo(m_clusterParamsAlgs.local());
+
+                        for (size_t index = range.begin(); index != range.end(); ++index) {
+                          const size_t id(buildIds[index]);
+                          clusters[id] = LArPandoraOutput::BuildCluster(
+                            m_geometryUtilities, id, hitVectors[id], isolatedHits, algo);
+                        }
+                      });
+
+    if (!m_shouldStoreClusters) return;
+
+    for (size_t index = 0; index < buildIds.size(); ++index) {
+      const size_t id(buildIds[index]);
+      m_clusterMap.emplace(
+        buildKeys[index],
+        StoredCluster{hitVectors[id], std::move(buildIsolatedFlags[index]), clusters[id]});
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  std::uint64_t
+  LArPandoraOutput::ConversionCache::GetClusterKey(const HitVector& hitVector,
+                                                   const std::vector<bool>& isolatedFlags)
+  {
+    LArPandoraFingerprint fingerprint;
+
+    for (size_t index = 0; index < hitVector.size(); ++index) {
+      fingerprint.AddValue(hitVector[index].id().value());
+      fingerprint.AddValue(hitVector[index].key());
+      fingerprint.AddValue(static_cast<bool>(isolatedFlags[index]));
+    }
+
+    return fingerprint.GetValue();
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  const recob::Cluster*
+  LArPandoraOutput::ConversionCache::FindCluster(const std::uint64_t clusterKey,
+                                                 const HitVector& hitVector,
+                                                 const std::vector<bool>& isolatedFlags) const
+  {
+    const std::pair<ClusterMap::const_iterator, ClusterMap::const_iterator> range(
+      m_clusterMap.equal_range(clusterKey));
+
+    for (ClusterMap::const_iterator iter = range.first; iter != range.second; ++iter) {
+      const StoredCluster& storedCluster(iter->second);
+
+      if ((storedCluster.m_hitVector == hitVector) &&
+          (storedCluster.m_isolatedFlags == isolatedFlags))
+        return &storedCluster.m_cluster;
+    }
+
+    return nullptr;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArPandoraOutput::SpacePointErrorModel::SpacePointErrorModel(const pandora::Pandora& pandora)
+  {
+    const pandora::LArTransformationPlugin* const pTransformationPlugin(
+      pandora.GetPlugins()->GetLArTransformationPlugin());
+
+    // The wire coordinate of each view is linear in y and z, so its gradient is the direction across the wires
+    for (const pandora::HitType hitType :
+         {pandora::TPC_VIEW_U, pandora::TPC_VIEW_V, pandora::TPC_VIEW_W}) {
+      double wire0(0.), wireY(0.), wireZ(0.);
+
+      if (pandora::TPC_VIEW_U == hitType) {
+        wire0 = pTransformationPlugin->YZtoU(0., 0.);
+        wireY = pTransformationPlugin->YZtoU(1., 0.);
+        wireZ = pTransformationPlugin->YZtoU(0., 1.);
+      }
+      else if (pandora::TPC_VIEW_V == hitType) {
+        wire0 = pTransformationPlugin->YZtoV(0., 0.);
+        wireY = pTransformationPlugin->YZtoV(1., 0.);
+        wireZ = pTransformationPlugin->YZtoV(0., 1.);
+      }
+      else {
+        wire0 = pTransformationPlugin->YZtoW(0., 0.);
+        wireY = pTransformationPlugin->YZtoW(1., 0.);
+        wireZ = pTransformationPlugin->YZtoW(0., 1.);
+      }
+
+      const double acrossY(wireY - wire0), acrossZ(wireZ - wire0);
+      const double norm(std::sqrt(acrossY * acrossY + acrossZ * acrossZ));
+
+      if (norm < std::numeric_limits<double>::epsilon())
+        throw cet::exception("LArPandora") << " LArPandoraOutput::SpacePointErrorModel --- "
+                                              "found a view without a wire direction ";
+
+      m_acrossY.push_back(acrossY / norm);
+      m_acrossZ.push_back(acrossZ / norm);
+    }
+
+    // The other views measure the position along the wires of a view, each in proportion to the projection of its direction
+    for (unsigned int view = 0; view < m_acrossY.size(); ++view) {
+      const double alongY(-m_acrossZ[view]), alongZ(m_acrossY[view]);
+      double sumProjections(0.);
+
+      for (unsigned int otherView = 0; otherView < m_acrossY.size(); ++otherView) {
+        if (otherView == view) continue;
+
+        const double projection(alongY * m_acrossY[otherView] + alongZ * m_acrossZ[otherView]);
+        sumProjections += projection * projection;
+      }
+
+      if (sumProjections < std::numeric_limits<double>::epsilon())
+        throw cet::exception("LArPandora") << " LArPandoraOutput::SpacePointErrorModel --- the "
+                                              "views do not measure the position along the wires ";
+
+      m_alongScales.push_back(1. / sumProjections);
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  LArPandoraOutput::SpacePointErrorModel::GetErrorMatrix(const pandora::CaloHit* const pCaloHit,
+                                                         double errorMatrix[6]) const
+  {
+    if (pandora::TPC_3D != pCaloHit->GetHitType())
+      throw cet::exception("LArPandora") << " LArPandoraOutput::SpacePointErrorModel --- trying "
+                                            "to find the error matrix of a 2D hit";
+
+    // ATTN The wire pitch and drift width are those of the parent 2D hit
+    const pandora::CaloHit* const pParentCaloHit(
+      static_cast<const pandora::CaloHit*>(pCaloHit->GetParentAddress()));
+    const unsigned int view(SpacePointErrorModel::GetViewIndex(pParentCaloHit->GetHitType()));
+
+    const double pitch(pParentCaloHit->GetCellThickness());
+    const double acrossVariance(pitch * pitch / 12.);
+    const double alongVariance(acrossVariance * m_alongScales[view]);
+    const double halfWidth(0.5 * pParentCaloHit->GetCellSize1());
+
+    const double acrossY(m_acrossY[view]), acrossZ(m_acrossZ[view]);
+    const double alongY(-acrossZ), alongZ(acrossY);
+
+    errorMatrix[0] = halfWidth * halfWidth;
+    errorMatrix[1] = 0.;
+    errorMatrix[2] = acrossVariance * acrossY * acrossY + alongVariance * alongY * alongY;
+    errorMatrix[3] = 0.;
+    errorMatrix[4] = acrossVariance * acrossY * acrossZ + alongVariance * alongY * alongZ;
+    errorMatrix[5] = acrossVariance * acrossZ * acrossZ + alongVariance * alongZ * alongZ;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  unsigned int
+  LArPandoraOutput::SpacePointErrorModel::GetViewIndex(const pandora::HitType hitType)
+  {
+    if (pandora::TPC_VIEW_U == hitType) { return 0; }
+    else if (pandora::TPC_VIEW_V == hitType) {
+      return 1;
+    }
+    else if (pandora::TPC_VIEW_W == hitType) {
+      return 2;
+    }
+    else {
+      throw cet::exception("LArPandora")
+        << " LArPandoraOutput::SpacePointErrorModel --- found a 3D hit without a 2D parent hit ";
+    }
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
   LArPandoraOutput::Settings::Settings()
     : m_pPrimaryPandora(nullptr)
     , m_shouldRunStitching(false)
     , m_shouldProduceAllOutcomes(false)
     , m_shouldProduceTestBeamInteractionVertices(false)
     , m_isNeutrinoRecoOnlyNoSlicing(false)
+    , m_pStageMeasurements(nullptr)
   {}
 
   //------------------------------------------------------------------------------------------------------------------------------------------
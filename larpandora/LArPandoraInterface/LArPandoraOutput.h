@@ -8,24 +8,35 @@
 #define LAR_PANDORA_OUTPUT_H
 
 #include "art/Persistency/Common/PtrMaker.h"
+#include "lardata/DetectorInfo/DetectorClocksData.h"
+#include "lardata/DetectorInfo/DetectorPropertiesData.h"
 #include "lardata/Utilities/AssociationUtil.h"
+#include "lardata/Utilities/GeometryUtilities.h"
 
 #include "lardataobj/RecoBase/Cluster.h"
 #include "lardataobj/RecoBase/PFParticleMetadata.h"
 
 #include "larreco/RecoAlg/ClusterRecoUtil/ClusterParamsAlgBase.h"
+#include "larreco/RecoAlg/ClusterRecoUtil/StandardClusterParamsAlg.h"
+
+#include "tbb/enumerable_thread_specific.h"
 
 #include "larpandora/LArPandoraInterface/ILArPandora.h"
 #include "larpandora/LArPandoraInterface/LArPandoraHelper.h"
+#include "larpandora/LArPandoraInterface/LArPandoraInstrumentation.h"
 
 #include "Pandora/PandoraInternal.h"
 
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
 namespace pandora {
   class Pandora;
 }
-namespace util {
-  class GeometryUtilities;
-}
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -35,7 +46,9 @@ namespace lar_pandora {
   public:
     typedef std::vector<size_t> IdVector;
     typedef std::map<size_t, IdVector> IdToIdVectorMap;
-    typedef std::map<const pandora::CaloHit*, art::Ptr<recob::Hit>> CaloHitToArtHitMap;
+
+    template <typename T>
+    using IdMap = std::unordered_map<const T*, size_t>;
 
     typedef std::unique_ptr<std::vector<recob::PFParticle>> PFParticleCollection;
     typedef std::unique_ptr<std::vector<recob::Vertex>> VertexCollection;
@@ -91,17 +104,451 @@ namespace lar_pandora {
       bool
         m_isNeutrinoRecoOnlyNoSlicing; ///< If we are running the neutrino reconstruction only with no slicing
       std::string m_hitfinderModuleLabel; ///< The hit finder module label
+      LArPandoraInstrumentation::StageMeasurements*
+        m_pStageMeasurements; ///< To receive the output stage measurements, nullptr if instrumentation is disabled
+    };
+
+    /**
+     *  @brief  IdIndex class, mapping each pandora object to be output to its id (its position in the output collection)
+     */
+    class IdIndex {
+    public:
+      /**
+         *  @brief  Constructor, build the index once from the immutable lists of pandora objects to be output
+         *
+         *  @param  pfoVector the input vector of pfos
+         *  @param  vertexVector the input vector of vertices
+         *  @param  clusterList the input list of 2D clusters
+         *  @param  threeDHitList the input list of 3D hits
+         */
+      IdIndex(const pandora::PfoVector& pfoVector,
+              const pandora::VertexVector& vertexVector,
+              const pandora::ClusterList& clusterList,
+              const pandora::CaloHitList& threeDHitList);
+
+      /**
+         *  @brief  Get the id of a pfo. Throw an exception if it isn't indexed
+         *
+         *  @param  pPfo the input pfo
+         *
+         *  @return the id of the pfo
+         */
+      size_t GetId(const pandora::ParticleFlowObject* const pPfo) const;
+
+      /**
+         *  @brief  Get the id of a vertex. Throw an exception if it isn't indexed
+         *
+         *  @param  pVertex the input vertex
+         *
+         *  @return the id of the vertex
+         */
+      size_t GetId(const pandora::Vertex* const pVertex) const;
+
+      /**
+         *  @brief  Get the id of a 2D cluster. Throw an exception if it isn't indexed
+         *
+         *  @param  pCluster the input cluster
+         *
+         *  @return the id of the cluster
+         */
+      size_t GetId(const pandora::Cluster* const pCluster) const;
+
+      /**
+         *  @brief  Get the id of a 3D hit. Throw an exception if it isn't indexed
+         *
+         *  @param  pCaloHit the input 3D hit
+         *
+         *  @return the id of the 3D hit
+         */
+      size_t GetId(const pandora::CaloHit* const pCaloHit) const;
+
+    private:
+      IdMap<pandora::ParticleFlowObject> m_pfoIdMap; ///< The mapping from pfo to id
+      IdMap<pandora::Vertex> m_vertexIdMap;          ///< The mapping from vertex to id
+      IdMap<pandora::Cluster> m_clusterIdMap;        ///< The mapping from 2D cluster to id
+      IdMap<pandora::CaloHit> m_threeDHitIdMap;      ///< The mapping from 3D hit to id
+    };
+
+    /**
+     *  @brief  PfoAncestry class, holding the root parent of each pfo to be output and the properties of that parent, so that
+     *          the walk up to the parent and the lookups in its properties map are made once per pfo hierarchy
+     */
+    class PfoAncestry {
+    public:
+      /**
+         *  @brief  Constructor, resolve the ancestry of each pfo once from the immutable list of pfos to be output
+         *
+         *  @param  pfoVector the input vector of pfos
+         *  @param  idIndex the index from pandora objects to their ids
+         */
+      PfoAncestry(const pandora::PfoVector& pfoVector, const IdIndex& idIndex);
+
+      /**
+         *  @brief  Get the id of the root parent of a pfo
+         *
+         *  @param  pfoId the id of the pfo
+         */
+      size_t GetRootId(const size_t pfoId) const;
+
+      /**
+         *  @brief  Check if a pfo is from a pandora slice
+         *
+         *  @param  pfoId the id of the pfo
+         */
+      bool IsFromSlice(const size_t pfoId) const;
+
+      /**
+         *  @brief  Check if a pfo is in the hierarchy of an unambiguous cosmic ray
+         *
+         *  @param  pfoId the id of the pfo
+         */
+      bool IsClearCosmic(const size_t pfoId) const;
+
+      /**
+         *  @brief  Get the index of the slice from which a pfo was produced. Throw an exception if it isn't from a slice
+         *
+         *  @param  pfoId the id of the pfo
+         */
+      unsigned int GetSliceIndex(const size_t pfoId) const;
+
+      /**
+         *  @brief  Get the stitching shift in x of the hierarchy of a pfo, zero if it wasn't stitched
+         *
+         *  @param  pfoId the id of the pfo
+         */
+      float GetX0(const size_t pfoId) const;
+
+    private:
+      IdVector m_rootIds; ///< The id of the root parent of each pfo
+      std::vector<unsigned int>
+        m_sliceIndices; ///< The slice index of each root parent, the maximum unsigned int if not from a slice
+      std::vector<float> m_x0s;                 ///< The stitching shift in x of each root parent
+      std::vector<bool> m_isClearCosmics;       ///< Whether each root parent is an unambiguous cosmic ray
+    };
+
+    /**
+     *  @brief  ArtHitTable class, holding the art hit of each pandora hit to be output in dense arrays: the 2D hits of each
+     *          cluster, sorted by position, and the 3D hits. The table is shared by the output views of an event, so that a
+     *          cluster or 3D hit output in more than one view has its art hits resolved once
+     */
+    class ArtHitTable {
+    public:
+      /**
+         *  @brief  Constructor
+         *
+         *  @param  idToHitMap the input mapping from pandora hit ID to ART hit
+         */
+      ArtHitTable(const IdToHitMap& idToHitMap);
+
+      ArtHitTable(const ArtHitTable&) = delete;
+      ArtHitTable& operator=(const ArtHitTable&) = delete;
+
+      /**
+         *  @brief  Resolve the art hits of the pandora objects to be output by a view, those already in the table being reused.
+         *          Throw an exception if a pandora hit would be output more than once by the view
+         *
+         *  @param  clusterList the input list of 2D clusters of the view
+         *  @param  threeDHitList the input list of 3D hits of the view
+         */
+      void AddView(const pandora::ClusterList& clusterList, const pandora::CaloHitList& threeDHitList);
+
+      /**
+         *  @brief  Get the index of the first 2D hit of a cluster
+         *
+         *  @param  pCluster the address of the 2D cluster
+         */
+      size_t GetClusterBegin(const pandora::Cluster* const pCluster) const;
+
+      /**
+         *  @brief  Get one past the index of the last 2D hit of a cluster
+         *
+         *  @param  pCluster the address of the 2D cluster
+         */
+      size_t GetClusterEnd(const pandora::Cluster* const pCluster) const;
+
+      /**
+         *  @brief  Get a 2D pandora hit
+         *
+         *  @param  hitIndex the index of the 2D hit
+         */
+      const pandora::CaloHit* GetTwoDCaloHit(const size_t hitIndex) const;
+
+      /**
+         *  @brief  Get the art hit of a 2D pandora hit
+         *
+         *  @param  hitIndex the index of the 2D hit
+         */
+      const art::Ptr<recob::Hit>& GetTwoDArtHit(const size_t hitIndex) const;
+
+      /**
+         *  @brief  Get the art hit of a 3D pandora hit
+         *
+         *  @param  pCaloHit the address of the 3D hit
+         */
+      const art::Ptr<recob::Hit>& GetThreeDArtHit(const pandora::CaloHit* const pCaloHit) const;
+
+    private:
+      const IdToHitMap& m_idToHitMap;       ///< The mapping from pandora hit ID to ART hit
+      IdMap<pandora::Cluster> m_clusterIdMap; ///< The mapping from 2D cluster to its position in the table
+      IdVector m_clusterOffsets; ///< The index of the first 2D hit of each cluster, plus one trailing entry
+      pandora::CaloHitVector m_twoDCaloHits;    ///< The 2D hits of all clusters
+      HitVector m_twoDArtHits;                  ///< The art hits of the 2D hits
+      IdMap<pandora::CaloHit> m_threeDHitIdMap; ///< The mapping from 3D hit to its position in the table
+      HitVector m_threeDArtHits;                ///< The art hits of the 3D hits
     };
 
     /**
-     *  @brief  Convert the Pandora PFOs into ART clusters and write into ART event
+     *  @brief  OutputContext class, holding the event, the instance label and one PtrMaker per output product type, so that
+     *          the associations of every output product are added without creating a PtrMaker for each element
+     */
+    class OutputContext {
+    public:
+      /**
+         *  @brief  Constructor
+         *
+         *  @param  event the ART event
+         *  @param  instanceLabel the label for the collections to be produced
+         */
+      OutputContext(const art::Event& event, const std::string& instanceLabel);
+
+      /**
+         *  @brief  Get the ART event
+         */
+      const art::Event& GetEvent() const;
+
+      /**
+         *  @brief  Get the label for the collections to be produced
+         */
+      const std::string& GetInstanceLabel() const;
+
+      /**
+         *  @brief  Add an association between objects with two given ids
+         *
+         *  @param  idA the id of an object of type A
+         *  @param  idB the id of an object of type B to associate to the first object
+         *  @param  association the output association to update
+         */
+      template <typename A, typename B>
+      void AddAssociation(const size_t idA,
+                          const size_t idB,
+                          std::unique_ptr<art::Assns<A, B>>& association) const;
+
+      /**
+         *  @brief  Add associations between an object and a number of objects with given ids
+         *
+         *  @param  idA the id of an object of type A
+         *  @param  idBVector the input vector of IDs of objects of type B to associate
+         *  @param  association the output association to update
+         */
+      template <typename A, typename B>
+      void AddAssociation(const size_t idA,
+                          const IdVector& idBVector,
+                          std::unique_ptr<art::Assns<A, B>>& association) const;
+
+      /**
+         *  @brief  Add an association between an object and an input object
+         *
+         *  @param  idA the id of an object of type A
+         *  @param  pB the input object of type B to associate
+         *  @param  association the output association to update
+         */
+      template <typename A, typename B>
+      void AddAssociation(const size_t idA,
+                          const art::Ptr<B>& pB,
+                          std::unique_ptr<art::Assns<A, B>>& association) const;
+
+      /**
+         *  @brief  Add associations between an object and a number of input objects
+         *
+         *  @param  idA the id of an object of type A
+         *  @param  bVector the input vector of objects of type B to associate
+         *  @param  association the output association to update
+         */
+      template <typename A, typename B>
+      void AddAssociation(const size_t idA,
+                          const std::vector<art::Ptr<B>>& bVector,
+                          std::unique_ptr<art::Assns<A, B>>& association) const;
+
+    private:
+      template <typename T>
+      using PtrMakerPtr = std::unique_ptr<const art::PtrMaker<T>>;
+
+      /**
+         *  @brief  Get the PtrMaker for an output product type, creating it on first use
+         */
+      template <typename T>
+      const art::PtrMaker<T>& GetPtrMaker() const;
+
+      const art::Event& m_event;           ///< The ART event
+      const std::string m_instanceLabel;   ///< The label for the collections to be produced
+      mutable std::tuple<PtrMakerPtr<recob::PFParticle>,
+                         PtrMakerPtr<recob::Vertex>,
+                         PtrMakerPtr<recob::Cluster>,
+                         PtrMakerPtr<recob::SpacePoint>,
+                         PtrMakerPtr<recob::Slice>,
+                         PtrMakerPtr<anab::T0>,
+                         PtrMakerPtr<larpandoraobj::PFParticleMetadata>>
+        m_ptrMakers; ///< Book-keeping: the PtrMaker for each output product type, nullptr until first used
+    };
+
+    /**
+     *  @brief  ConversionCache class, holding the conversion work shared between the output views of an event. The art clusters
+     *          are built concurrently, each thread using its own cluster parameter algorithm. When the all outcomes view is produced
+     *          alongside the consolidated view, each art cluster built is kept, keyed by its hits, so that a cluster found in both
+     *          views is only converted once
+     */
+    class ConversionCache {
+    public:
+      /**
+         *  @brief  Constructor
+         *
+         *  @param  event the ART event
+         *  @param  shouldStoreClusters whether to keep the art clusters built, for reuse by a later output view
+         */
+      ConversionCache(const art::Event& event, const bool shouldStoreClusters);
+
+      ConversionCache(const ConversionCache&) = delete;
+      ConversionCache& operator=(const ConversionCache&) = delete;
+
+      /**
+         *  @brief  Get the detector clocks for the event
+         */
+      const detinfo::DetectorClocksData& GetDetectorClocksData() const;
+
+      /**
+         *  @brief  Get the detector properties for the event
+         */
+      const detinfo::DetectorPropertiesData& GetDetectorPropertiesData() const;
+
+      /**
+         *  @brief  Get the ART clusters for input vectors of ART hits, building concurrently those whose hits have not been converted
+         *
+         *  @param  hitVectors the input vectors of hits, the id code of each cluster being the position of its hits in this vector
+         *  @param  isolatedHits the input list of isolated hits
+         *  @param  clusters to receive the ART clusters, in the order of the input vectors of hits
+         */
+      void GetClusters(const std::vector<HitVector>& hitVectors,
+                       const HitList& isolatedHits,
+                       std::vector<recob::Cluster>& clusters);
+
+    private:
+      /**
+         *  @brief  StoredCluster class, an ART cluster kept for reuse and the hits from which it was built
+         */
+      class StoredCluster {
+      public:
+        HitVector m_hitVector;              ///< The hits of the cluster, in order
+        std::vector<bool> m_isolatedFlags;  ///< Whether each hit of the cluster is isolated
+        recob::Cluster m_cluster;           ///< The ART cluster
+      };
+
+      typedef std::unordered_multimap<std::uint64_t, StoredCluster> ClusterMap;
+
+      /**
+         *  @brief  Get the key under which to store the ART cluster for a vector of ART hits
+         *
+         *  @param  hitVector the input vector of hits
+         *  @param  isolatedFlags whether each hit is isolated
+         *
+         *  @return a fingerprint of the hits, in order, and of which of them are isolated
+         */
+      static std::uint64_t GetClusterKey(const HitVector& hitVector,
+                                         const std::vector<bool>& isolatedFlags);
+
+      /**
+         *  @brief  Find a stored ART cluster built from exactly the same hits, so that a fingerprint collision is never taken
+         *          for a match
+         *
+         *  @param  clusterKey the fingerprint of the hits
+         *  @param  hitVector the input vector of hits
+         *  @param  isolatedFlags whether each hit is isolated
+         *
+         *  @return the address of the stored cluster, nullptr if there is none
+         */
+      const recob::Cluster* FindCluster(const std::uint64_t clusterKey,
+                                        const HitVector& hitVector,
+                                        const std::vector<bool>& isolatedFlags) const;
+
+      const detinfo::DetectorClocksData m_clockData;    ///< The detector clocks for the event
+      const detinfo::DetectorPropertiesData m_detProp;  ///< The detector properties for the event
+      const util::GeometryUtilities m_geometryUtilities; ///< The geometry utilities, using the clocks and properties above
+      tbb::enumerable_thread_specific<cluster::StandardClusterParamsAlg>
+        m_clusterParamsAlgs; ///< The algorithm to fill the cluster members, one per thread
+      const bool m_shouldStoreClusters; ///< Whether to keep the art clusters built
+      ClusterMap m_clusterMap; ///< The art clusters built and their hits, keyed by a fingerprint of the hits
+    };
+
+    /**
+     *  @brief  SpacePointErrorModel class, providing the covariance of the position of a 3D hit. The wire of the parent 2D hit
+     *          fixes the position across that wire to within a wire pitch, the wires of the other views fix the position along
+     *          it, and the drift width of the parent 2D hit fixes the x position. The directions of each view are found once
+     */
+    class SpacePointErrorModel {
+    public:
+      /**
+         *  @brief  Constructor, find the directions of each view from the pandora coordinate transformation
+         *
+         *  @param  pandora the pandora instance
+         */
+      SpacePointErrorModel(const pandora::Pandora& pandora);
+
+      /**
+         *  @brief  Get the error matrix of the position of a 3D hit
+         *
+         *  @param  pCaloHit the input 3D hit
+         *  @param  errorMatrix to receive the lower triangle of the covariance matrix, in the order xx, xy, yy, xz, yz, zz
+         */
+      void GetErrorMatrix(const pandora::CaloHit* const pCaloHit, double errorMatrix[6]) const;
+
+    private:
+      /**
+         *  @brief  Get the index of a 2D view
+         *
+         *  @param  hitType the hit type of the view
+         *
+         *  @return the index of the view
+         */
+      static unsigned int GetViewIndex(const pandora::HitType hitType);
+
+      std::vector<double> m_acrossY; ///< The y component of the direction across the wires, for each view
+      std::vector<double> m_acrossZ; ///< The z component of the direction across the wires, for each view
+      std::vector<double>
+        m_alongScales; ///< The ratio of the variance along the wires to that across them, for each view
+    };
+
+    /**
+     *  @brief  Convert the Pandora PFOs into ART clusters and write into ART event. The consolidated output is always produced
+     *          and, if requested, the all outcomes output, sharing the conversion of the hits to ART clusters between the two
+     *
+     *  @param  settings the settings
+     *  @param  idToHitMap the mapping from Pandora hit ID to ART hit
+     *  @param  evt the ART event
+     */
+    static void ProduceArtOutput(const Settings& settings,
+                                 const IdToHitMap& idToHitMap,
+                                 art::Event& evt);
+
+    /**
+     *  @brief  Convert a list of Pandora PFOs into ART objects and write them into the ART event under a given instance label
      *
      *  @param  settings the settings
+     *  @param  instanceLabel the label for the collections to be produced
+     *  @param  pfoVector the input list of pfos to convert
      *  @param  idToHitMap the mapping from Pandora hit ID to ART hit
+     *  @param  artHitTable the table of the art hits of the pandora hits, shared between the output views
+     *  @param  conversionCache the conversion work shared between the output views
+     *  @param  spacePointErrorModel the model of the error on the position of the spacepoints
+     *  @param  stageTimer the timer with which to measure each step
      *  @param  evt the ART event
      */
     static void ProduceArtOutput(const Settings& settings,
+                                 const std::string& instanceLabel,
+                                 const pandora::PfoVector& pfoVector,
                                  const IdToHitMap& idToHitMap,
+                                 ArtHitTable& artHitTable,
+                                 ConversionCache& conversionCache,
+                                 const SpacePointErrorModel& spacePointErrorModel,
+                                 LArPandoraInstrumentation::StageTimer& stageTimer,
                                  art::Event& evt);
 
     /**
@@ -166,10 +613,12 @@ namespace lar_pandora {
      *  @brief  Collect the pfos (including all downstream pfos) from the master and daughter pandora instances
      *
      *  @param  pPrimaryPandora address of master pandora instance
+     *  @param  pfoVector the sorted list of all current pfos of the master pandora instance
      *
      *  @return a sorted list of all pfos to convert to ART PFParticles
      */
-    static pandora::PfoVector CollectAllPfoOutcomes(const pandora::Pandora* const pPrimaryPandora);
+    static pandora::PfoVector CollectAllPfoOutcomes(const pandora::Pandora* const pPrimaryPandora,
+                                                    const pandora::PfoVector& pfoVector);
 
     /**
      *  @brief  Collect a sorted list of all downstream pfos of an input list of parent
@@ -229,39 +678,24 @@ namespace lar_pandora {
                                               IdToIdVectorMap& pfoToThreeDHitsMap);
 
     /**
-     *  @brief  Find the index of an input object in an input list. Throw an exception if it doesn't exist
+     *  @brief  Map each object in an input list or vector to its index
      *
-     *  @param  pT the input object for which the ID should be found
-     *  @param  tList a list of objects of type pT to query
-     *
-     *  @return the ID of the input object
+     *  @param  tContainer the input list or vector of objects of type T
+     *  @param  tIdMap to receive the mapping from object to index
      */
-    template <typename T>
-    static size_t GetId(const T* const pT, const std::list<const T*>& tList);
+    template <typename T, typename TContainer>
+    static void FillIdMap(const TContainer& tContainer, IdMap<T>& tIdMap);
 
     /**
-     *  @brief  Find the index of an input object in an input vector. Throw an exception if it doesn't exist
+     *  @brief  Find the index of an input object using an id map. Throw an exception if it doesn't exist
      *
      *  @param  pT the input object for which the ID should be found
-     *  @param  tVector a list of objects of type pT to query
+     *  @param  tIdMap the mapping from objects of type T to their index
      *
      *  @return the ID of the input object
      */
     template <typename T>
-    static size_t GetId(const T* const pT, const std::vector<const T*>& tVector);
-
-    /**
-     *  @brief  Collect all 2D and 3D hits that were used / produced in the reconstruction and map them to their corresponding ART hit
-     *
-     *  @param  clusterList input list of all 2D clusters to be output
-     *  @param  threeDHitList input list of all 3D hits to be output (as spacepoints)
-     *  @param  idToHitMap input mapping from pandora hit ID to ART hit
-     *  @param  pandoraHitToArtHitMap output mapping from pandora hit to ART hit
-     */
-    static void GetPandoraToArtHitMap(const pandora::ClusterList& clusterList,
-                                      const pandora::CaloHitList& threeDHitList,
-                                      const IdToHitMap& idToHitMap,
-                                      CaloHitToArtHitMap& pandoraHitToArtHitMap);
+    static size_t GetId(const T* const pT, const IdMap<T>& tIdMap);
 
     /**
      *  @brief  Look up ART hit from an input Pandora hit
@@ -285,16 +719,17 @@ namespace lar_pandora {
      *  @brief  Convert pandora 3D hits to ART spacepoints and add them to the output vector
      *          Create the associations between spacepoints and hits
      *
-     *  @param  event the art event
+     *  @param  context the output context
      *  @param  threeDHitList the input list of 3D hits to convert
-     *  @param  pandoraHitToArtHitMap the input mapping from pandora hits to ART hits
+     *  @param  artHitTable the input table of the art hits of the pandora hits
+     *  @param  spacePointErrorModel the model of the error on the position of the spacepoints
      *  @param  outputSpacePoints the output vector of spacepoints
      *  @param  outputSpacePointsToHits the output associations between spacepoints and hits
      */
-    static void BuildSpacePoints(const art::Event& event,
-                                 const std::string& instanceLabel,
+    static void BuildSpacePoints(const OutputContext& context,
                                  const pandora::CaloHitList& threeDHitList,
-                                 const CaloHitToArtHitMap& pandoraHitToArtHitMap,
+                                 const ArtHitTable& artHitTable,
+                                 const SpacePointErrorModel& spacePointErrorModel,
                                  SpacePointCollection& outputSpacePoints,
                                  SpacePointToHitCollection& outputSpacePointsToHits);
 
@@ -303,18 +738,19 @@ namespace lar_pandora {
      *          Create the associations between clusters and hits.
      *          For multiple drift volumes, each pandora cluster can correspond to multiple ART clusters.
      *
-     *  @param  event the art event
+     *  @param  context the output context
      *  @param  clusterList the input list of 2D pandora clusters to convert
-     *  @param  pandoraHitToArtHitMap the input mapping from pandora hits to ART hits
+     *  @param  artHitTable the input table of the art hits of the pandora hits
+     *  @param  conversionCache the conversion work shared between the output views
      *  @param  pfoToClustersMap the input mapping from pfo ID to cluster IDs
      *  @param  outputClusters the output vector of clusters
      *  @param  outputClustersToHits the output associations between clusters and hits
      *  @param  pfoToArtClustersMap the output mapping from pfo ID to art cluster ID
      */
-    static void BuildClusters(const art::Event& event,
-                              const std::string& instanceLabel,
+    static void BuildClusters(const OutputContext& context,
                               const pandora::ClusterList& clusterList,
-                              const CaloHitToArtHitMap& pandoraHitToArtHitMap,
+                              const ArtHitTable& artHitTable,
+                              ConversionCache& conversionCache,
                               const IdToIdVectorMap& pfoToClustersMap,
                               ClusterCollection& outputClusters,
                               ClusterToHitCollection& outputClustersToHits,
@@ -324,22 +760,23 @@ namespace lar_pandora {
      *  @brief  Convert between pfos and PFParticles and add them to the output vector
      *          Create the associations between PFParticle and vertices, spacepoints and clusters
      *
-     *  @param  event the art event
+     *  @param  context the output context
      *  @param  pfoVector the input list of pfos to convert
      *  @param  pfoToVerticesMap the input mapping from pfo ID to vertex IDs
      *  @param  pfoToThreeDHitsMap the input mapping from pfo ID to 3D hit IDs
      *  @param  pfoToArtClustersMap the input mapping from pfo ID to ART cluster IDs
+     *  @param  idIndex the index from pandora objects to their ids
      *  @param  outputParticle the output vector of PFParticles
      *  @param  outputParticlesToVertices the output associations between PFParticles and vertices
      *  @param  outputParticlesToSpacePoints the output associations between PFParticles and spacepoints
      *  @param  outputParticlesToClusters the output associations between PFParticles and clusters
      */
-    static void BuildPFParticles(const art::Event& event,
-                                 const std::string& instanceLabel,
+    static void BuildPFParticles(const OutputContext& context,
                                  const pandora::PfoVector& pfoVector,
                                  const IdToIdVectorMap& pfoToVerticesMap,
                                  const IdToIdVectorMap& pfoToThreeDHitsMap,
                                  const IdToIdVectorMap& pfoToArtClustersMap,
+                                 const IdIndex& idIndex,
                                  PFParticleCollection& outputParticles,
                                  PFParticleToVertexCollection& outputParticlesToVertices,
                                  PFParticleToSpacePointCollection& outputParticlesToSpacePoints,
@@ -348,15 +785,13 @@ namespace lar_pandora {
     /**
      *  @brief  Convert Create the associations between pre-existing PFParticle and additional vertices
      *
-     *  @param  event the art event
-     *  @param  instanceLabel instance label
+     *  @param  context the output context
      *  @param  pfoVector the input list of pfos to convert
      *  @param  pfoToVerticesMap the input mapping from pfo ID to vertex IDs
      *  @param  outputParticlesToVertices the output associations between PFParticles and vertices
      */
     static void AssociateAdditionalVertices(
-      const art::Event& event,
-      const std::string& instanceLabel,
+      const OutputContext& context,
       const pandora::PfoVector& pfoVector,
       const IdToIdVectorMap& pfoToVerticesMap,
       PFParticleToVertexCollection& outputParticlesToVertices);
@@ -364,13 +799,12 @@ namespace lar_pandora {
     /**
      *  @brief  Build metadata objects from a list of input pfos
      *
-     *  @param  event the art event
+     *  @param  context the output context
      *  @param  pfoVector the input list of pfos
      *  @param  outputParticleMetadata the output vector of PFParticleMetadata
      *  @param  outputParticlesToMetadata the output associations between PFParticles and metadata
      */
-    static void BuildParticleMetadata(const art::Event& event,
-                                      const std::string& instanceLabel,
+    static void BuildParticleMetadata(const OutputContext& context,
                                       const pandora::PfoVector& pfoVector,
                                       PFParticleMetadataCollection& outputParticleMetadata,
                                       PFParticleToMetadataCollection& outputParticlesToMetadata);
@@ -380,9 +814,9 @@ namespace lar_pandora {
      *
      *  @param  settings the settings
      *  @param  pPrimaryPandora the primary pandora instance
-     *  @param  event the art event
-     *  @param  instanceLabel the label for the collections to be produced
+     *  @param  context the output context
      *  @param  pfoVector the input vector of all pfos to be output
+     *  @param  pfoAncestry the ancestry of the pfos to be output
      *  @param  idToHitMap input mapping from pandora hit ID to ART hit
      *  @param  outputSlices the output collection of slices to populate
      *  @param  outputParticlesToSlices the output association from particles to slices
@@ -390,9 +824,9 @@ namespace lar_pandora {
      */
     static void BuildSlices(const Settings& settings,
                             const pandora::Pandora* const pPrimaryPandora,
-                            const art::Event& event,
-                            const std::string& instanceLabel,
+                            const OutputContext& context,
                             const pandora::PfoVector& pfoVector,
+                            const PfoAncestry& pfoAncestry,
                             const IdToHitMap& idToHitMap,
                             SliceCollection& outputSlices,
                             PFParticleToSliceCollection& outputParticlesToSlices,
@@ -409,8 +843,7 @@ namespace lar_pandora {
      *  @brief  Ouput a single slice containing all of the input hits
      *
      *  @param  settings the settings
-     *  @param  event the art event
-     *  @param  instanceLabel the label for the collections to be produced
+     *  @param  context the output context
      *  @param  pfoVector the input vector of all pfos to be output
      *  @param  idToHitMap input mapping from pandora hit ID to ART hit
      *  @param  outputSlices the output collection of slices to populate
@@ -418,8 +851,7 @@ namespace lar_pandora {
      *  @param  outputSlicesToHits the output association from slices to hits
      */
     static void CopyAllHitsToSingleSlice(const Settings& settings,
-                                         const art::Event& event,
-                                         const std::string& instanceLabel,
+                                         const OutputContext& context,
                                          const pandora::PfoVector& pfoVector,
                                          const IdToHitMap& idToHitMap,
                                          SliceCollection& outputSlices,
@@ -430,15 +862,13 @@ namespace lar_pandora {
      *  @brief  Build a new slice object from a PFO, this can be a top-level parent in a hierarchy or a "slice PFO" from the slicing instance
      *
      *  @param  pParentPfo the parent pfo from which to build the slice
-     *  @param  event the art event
-     *  @param  instanceLabel the label for the collections to be produced
+     *  @param  context the output context
      *  @param  idToHitMap input mapping from pandora hit ID to ART hit
      *  @param  outputSlices the output collection of slices to populate
      *  @param  outputSlicesToHits the output association from slices to hits
      */
     static unsigned int BuildSlice(const pandora::ParticleFlowObject* const pParentPfo,
-                                   const art::Event& event,
-                                   const std::string& instanceLabel,
+                                   const OutputContext& context,
                                    const IdToHitMap& idToHitMap,
                                    SliceCollection& outputSlices,
                                    SliceToHitCollection& outputSlicesToHits);
@@ -447,15 +877,17 @@ namespace lar_pandora {
      *  @brief  Calculate the T0 of each pfos and add them to the output vector
      *          Create the associations between PFParticle and T0s
      *
-     *  @param  event the art event
-     *  @param  instanceLabel the label for the collections to be produced
+     *  @param  context the output context
+     *  @param  conversionCache the conversion work shared between the output views, holding the detector clocks and properties
      *  @param  pfoVector the input list of pfos
+     *  @param  pfoAncestry the ancestry of the pfos to be output
      *  @param  outputT0s the output vector of T0s
      *  @param  outputParticlesToT0s the output associations between PFParticles and T0s
      */
-    static void BuildT0s(const art::Event& event,
-                         const std::string& instanceLabel,
+    static void BuildT0s(const OutputContext& context,
+                         const ConversionCache& conversionCache,
                          const pandora::PfoVector& pfoVector,
+                         const PfoAncestry& pfoAncestry,
                          T0Collection& outputT0s,
                          PFParticleToT0Collection& outputParticlesToT0s);
 
@@ -474,11 +906,13 @@ namespace lar_pandora {
      *
      *  @param  pCaloHit the input hit
      *  @param  spacePointId the id of the space-point to produce
+     *  @param  spacePointErrorModel the model of the error on the position of the space-point
      *
      *  @param  the ART spacepoint
      */
     static recob::SpacePoint BuildSpacePoint(const pandora::CaloHit* const pCaloHit,
-                                             const size_t spacePointId);
+                                             const size_t spacePointId,
+                                             const SpacePointErrorModel& spacePointErrorModel);
 
     /**
      *  @brief  Collect a sorted list of all 2D hits in a cluster
@@ -490,26 +924,21 @@ namespace lar_pandora {
                                  pandora::CaloHitVector& sortedHits);
 
     /**
-     *  @brief  Convert from a pandora 2D cluster to a vector of ART clusters (produce multiple if the cluster is split over drift volumes)
+     *  @brief  Split the hits of a pandora 2D cluster by drift volume, each part to be converted to an ART cluster
      *
-     *  @param  pCluster the input cluster
-     *  @param  clusterList the input list of clusters
-     *  @param  pandoraHitToArtHitMap the input mapping from pandora hits to ART hits
+     *  @param  clusterIndex the position of the cluster in the input list of 2D clusters, which is also its id
+     *  @param  pCluster the address of the 2D cluster
+     *  @param  artHitTable the input table of the art hits of the pandora hits
      *  @param  pandoraClusterToArtClustersMap output mapping from pandora cluster ID to art cluster IDs
-     *  @param  hitVectors the output vectors of hits for each cluster produced used to produce associations
-     *  @param  algo algorithm set to fill cluster members
-     *
-     *  @param  the vector of ART clusters
+     *  @param  hitVectors the output vectors of hits for each ART cluster, the id of which is its position in this vector
+     *  @param  isolatedHits the output list of isolated hits
      */
-    static std::vector<recob::Cluster> BuildClusters(
-      util::GeometryUtilities const& gser,
-      const pandora::Cluster* const pCluster,
-      const pandora::ClusterList& clusterList,
-      const CaloHitToArtHitMap& pandoraHitToArtHitMap,
-      IdToIdVectorMap& pandoraClusterToArtClustersMap,
-      std::vector<HitVector>& hitVectors,
-      size_t& nextId,
-      cluster::ClusterParamsAlgBase& algo);
+    static void SplitCluster(const size_t clusterIndex,
+                             const pandora::Cluster* const pCluster,
+                             const ArtHitTable& artHitTable,
+                             IdToIdVectorMap& pandoraClusterToArtClustersMap,
+                             std::vector<HitVector>& hitVectors,
+                             HitList& isolatedHits);
 
     /**
      *  @brief  Build an ART cluster from an input vector of ART hits
@@ -530,174 +959,266 @@ namespace lar_pandora {
                                        const HitList& isolatedHits,
                                        cluster::ClusterParamsAlgBase& algo);
 
+    /**
+     *  @brief  Copy an ART cluster, giving the copy a new id code
+     *
+     *  @param  cluster the input cluster
+     *  @param  id the id code for the copy
+     *
+     *  @return the ART cluster
+     */
+    static recob::Cluster CopyCluster(const recob::Cluster& cluster, const size_t id);
+
     /**
      *  @brief  Convert from a pfo to and ART PFParticle
      *
      *  @param  pPfo the input pfo to convert
      *  @param  pfoId the id of the pfo to produce
-     *  @param  pfoVector the input list of pfos
+     *  @param  idIndex the index from pandora objects to their ids
      *
      *  @param  the ART PFParticle
      */
     static recob::PFParticle BuildPFParticle(const pandora::ParticleFlowObject* const pPfo,
                                              const size_t pfoId,
-                                             const pandora::PfoVector& pfoVector);
+                                             const IdIndex& idIndex);
 
     /**
      *  @brief  If required, build a T0 for the input pfo
      *
-     *  @param  event the ART event
-     *  @param  pPfo the input pfo
-     *  @param  pfoVector the input list of pfos
+     *  @param  clockData the detector clocks for the event
+     *  @param  detProp the detector properties for the event
+     *  @param  pfoAncestry the ancestry of the pfos to be output
+     *  @param  pfoId the id of the input pfo
      *  @param  nextId the ID of the T0 - will be incremented if the t0 was produced
      *  @param  t0 the output T0
      *
      *  @return if a T0 was produced (calculated from the stitching hit shift distance)
      */
-    static bool BuildT0(const art::Event& event,
-                        const pandora::ParticleFlowObject* const pPfo,
-                        const pandora::PfoVector& pfoVector,
+    static bool BuildT0(const detinfo::DetectorClocksData& clockData,
+                        const detinfo::DetectorPropertiesData& detProp,
+                        const PfoAncestry& pfoAncestry,
+                        const size_t pfoId,
                         size_t& nextId,
                         anab::T0& t0);
+  };
 
-    /**
-     *  @brief  Add an association between objects with two given ids
-     *
-     *  @param  event the ART event
-     *  @param  idA the id of an object of type A
-     *  @param  idB the id of an object of type B to associate to the first object
-     *  @param  association the output association to update
-     */
-    template <typename A, typename B>
-    static void AddAssociation(const art::Event& event,
-                               const std::string& instanceLabel,
-                               const size_t idA,
-                               const size_t idB,
-                               std::unique_ptr<art::Assns<A, B>>& association);
+  //------------------------------------------------------------------------------------------------------------------------------------------
 
-    /**
-     *  @brief  Add associations between input objects
-     *
-     *  @param  event the ART event
-     *  @param  idA the id of an object of type A
-     *  @param  aToBMap the input mapping from IDs of objects of type A to IDs of objects of type B to associate
-     *  @param  association the output association to update
-     */
-    template <typename A, typename B>
-    static void AddAssociation(const art::Event& event,
-                               const std::string& instanceLabel,
-                               const size_t idA,
-                               const IdToIdVectorMap& aToBMap,
-                               std::unique_ptr<art::Assns<A, B>>& association);
+  inline size_t
+  LArPandoraOutput::PfoAncestry::GetRootId(const size_t pfoId) const
+  {
+    return m_rootIds.at(pfoId);
+  }
 
-    /**
-     *  @brief  Add associations between input objects
-     *
-     *  @param  event the ART event
-     *  @param  idA the id of an object of type A
-     *  @param  bVector the input vector of IDs of objects of type B to associate
-     *  @param  association the output association to update
-     */
-    template <typename A, typename B>
-    static void AddAssociation(const art::Event& event,
-                               const std::string& instanceLabel,
-                               const size_t idA,
-                               const std::vector<art::Ptr<B>>& bVector,
-                               std::unique_ptr<art::Assns<A, B>>& association);
-  };
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline bool
+  LArPandoraOutput::PfoAncestry::IsFromSlice(const size_t pfoId) const
+  {
+    return (std::numeric_limits<unsigned int>::max() != m_sliceIndices[this->GetRootId(pfoId)]);
+  }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
-  template <typename T>
-  inline size_t
-  LArPandoraOutput::GetId(const T* const pT, const std::list<const T*>& tList)
+  inline bool
+  LArPandoraOutput::PfoAncestry::IsClearCosmic(const size_t pfoId) const
+  {
+    return m_isClearCosmics[this->GetRootId(pfoId)];
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline unsigned int
+  LArPandoraOutput::PfoAncestry::GetSliceIndex(const size_t pfoId) const
   {
-    typename std::list<const T*>::const_iterator it(std::find(tList.begin(), tList.end(), pT));
+    const unsigned int sliceIndex(m_sliceIndices[this->GetRootId(pfoId)]);
 
-    if (it == tList.end())
+    if (std::numeric_limits<unsigned int>::max() == sliceIndex)
       throw cet::exception("LArPandora")
-        << " LArPandoraOutput::GetId --- can't find the id of supplied object";
+        << " LArPandoraOutput::PfoAncestry::GetSliceIndex--- Input PFO was not from a slice ";
 
-    return static_cast<size_t>(std::distance(tList.begin(), it));
+    return sliceIndex;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline float
+  LArPandoraOutput::PfoAncestry::GetX0(const size_t pfoId) const
+  {
+    return m_x0s[this->GetRootId(pfoId)];
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline size_t
+  LArPandoraOutput::ArtHitTable::GetClusterBegin(const pandora::Cluster* const pCluster) const
+  {
+    return m_clusterOffsets[LArPandoraOutput::GetId(pCluster, m_clusterIdMap)];
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline size_t
+  LArPandoraOutput::ArtHitTable::GetClusterEnd(const pandora::Cluster* const pCluster) const
+  {
+    return m_clusterOffsets[LArPandoraOutput::GetId(pCluster, m_clusterIdMap) + 1];
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const pandora::CaloHit*
+  LArPandoraOutput::ArtHitTable::GetTwoDCaloHit(const size_t hitIndex) const
+  {
+    return m_twoDCaloHits[hitIndex];
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const art::Ptr<recob::Hit>&
+  LArPandoraOutput::ArtHitTable::GetTwoDArtHit(const size_t hitIndex) const
+  {
+    return m_twoDArtHits[hitIndex];
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const art::Ptr<recob::Hit>&
+  LArPandoraOutput::ArtHitTable::GetThreeDArtHit(const pandora::CaloHit* const pCaloHit) const
+  {
+    return m_threeDArtHits[LArPandoraOutput::GetId(pCaloHit, m_threeDHitIdMap)];
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  template <typename T, typename TContainer>
+  inline void
+  LArPandoraOutput::FillIdMap(const TContainer& tContainer, IdMap<T>& tIdMap)
+  {
+    tIdMap.reserve(tContainer.size());
+
+    for (const T* const pT : tContainer) {
+      if (!tIdMap.emplace(pT, tIdMap.size()).second)
+        throw cet::exception("LArPandora")
+          << " LArPandoraOutput::FillIdMap --- found repeated objects in input container";
+    }
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   template <typename T>
   inline size_t
-  LArPandoraOutput::GetId(const T* const pT, const std::vector<const T*>& tVector)
+  LArPandoraOutput::GetId(const T* const pT, const IdMap<T>& tIdMap)
   {
-    typename std::vector<const T*>::const_iterator it(
-      std::find(tVector.begin(), tVector.end(), pT));
+    typename IdMap<T>::const_iterator it(tIdMap.find(pT));
 
-    if (it == tVector.end())
+    if (it == tIdMap.end())
       throw cet::exception("LArPandora")
         << " LArPandoraOutput::GetId --- can't find the id of supplied object";
 
-    return static_cast<size_t>(std::distance(tVector.begin(), it));
+    return it->second;
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
-  template <typename A, typename B>
-  inline void
-  LArPandoraOutput::AddAssociation(const art::Event& event,
-                                   const std::string& instanceLabel,
-                                   const size_t idA,
-                                   const size_t idB,
-                                   std::unique_ptr<art::Assns<A, B>>& association)
+  inline const art::Event&
+  LArPandoraOutput::OutputContext::GetEvent() const
+  {
+    return m_event;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const std::string&
+  LArPandoraOutput::OutputContext::GetInstanceLabel() const
+  {
+    return m_instanceLabel;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  inline const detinfo::DetectorClocksData&
+  LArPandoraOutput::ConversionCache::GetDetectorClocksData() const
   {
-    const art::PtrMaker<A> makePtrA(event, instanceLabel);
-    art::Ptr<A> pA(makePtrA(idA));
+    return m_clockData;
+  }
 
-    const art::PtrMaker<B> makePtrB(event, instanceLabel);
-    art::Ptr<B> pB(makePtrB(idB));
+  //------------------------------------------------------------------------------------------------------------------------------------------
 
-    association->addSingle(pA, pB);
+  inline const detinfo::DetectorPropertiesData&
+  LArPandoraOutput::ConversionCache::GetDetectorPropertiesData() const
+  {
+    return m_detProp;
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   template <typename A, typename B>
   inline void
-  LArPandoraOutput::AddAssociation(const art::Event& event,
-                                   const std::string& instanceLabel,
-                                   const size_t idA,
-                                   const IdToIdVectorMap& aToBMap,
-                                   std::unique_ptr<art::Assns<A, B>>& association)
+  LArPandoraOutput::OutputContext::AddAssociation(
+    const size_t idA,
+    const size_t idB,
+    std::unique_ptr<art::Assns<A, B>>& association) const
   {
-    IdToIdVectorMap::const_iterator it(aToBMap.find(idA));
-    if (it == aToBMap.end())
-      throw cet::exception("LArPandora")
-        << " LArPandoraOutput::AddAssociation --- id doesn't exists in the assocaition map";
+    association->addSingle(this->GetPtrMaker<A>()(idA), this->GetPtrMaker<B>()(idB));
+  }
 
-    const art::PtrMaker<A> makePtrA(event, instanceLabel);
-    art::Ptr<A> pA(makePtrA(idA));
+  //------------------------------------------------------------------------------------------------------------------------------------------
 
-    const art::PtrMaker<B> makePtrB(event, instanceLabel);
-    for (const size_t idB : it->second) {
-      art::Ptr<B> pB(makePtrB(idB));
-      association->addSingle(pA, pB);
-    }
+  template <typename A, typename B>
+  inline void
+  LArPandoraOutput::OutputContext::AddAssociation(
+    const size_t idA,
+    const IdVector& idBVector,
+    std::unique_ptr<art::Assns<A, B>>& association) const
+  {
+    const art::Ptr<A> pA(this->GetPtrMaker<A>()(idA));
+    const art::PtrMaker<B>& makePtrB(this->GetPtrMaker<B>());
+
+    for (const size_t idB : idBVector)
+      association->addSingle(pA, makePtrB(idB));
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  template <typename A, typename B>
+  inline void
+  LArPandoraOutput::OutputContext::AddAssociation(
+    const size_t idA,
+    const art::Ptr<B>& pB,
+    std::unique_ptr<art::Assns<A, B>>& association) const
+  {
+    association->addSingle(this->GetPtrMaker<A>()(idA), pB);
   }
 
   //------------------------------------------------------------------------------------------------------------------------------------------
 
   template <typename A, typename B>
   inline void
-  LArPandoraOutput::AddAssociation(const art::Event& event,
-                                   const std::string& instanceLabel,
-                                   const size_t idA,
-                                   const std::vector<art::Ptr<B>>& bVector,
-                                   std::unique_ptr<art::Assns<A, B>>& association)
+  LArPandoraOutput::OutputContext::AddAssociation(
+    const size_t idA,
+    const std::vector<art::Ptr<B>>& bVector,
+    std::unique_ptr<art::Assns<A, B>>& association) const
   {
-    const art::PtrMaker<A> makePtrA(event, instanceLabel);
-    art::Ptr<A> pA(makePtrA(idA));
+    const art::Ptr<A> pA(this->GetPtrMaker<A>()(idA));
 
     for (const art::Ptr<B>& pB : bVector)
       association->addSingle(pA, pB);
   }
 
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  template <typename T>
+  inline const art::PtrMaker<T>&
+  LArPandoraOutput::OutputContext::GetPtrMaker() const
+  {
+    // ATTN The PtrMakers are created on first use, as the optional output products are not always declared
+    PtrMakerPtr<T>& pPtrMaker(std::get<PtrMakerPtr<T>>(m_ptrMakers));
+
+    if (!pPtrMaker) pPtrMaker = std::make_unique<const art::PtrMaker<T>>(m_event, m_instanceLabel);
+
+    return *pPtrMaker;
+  }
+
 } // namespace lar_pandora
 
 #endif //  LAR_PANDORA_OUTPUT_H
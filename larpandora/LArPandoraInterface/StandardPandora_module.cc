@@ -8,6 +8,8 @@
 
 #include "larpandora/LArPandoraInterface/LArPandora.h"
 
+#include <algorithm>
+#include <mutex>
 #include <string>
 
 namespace lar_pandora
@@ -34,16 +36,28 @@ public:
 private:
     void CreatePandoraInstances();
     void ConfigurePandoraInstances();
-    void RunPandoraInstances();
-    void ResetPandoraInstances();
+    const pandora::Pandora *AcquirePandoraInstance();
+    void ReleasePandoraInstance(const pandora::Pandora *const pPrimaryPandora);
+    void RunPandoraInstances(const pandora::Pandora *const pPrimaryPandora);
+    void ResetPandoraInstances(const pandora::Pandora *const pPrimaryPandora);
     void DeletePandoraInstances();
 
+    /**
+     *  @brief  Create a single primary pandora instance, registering algorithms and plugins
+     *
+     *  @return the address of the new primary pandora instance
+     */
+    const pandora::Pandora *CreatePrimaryPandoraInstance() const;
+
     /**
      *  @brief  Pass external steering parameters, read from fhicl parameter set, to LArMaster Pandora algorithm
      *
      *  @param  pPandora the address of the relevant pandora instance
      */
     void ProvideExternalSteeringParameters(const pandora::Pandora *const pPandora) const;
+
+    PandoraInstanceList         m_freePandoraList;          ///< The primary pandora instances not currently processing an event
+    std::mutex                  m_poolMutex;                ///< The mutex guarding the list of free primary pandora instances
 };
 
 DEFINE_ART_MODULE(StandardPandora)
@@ -53,6 +67,7 @@ DEFINE_ART_MODULE(StandardPandora)
 //------------------------------------------------------------------------------------------------------------------------------------------
 // implementation follows
 
+#include "art/Utilities/Globals.h"
 #include "cetlib_except/exception.h"
 
 #include "Api/PandoraApi.h"
@@ -86,18 +101,14 @@ StandardPandora::~StandardPandora()
 
 void StandardPandora::CreatePandoraInstances()
 {
-    m_pPrimaryPandora = new pandora::Pandora();
-    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, LArContent::RegisterAlgorithms(*m_pPrimaryPandora));
-#ifdef LIBTORCH_DL
-    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, LArDLContent::RegisterAlgorithms(*m_pPrimaryPandora));
-#endif
-    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, LArContent::RegisterBasicPlugins(*m_pPrimaryPandora));
+    // ATTN Each schedule processes one event at a time, so one primary instance per schedule means the pool is never empty
+    const int nSchedules(art::Globals::instance()->nschedules());
 
-    // ATTN Potentially ill defined, unless coordinate system set up to ensure that all drift volumes have same wire angles and pitches
-    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, PandoraApi::SetPseudoLayerPlugin(*m_pPrimaryPandora, new lar_content::LArPseudoLayerPlugin));
-    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, PandoraApi::SetLArTransformationPlugin(*m_pPrimaryPandora, new lar_content::LArRotationalTransformationPlugin));
+    for (int iInstance = 0; iInstance < std::max(1, nSchedules); ++iInstance)
+        m_primaryPandoraList.push_back(this->CreatePrimaryPandoraInstance());
 
-    MultiPandoraApi::AddPrimaryPandoraInstance(m_pPrimaryPandora);
+    m_pPrimaryPandora = m_primaryPandoraList.front();
+    m_freePandoraList = m_primaryPandoraList;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -110,29 +121,80 @@ void StandardPandora::ConfigurePandoraInstances()
     if (!sp.find_file(m_configFile, fullConfigFileName))
         throw cet::exception("StandardPandora") << " ConfigurePrimaryPandoraInstance - Failed to find xml configuration file " << m_configFile << " in FW search path";
 
-    this->ProvideExternalSteeringParameters(m_pPrimaryPandora);
-    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, PandoraApi::ReadSettings(*m_pPrimaryPandora, fullConfigFileName));
+    for (const pandora::Pandora *const pPrimaryPandora : m_primaryPandoraList)
+    {
+        this->ProvideExternalSteeringParameters(pPrimaryPandora);
+        PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, PandoraApi::ReadSettings(*pPrimaryPandora, fullConfigFileName));
+    }
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-void StandardPandora::RunPandoraInstances()
+const pandora::Pandora *StandardPandora::AcquirePandoraInstance()
 {
-    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, PandoraApi::ProcessEvent(*m_pPrimaryPandora));
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+
+    if (m_freePandoraList.empty())
+        throw cet::exception("StandardPandora") << " AcquirePandoraInstance - no free primary pandora instance, more events in flight than schedules";
+
+    const pandora::Pandora *const pPrimaryPandora(m_freePandoraList.back());
+    m_freePandoraList.pop_back();
+
+    return pPrimaryPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void StandardPandora::ReleasePandoraInstance(const pandora::Pandora *const pPrimaryPandora)
+{
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    m_freePandoraList.push_back(pPrimaryPandora);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-void StandardPandora::ResetPandoraInstances()
+void StandardPandora::RunPandoraInstances(const pandora::Pandora *const pPrimaryPandora)
 {
-    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, PandoraApi::Reset(*m_pPrimaryPandora));
+    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, PandoraApi::ProcessEvent(*pPrimaryPandora));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void StandardPandora::ResetPandoraInstances(const pandora::Pandora *const pPrimaryPandora)
+{
+    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, PandoraApi::Reset(*pPrimaryPandora));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 void StandardPandora::DeletePandoraInstances()
 {
-    MultiPandoraApi::DeletePandoraInstances(m_pPrimaryPandora);
+    for (const pandora::Pandora *const pPrimaryPandora : m_primaryPandoraList)
+        MultiPandoraApi::DeletePandoraInstances(pPrimaryPandora);
+
+    m_primaryPandoraList.clear();
+    m_freePandoraList.clear();
+    m_pPrimaryPandora = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const pandora::Pandora *StandardPandora::CreatePrimaryPandoraInstance() const
+{
+    pandora::Pandora *const pPrimaryPandora(new pandora::Pandora());
+    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, LArContent::RegisterAlgorithms(*pPrimaryPandora));
+#ifdef LIBTORCH_DL
+    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, LArDLContent::RegisterAlgorithms(*pPrimaryPandora));
+#endif
+    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, LArContent::RegisterBasicPlugins(*pPrimaryPandora));
+
+    // ATTN Potentially ill defined, unless coordinate system set up to ensure that all drift volumes have same wire angles and pitches
+    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, PandoraApi::SetPseudoLayerPlugin(*pPrimaryPandora, new lar_content::LArPseudoLayerPlugin));
+    PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, PandoraApi::SetLArTransformationPlugin(*pPrimaryPandora, new lar_content::LArRotationalTransformationPlugin));
+
+    MultiPandoraApi::AddPrimaryPandoraInstance(pPrimaryPandora);
+
+    return pPrimaryPandora;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
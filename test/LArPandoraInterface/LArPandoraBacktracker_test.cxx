@@ -0,0 +1,218 @@
+/**
+ *  @file   test/LArPandoraInterface/LArPandoraBacktracker_test.cxx
+ *
+ *  @brief  Check the backtracker against sim::SimChannel::TrackIDEs, which it replaces, and time the two
+ */
+
+#include "cetlib_except/exception.h"
+
+#include "lardataalg/DetectorInfo/DetectorClocksData.h"
+#include "lardataalg/DetectorInfo/ElecClock.h"
+#include "lardataobj/RecoBase/Hit.h"
+#include "lardataobj/Simulation/SimChannel.h"
+
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h"
+
+#include "larpandora/LArPandoraInterface/LArPandoraBacktracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace lar_pandora;
+
+namespace {
+
+  typedef std::vector<std::vector<sim::TrackIDE>> TrackIDEsPerHit;
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  Check(const bool condition, const std::string& message)
+  {
+    if (!condition) throw cet::exception("LArPandoraBacktracker_test") << message;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  std::vector<sim::SimChannel>
+  MakeSimChannels(std::mt19937& generator)
+  {
+    std::uniform_int_distribution<unsigned int> tdcDistribution(0, 6000);
+    std::uniform_int_distribution<int> trackIDDistribution(1, 50);
+    std::uniform_int_distribution<unsigned int> nDepositsDistribution(0, 40);
+    std::uniform_real_distribution<double> energyDistribution(0., 2.);
+
+    const double xyz[3] = {0., 0., 0.};
+    std::vector<sim::SimChannel> simChannels;
+
+    // ATTN Leave every third channel without a SimChannel, and give some channels no deposits at all
+    for (raw::ChannelID_t channel = 0; channel < 3000; ++channel) {
+      if (0 == channel % 3) continue;
+
+      sim::SimChannel simChannel(channel);
+      const unsigned int nDeposits(nDepositsDistribution(generator));
+
+      for (unsigned int iDeposit = 0; iDeposit < nDeposits; ++iDeposit) {
+        const double energy(energyDistribution(generator));
+        simChannel.AddIonizationElectrons(trackIDDistribution(generator),
+                                          tdcDistribution(generator),
+                                          1.e4 * energy,
+                                          xyz,
+                                          energy);
+      }
+
+      simChannels.push_back(simChannel);
+    }
+
+    return simChannels;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  std::vector<recob::Hit>
+  MakeHits(std::mt19937& generator)
+  {
+    std::uniform_int_distribution<raw::ChannelID_t> channelDistribution(0, 3100);
+    std::uniform_real_distribution<float> peakTimeDistribution(-50.f, 6100.f);
+    std::uniform_real_distribution<float> rmsDistribution(0.f, 30.f);
+
+    std::vector<recob::Hit> hits;
+
+    for (unsigned int iHit = 0; iHit < 50000; ++iHit) {
+      const float peakTime(peakTimeDistribution(generator)), rms(rmsDistribution(generator));
+      hits.emplace_back(channelDistribution(generator),
+                        static_cast<raw::TDCtick_t>(peakTime - rms),
+                        static_cast<raw::TDCtick_t>(peakTime + rms),
+                        peakTime,
+                        1.f,
+                        rms,
+                        10.f,
+                        1.f,
+                        100.f,
+                        100.f,
+                        1.f,
+                        1,
+                        0,
+                        1.f,
+                        1,
+                        geo::kU,
+                        geo::kInduction,
+                        geo::WireID());
+    }
+
+    return hits;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  BacktrackReference(const detinfo::DetectorClocksData& clockData,
+                     const std::vector<sim::SimChannel>& simChannels,
+                     const std::vector<recob::Hit>& hits,
+                     TrackIDEsPerHit& trackIDEsPerHit)
+  {
+    // The SimChannel map lookup and per hit TrackIDEs call that the backtracker replaces
+    std::map<raw::ChannelID_t, const sim::SimChannel*> simChannelMap;
+    for (const sim::SimChannel& simChannel : simChannels)
+      simChannelMap.emplace(simChannel.Channel(), &simChannel);
+
+    trackIDEsPerHit.clear();
+
+    for (const recob::Hit& hit : hits) {
+      trackIDEsPerHit.emplace_back();
+
+      const std::map<raw::ChannelID_t, const sim::SimChannel*>::const_iterator iter(
+        simChannelMap.find(hit.Channel()));
+
+      if (simChannelMap.end() == iter) continue;
+
+      const raw::TDCtick_t start_tick(clockData.TPCTick2TDC(hit.PeakTimeMinusRMS()));
+      const raw::TDCtick_t end_tick(clockData.TPCTick2TDC(hit.PeakTimePlusRMS()));
+      const unsigned int start_tdc((start_tick < 0) ? 0 : start_tick);
+      const unsigned int end_tdc(end_tick);
+
+      if (start_tdc > end_tdc) continue;
+
+      std::vector<sim::TrackIDE> trackIDEs(iter->second->TrackIDEs(start_tdc, end_tdc));
+      std::sort(trackIDEs.begin(),
+                trackIDEs.end(),
+                [](const sim::TrackIDE& lhs, const sim::TrackIDE& rhs) { return lhs.trackID < rhs.trackID; });
+      trackIDEsPerHit.back() = trackIDEs;
+    }
+  }
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int
+main()
+{
+  try {
+    std::mt19937 generator(20201016);
+    const std::vector<sim::SimChannel> simChannels(MakeSimChannels(generator));
+    const std::vector<recob::Hit> hits(MakeHits(generator));
+
+    HitVector hitVector;
+    for (size_t iHit = 0; iHit < hits.size(); ++iHit)
+      hitVector.emplace_back(&hits[iHit], iHit);
+
+    const detinfo::ElecClock clock(0., 1600., 2.);
+    const detinfo::DetectorClocksData clockData(0., 0., 0., 0., clock, clock, clock, clock);
+
+    const std::chrono::steady_clock::time_point referenceStart(std::chrono::steady_clock::now());
+    TrackIDEsPerHit expectedTrackIDEs;
+    BacktrackReference(clockData, simChannels, hits, expectedTrackIDEs);
+    const std::chrono::steady_clock::time_point referenceEnd(std::chrono::steady_clock::now());
+
+    LArPandoraBacktracker backtracker(simChannels);
+    backtracker.Backtrack(clockData, hitVector);
+    const std::chrono::steady_clock::time_point backtrackerEnd(std::chrono::steady_clock::now());
+
+    Check(backtracker.GetNHits() == hits.size(), "wrong number of backtracked hits");
+
+    size_t nHitsWithTruth(0);
+
+    for (size_t iHit = 0; iHit < hits.size(); ++iHit) {
+      const sim::TrackIDE *pBegin(nullptr), *pEnd(nullptr);
+      backtracker.GetTrackIDEs(iHit, pBegin, pEnd);
+
+      const std::vector<sim::TrackIDE>& expected(expectedTrackIDEs[iHit]);
+      Check(static_cast<size_t>(pEnd - pBegin) == expected.size(),
+            "wrong number of true energy deposits for hit " + std::to_string(iHit));
+
+      // ATTN The deposits are summed in the same order as sim::SimChannel::TrackIDEs, so they must match exactly
+      for (size_t iIDE = 0; iIDE < expected.size(); ++iIDE) {
+        const sim::TrackIDE& trackIDE(pBegin[iIDE]);
+        Check(trackIDE.trackID == expected[iIDE].trackID && trackIDE.energy == expected[iIDE].energy &&
+                trackIDE.numElectrons == expected[iIDE].numElectrons &&
+                trackIDE.energyFrac == expected[iIDE].energyFrac,
+              "wrong true energy deposit for hit " + std::to_string(iHit));
+      }
+
+      if (!expected.empty()) ++nHitsWithTruth;
+    }
+
+    Check(nHitsWithTruth > 0, "no hit has any true energy deposits, the test is not testing anything");
+
+    std::cout << "LArPandoraBacktracker_test: " << hits.size() << " hits, " << nHitsWithTruth
+              << " with true energy deposits" << std::endl
+              << "  SimChannel::TrackIDEs: "
+              << std::chrono::duration<double, std::milli>(referenceEnd - referenceStart).count() << " ms"
+              << std::endl
+              << "  LArPandoraBacktracker: "
+              << std::chrono::duration<double, std::milli>(backtrackerEnd - referenceEnd).count() << " ms"
+              << std::endl;
+  }
+  catch (const cet::exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ *  @file   test/LArPandoraInterface/LArPandoraInputKernels_test.cxx
+ *
+ *  @brief  Check the hit conversion kernels of LArPandoraInput against the per hit calculations that they replace, and
+ *          time the two
+ */
+
+#include "cetlib_except/exception.h"
+
+#include "larpandora/LArPandoraInterface/LArPandoraInput.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace lar_pandora;
+
+namespace {
+
+  void
+  Check(const bool condition, const std::string& message)
+  {
+    if (!condition) throw cet::exception("LArPandoraInputKernels_test") << message;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  bool
+  IsClose(const double lhs, const double rhs)
+  {
+    // ATTN The kernels apply the tick to X conversion as an affine function, so the results agree only to rounding
+    return (std::fabs(lhs - rhs) <= 1.e-12 * std::max(1., std::max(std::fabs(lhs), std::fabs(rhs))));
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  double
+  TicksToXReference(const double ticks, const double xOffset, const double xCoefficient)
+  {
+    // Stands in for detinfo::DetectorPropertiesData::ConvertTicksToX, called for each time of each hit
+    return xOffset + ticks * xCoefficient;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  double
+  GetMipsReference(const LArPandoraInput::Settings& settings,
+                   const double electronsToADC,
+                   const double charge,
+                   const double wirePitch)
+  {
+    // The per hit calculation that GetdQdX and ConvertdEdXToMips replace, with the conversion to energy left out
+    const double dQdX(charge / wirePitch);
+    const double dQdX_e(dQdX / (electronsToADC * settings.m_recombination_factor));
+    double mips(dQdX_e / settings.m_dEdX_mip);
+
+    if (mips < 0.) mips = settings.m_mips_if_negative;
+
+    if (mips > settings.m_mips_max) mips = settings.m_mips_max;
+
+    return mips;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  CheckConvertTicksToX(std::mt19937& generator, const bool useHitWidths)
+  {
+    std::uniform_real_distribution<double> timeDistribution(-1000., 7000.), rmsDistribution(0., 30.);
+    std::uniform_int_distribution<unsigned int> planeDistribution(0, 5);
+
+    // ATTN Give the planes drift directions of either sign, as for the tpcs either side of a cathode
+    const std::vector<double> planeXOffsets = {-360., -355., -350., 360., 355., 350.};
+    const std::vector<double> planeXCoefficients = {0.0802, 0.0802, 0.0802, -0.0802, -0.0802, -0.0802};
+
+    LArPandoraInput::Settings settings;
+    settings.m_useHitWidths = useHitWidths;
+    settings.m_dx_cm = 0.5;
+
+    const size_t nHits(1000000);
+    std::vector<double> peakTimes, startTimes, endTimes, xOffsets, xCoefficients;
+
+    for (size_t iHit = 0; iHit < nHits; ++iHit) {
+      const double peakTime(timeDistribution(generator)), rms(rmsDistribution(generator));
+      const unsigned int plane(planeDistribution(generator));
+      peakTimes.push_back(peakTime);
+      startTimes.push_back(peakTime - rms);
+      endTimes.push_back(peakTime + rms);
+      xOffsets.push_back(planeXOffsets[plane]);
+      xCoefficients.push_back(planeXCoefficients[plane]);
+    }
+
+    const std::chrono::steady_clock::time_point referenceStart(std::chrono::steady_clock::now());
+    std::vector<double> expectedXPositions, expectedWidths;
+
+    for (size_t iHit = 0; iHit < nHits; ++iHit) {
+      expectedXPositions.push_back(TicksToXReference(peakTimes[iHit], xOffsets[iHit], xCoefficients[iHit]));
+
+      if (settings.m_useHitWidths) {
+        const double xStart(TicksToXReference(startTimes[iHit], xOffsets[iHit], xCoefficients[iHit]));
+        const double xEnd(TicksToXReference(endTimes[iHit], xOffsets[iHit], xCoefficients[iHit]));
+        expectedWidths.push_back(std::fabs(xEnd - xStart));
+      }
+      else {
+        expectedWidths.push_back(settings.m_dx_cm);
+      }
+    }
+    const std::chrono::steady_clock::time_point referenceEnd(std::chrono::steady_clock::now());
+
+    std::vector<double> xPositions, widths;
+    LArPandoraInput::ConvertTicksToX(
+      settings, peakTimes, startTimes, endTimes, xOffsets, xCoefficients, xPositions, widths);
+    const std::chrono::steady_clock::time_point kernelEnd(std::chrono::steady_clock::now());
+
+    Check(xPositions.size() == nHits && widths.size() == nHits, "wrong number of converted hits");
+
+    for (size_t iHit = 0; iHit < nHits; ++iHit) {
+      Check(IsClose(xPositions[iHit], expectedXPositions[iHit]),
+            "wrong drift coordinate for hit " + std::to_string(iHit));
+      Check(IsClose(widths[iHit], expectedWidths[iHit]) && widths[iHit] >= 0.,
+            "wrong drift coordinate width for hit " + std::to_string(iHit));
+    }
+
+    std::cout << "ConvertTicksToX (" << (useHitWidths ? "hit widths" : "fixed widths") << "): " << nHits
+              << " hits" << std::endl
+              << "  Per hit: " << std::chrono::duration<double, std::milli>(referenceEnd - referenceStart).count()
+              << " ms" << std::endl
+              << "  Kernel:  " << std::chrono::duration<double, std::milli>(kernelEnd - referenceEnd).count()
+              << " ms" << std::endl;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  CheckGetMips(std::mt19937& generator)
+  {
+    // ATTN Include negative charges and charges large enough to reach the maximum number of mips
+    std::uniform_real_distribution<double> chargeDistribution(-0.02, 0.3);
+    std::uniform_int_distribution<unsigned int> pitchDistribution(0, 2);
+
+    const std::vector<double> pitches = {0.3, 0.4667, 0.5};
+    const double electronsToADC(0.0067);
+
+    LArPandoraInput::Settings settings;
+    settings.m_dEdX_mip = 3.;
+    settings.m_mips_max = 50.;
+    settings.m_mips_if_negative = 0.;
+    settings.m_recombination_factor = 0.63;
+
+    const size_t nHits(1000000);
+    std::vector<double> charges, wirePitches;
+
+    for (size_t iHit = 0; iHit < nHits; ++iHit) {
+      charges.push_back(chargeDistribution(generator));
+      wirePitches.push_back(pitches[pitchDistribution(generator)]);
+    }
+
+    const std::chrono::steady_clock::time_point referenceStart(std::chrono::steady_clock::now());
+    std::vector<double> expectedMips;
+
+    for (size_t iHit = 0; iHit < nHits; ++iHit)
+      expectedMips.push_back(GetMipsReference(settings, electronsToADC, charges[iHit], wirePitches[iHit]));
+    const std::chrono::steady_clock::time_point referenceEnd(std::chrono::steady_clock::now());
+
+    std::vector<double> mips;
+    LArPandoraInput::GetdQdX(settings, electronsToADC, charges, wirePitches, mips);
+    LArPandoraInput::ConvertdEdXToMips(settings, mips);
+    const std::chrono::steady_clock::time_point kernelEnd(std::chrono::steady_clock::now());
+
+    Check(mips.size() == nHits, "wrong number of converted hits");
+
+    size_t nNegative(0), nMax(0);
+
+    // ATTN The kernels do the same operations in the same order as the per hit calculation, so they must match exactly
+    for (size_t iHit = 0; iHit < nHits; ++iHit) {
+      Check(mips[iHit] == expectedMips[iHit], "wrong mips for hit " + std::to_string(iHit));
+
+      if (charges[iHit] < 0.) ++nNegative;
+
+      if (expectedMips[iHit] == settings.m_mips_max) ++nMax;
+    }
+
+    Check(nNegative > 0 && nMax > 0, "no hit reaches the mips limits, the test is not testing anything");
+
+    std::cout << "GetdQdX and ConvertdEdXToMips: " << nHits << " hits, " << nNegative << " negative, " << nMax
+              << " at the maximum" << std::endl
+              << "  Per hit: " << std::chrono::duration<double, std::milli>(referenceEnd - referenceStart).count()
+              << " ms" << std::endl
+              << "  Kernels: " << std::chrono::duration<double, std::milli>(kernelEnd - referenceEnd).count()
+              << " ms" << std::endl;
+  }
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int
+main()
+{
+  try {
+    std::mt19937 generator(20201016);
+    CheckConvertTicksToX(generator, true);
+    CheckConvertTicksToX(generator, false);
+    CheckGetMips(generator);
+  }
+  catch (const cet::exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,179 @@
+/**
+ *  @file   test/LArPandoraInterface/LArPandoraMCParticleIndex_test.cxx
+ *
+ *  @brief  Check the MC particle index against the MC particle map and primary matching that it replaces, and time the two
+ */
+
+#include "cetlib_except/exception.h"
+
+#include "nusimdata/SimulationBase/MCParticle.h"
+#include "nusimdata/SimulationBase/MCTruth.h"
+
+#include "larpandora/LArPandoraInterface/LArPandoraMCParticleIndex.h"
+
+#include "TLorentzVector.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace lar_pandora;
+
+namespace {
+
+  void
+  Check(const bool condition, const std::string& message)
+  {
+    if (!condition) throw cet::exception("LArPandoraMCParticleIndex_test") << message;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  simb::MCParticle
+  MakeParticle(std::mt19937& generator, const int trackID, const std::string& process)
+  {
+    // ATTN Take the momenta from a few values, so that many particles share their momentum with a primary
+    std::uniform_int_distribution<int> momentumDistribution(0, 3);
+
+    simb::MCParticle particle(trackID, 13, process);
+    const double px(0.5 * momentumDistribution(generator)), py(0.5 * momentumDistribution(generator)),
+      pz(0.5 * momentumDistribution(generator));
+    particle.AddTrajectoryPoint(TLorentzVector(0., 0., 0., 0.), TLorentzVector(px, py, pz, 2.));
+
+    return particle;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  bool
+  HasSameMomentum(const simb::MCParticle& lhs, const simb::MCParticle& rhs)
+  {
+    const double epsilon(std::numeric_limits<double>::epsilon());
+    return (std::fabs(lhs.Px() - rhs.Px()) < epsilon && std::fabs(lhs.Py() - rhs.Py()) < epsilon &&
+            std::fabs(lhs.Pz() - rhs.Pz()) < epsilon);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  IndexReference(const MCTruthToMCParticles& truthToParticles,
+                 const RawMCParticleVector& generatorMCParticleVector,
+                 std::map<int, art::Ptr<simb::MCParticle>>& particleMap,
+                 std::map<int, bool>& isPrimaryMap)
+  {
+    // A repeated track id replaces the earlier particle, as in a MCParticleMap
+    for (const MCTruthToMCParticles::value_type& truthToParticlesEntry : truthToParticles) {
+      for (const art::Ptr<simb::MCParticle>& particle : truthToParticlesEntry.second)
+        particleMap[particle->TrackId()] = particle;
+    }
+
+    std::map<int, const simb::MCParticle*> primaryMap;
+    for (const simb::MCParticle& mcParticle : generatorMCParticleVector) {
+      if ("primary" == mcParticle.Process()) primaryMap.emplace(mcParticle.TrackId(), &mcParticle);
+    }
+
+    // Each primary matches at most one particle, taking the particles and then the primaries in order of track id
+    std::set<int> matchedPrimaries;
+
+    for (const std::map<int, art::Ptr<simb::MCParticle>>::value_type& particleEntry : particleMap) {
+      isPrimaryMap[particleEntry.first] = false;
+
+      for (const std::map<int, const simb::MCParticle*>::value_type& primaryEntry : primaryMap) {
+        if (matchedPrimaries.count(primaryEntry.first)) continue;
+
+        if (!HasSameMomentum(*particleEntry.second, *primaryEntry.second)) continue;
+
+        matchedPrimaries.insert(primaryEntry.first);
+        isPrimaryMap[particleEntry.first] = true;
+        break;
+      }
+    }
+  }
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int
+main()
+{
+  try {
+    std::mt19937 generator(20201016);
+    std::uniform_int_distribution<int> trackIDDistribution(1, 3000);
+    std::uniform_int_distribution<int> processDistribution(0, 3);
+
+    // ATTN All the particles share one MC truth, as transient art::Ptrs to different objects do not order in a map
+    simb::MCTruth truth;
+    truth.SetOrigin(simb::kBeamNeutrino);
+
+    std::vector<simb::MCParticle> particles;
+    for (unsigned int iParticle = 0; iParticle < 5000; ++iParticle)
+      particles.push_back(MakeParticle(generator, trackIDDistribution(generator), "primary"));
+
+    MCTruthToMCParticles truthToParticles;
+    MCParticleVector& particleVector(truthToParticles[art::Ptr<simb::MCTruth>(&truth, 0)]);
+    for (size_t iParticle = 0; iParticle < particles.size(); ++iParticle)
+      particleVector.emplace_back(&particles[iParticle], iParticle);
+
+    RawMCParticleVector generatorMCParticleVector;
+    for (unsigned int iParticle = 0; iParticle < 2000; ++iParticle) {
+      const std::string process(0 == processDistribution(generator) ? "decay" : "primary");
+      generatorMCParticleVector.push_back(
+        MakeParticle(generator, trackIDDistribution(generator), process));
+    }
+
+    const std::chrono::steady_clock::time_point referenceStart(std::chrono::steady_clock::now());
+    std::map<int, art::Ptr<simb::MCParticle>> particleMap;
+    std::map<int, bool> isPrimaryMap;
+    IndexReference(truthToParticles, generatorMCParticleVector, particleMap, isPrimaryMap);
+    const std::chrono::steady_clock::time_point referenceEnd(std::chrono::steady_clock::now());
+
+    const LArPandoraMCParticleIndex particleIndex(truthToParticles, generatorMCParticleVector);
+    const std::chrono::steady_clock::time_point indexEnd(std::chrono::steady_clock::now());
+
+    Check(particleIndex.GetNParticles() == particleMap.size(), "wrong number of particles in the index");
+
+    size_t index(0), nPrimaries(0);
+
+    for (const std::map<int, art::Ptr<simb::MCParticle>>::value_type& particleEntry : particleMap) {
+      Check(particleIndex.GetParticle(index).get() == particleEntry.second.get(),
+            "wrong particle for track id " + std::to_string(particleEntry.first));
+      Check(particleIndex.GetOrigin(index) == simb::kBeamNeutrino,
+            "wrong origin for track id " + std::to_string(particleEntry.first));
+      Check(particleIndex.IsPrimary(index) == isPrimaryMap.at(particleEntry.first),
+            "wrong primary flag for track id " + std::to_string(particleEntry.first));
+
+      size_t foundIndex(std::numeric_limits<size_t>::max());
+      Check(particleIndex.FindTrackID(particleEntry.first, foundIndex) && foundIndex == index,
+            "unable to find track id " + std::to_string(particleEntry.first));
+
+      if (particleIndex.IsPrimary(index)) ++nPrimaries;
+      ++index;
+    }
+
+    size_t foundIndex(0);
+    Check(!particleIndex.FindTrackID(-1, foundIndex), "found a track id that is not in the index");
+    Check(nPrimaries > 0, "no particle is flagged as a primary, the test is not testing anything");
+
+    std::cout << "LArPandoraMCParticleIndex_test: " << particleIndex.GetNParticles() << " particles, "
+              << nPrimaries << " primaries" << std::endl
+              << "  Reference:                 "
+              << std::chrono::duration<double, std::milli>(referenceEnd - referenceStart).count() << " ms"
+              << std::endl
+              << "  LArPandoraMCParticleIndex: "
+              << std::chrono::duration<double, std::milli>(indexEnd - referenceEnd).count() << " ms"
+              << std::endl;
+  }
+  catch (const cet::exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
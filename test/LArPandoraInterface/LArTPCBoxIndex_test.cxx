@@ -0,0 +1,211 @@
+/**
+ *  @file   test/LArPandoraInterface/LArTPCBoxIndex_test.cxx
+ *
+ *  @brief  Check the tpc box index against a search of the tpc boxes one by one, and time the two
+ */
+
+#include "cetlib_except/exception.h"
+
+#include "larpandora/LArPandoraInterface/LArPandoraGeometry.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace lar_pandora;
+
+namespace {
+
+  typedef std::array<double, 6> Box;
+  typedef std::array<double, 3> Position;
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  void
+  Check(const bool condition, const std::string& message)
+  {
+    if (!condition) throw cet::exception("LArTPCBoxIndex_test") << message;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  bool
+  IsInsideBox(const Box& box, const double x, const double y, const double z)
+  {
+    return (x >= box[0] && x <= box[1] && y >= box[2] && y <= box[3] && z >= box[4] && z <= box[5]);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  std::vector<Box>
+  MakeBoxes()
+  {
+    // A grid of touching tpcs, of the size of a large multi-tpc detector, with a gap and a lone tpc off to one side
+    std::vector<Box> boxList;
+
+    for (unsigned int iX = 0; iX < 4; ++iX) {
+      for (unsigned int iY = 0; iY < 2; ++iY) {
+        for (unsigned int iZ = 0; iZ < 25; ++iZ) {
+          if (1 == iX && 12 == iZ) continue;
+
+          boxList.push_back({{-400. + 200. * iX,
+                              -200. + 200. * iX,
+                              -600. + 600. * iY,
+                              600. * iY,
+                              100. * iZ,
+                              100. * (iZ + 1)}});
+        }
+      }
+    }
+
+    boxList.push_back({{700., 750., -100., 100., 2000., 2100.}});
+    return boxList;
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  LArTPCBoxIndex
+  MakeTPCBoxIndex(const std::vector<Box>& boxList)
+  {
+    // As in LArPandoraGeometry::LoadTPCBoxIndex: the cell edges are the distinct box faces, and a cell lies inside a tpc
+    // if its centre does
+    LArTPCBoxIndex::EdgeVector edges[3];
+
+    for (const Box& box : boxList) {
+      for (unsigned int icoord = 0; icoord < 3; ++icoord) {
+        edges[icoord].push_back(box[2 * icoord]);
+        edges[icoord].push_back(box[2 * icoord + 1]);
+      }
+    }
+
+    for (LArTPCBoxIndex::EdgeVector& coordEdges : edges) {
+      std::sort(coordEdges.begin(), coordEdges.end());
+      coordEdges.erase(std::unique(coordEdges.begin(), coordEdges.end()), coordEdges.end());
+    }
+
+    const size_t nCellsX(edges[0].size() - 1), nCellsY(edges[1].size() - 1), nCellsZ(edges[2].size() - 1);
+    std::vector<bool> isInsideCell(nCellsX * nCellsY * nCellsZ, false);
+
+    for (size_t iX = 0; iX < nCellsX; ++iX) {
+      for (size_t iY = 0; iY < nCellsY; ++iY) {
+        for (size_t iZ = 0; iZ < nCellsZ; ++iZ) {
+          const double x(0.5 * (edges[0][iX] + edges[0][iX + 1])), y(0.5 * (edges[1][iY] + edges[1][iY + 1])),
+            z(0.5 * (edges[2][iZ] + edges[2][iZ + 1]));
+
+          for (const Box& box : boxList) {
+            if (IsInsideBox(box, x, y, z)) {
+              isInsideCell[(iX * nCellsY + iY) * nCellsZ + iZ] = true;
+              break;
+            }
+          }
+        }
+      }
+    }
+
+    return LArTPCBoxIndex(edges[0], edges[1], edges[2], isInsideCell);
+  }
+
+  //------------------------------------------------------------------------------------------------------------------------------------------
+
+  std::vector<Position>
+  MakePositions(std::mt19937& generator, const std::vector<Box>& boxList)
+  {
+    std::uniform_real_distribution<double> xDistribution(-500., 800.), yDistribution(-700., 700.),
+      zDistribution(-100., 2600.);
+    std::uniform_int_distribution<unsigned int> snapDistribution(0, 2);
+    std::uniform_int_distribution<size_t> boxDistribution(0, boxList.size() - 1);
+
+    std::vector<Position> positions;
+
+    // ATTN Put a third of the coordinates on a box face, where a position lies in the cells either side of the face
+    for (unsigned int iPosition = 0; iPosition < 1000000; ++iPosition) {
+      Position position{{xDistribution(generator), yDistribution(generator), zDistribution(generator)}};
+
+      for (unsigned int icoord = 0; icoord < 3; ++icoord) {
+        if (0 == snapDistribution(generator))
+          position[icoord] = boxList[boxDistribution(generator)][2 * icoord + snapDistribution(generator) % 2];
+      }
+
+      positions.push_back(position);
+    }
+
+    return positions;
+  }
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int
+main()
+{
+  try {
+    std::mt19937 generator(20201016);
+    const std::vector<Box> boxList(MakeBoxes());
+    const std::vector<Position> positions(MakePositions(generator, boxList));
+    const LArTPCBoxIndex tpcBoxIndex(MakeTPCBoxIndex(boxList));
+
+    Check(!tpcBoxIndex.IsEmpty(), "the tpc box index is empty");
+    Check(LArTPCBoxIndex().IsEmpty(), "a default tpc box index is not empty");
+
+    const std::chrono::steady_clock::time_point referenceStart(std::chrono::steady_clock::now());
+    std::vector<bool> expectedInside;
+    expectedInside.reserve(positions.size());
+
+    for (const Position& position : positions) {
+      expectedInside.push_back(std::any_of(boxList.begin(), boxList.end(), [&position](const Box& box) {
+        return IsInsideBox(box, position[0], position[1], position[2]);
+      }));
+    }
+    const std::chrono::steady_clock::time_point referenceEnd(std::chrono::steady_clock::now());
+
+    std::vector<bool> isInside;
+    isInside.reserve(positions.size());
+
+    for (const Position& position : positions)
+      isInside.push_back(tpcBoxIndex.IsInsideTPC(position[0], position[1], position[2]));
+    const std::chrono::steady_clock::time_point indexEnd(std::chrono::steady_clock::now());
+
+    size_t nInside(0);
+
+    for (size_t iPosition = 0; iPosition < positions.size(); ++iPosition) {
+      const Position& position(positions[iPosition]);
+      Check(isInside[iPosition] == expectedInside[iPosition],
+            "wrong answer for position (" + std::to_string(position[0]) + ", " +
+              std::to_string(position[1]) + ", " + std::to_string(position[2]) + ")");
+
+      if (isInside[iPosition]) ++nInside;
+    }
+
+    Check(nInside > 0 && nInside < positions.size(),
+          "all positions are on one side of the tpcs, the test is not testing anything");
+
+    bool threw(false);
+    try {
+      LArTPCBoxIndex({0., 1.}, {0., 1.}, {0., 1.}, {true, false});
+    }
+    catch (const cet::exception&) {
+      threw = true;
+    }
+    Check(threw, "inconsistent cell edges and cell flags were accepted");
+
+    std::cout << "LArTPCBoxIndex_test: " << positions.size() << " positions, " << nInside
+              << " inside a tpc" << std::endl
+              << "  Box by box:     "
+              << std::chrono::duration<double, std::milli>(referenceEnd - referenceStart).count() << " ms"
+              << std::endl
+              << "  LArTPCBoxIndex: "
+              << std::chrono::duration<double, std::milli>(indexEnd - referenceEnd).count() << " ms"
+              << std::endl;
+  }
+  catch (const cet::exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+//###################################################################
+//### Name:        ShowerIncrementalPCA_test                      ###
+//### Date:        16.10.26                                       ###
+//### Description: Slides a window along a track of 3D points,    ###
+//###              checking the incremental PCA against a refit  ###
+//###              of the points in the window at each step, and  ###
+//###              times the two                                  ###
+//###################################################################
+
+//Framework includes
+#include "cetlib_except/exception.h"
+
+//LArSoft Includes
+#include "larpandora/LArPandoraEventBuilding/LArPandoraShower/Algs/ShowerIncrementalPCA.hh"
+
+//Root Includes
+#include "TMatrixDSym.h"
+#include "TMatrixDSymEigen.h"
+#include "TVector3.h"
+
+//C++ Includes
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+  struct BatchPCA {
+    TVector3    centre;
+    TMatrixDSym covariance{3};
+    TVector3    principalAxis;
+  };
+
+  void Check(bool condition, const std::string& message){
+    if(!condition){
+      throw cet::exception("ShowerIncrementalPCA_test") << message;
+    }
+  }
+
+  //The refit that the incremental PCA replaces: the weighted centre and covariance of the points in the window.
+  BatchPCA FitWindow(const std::vector<TVector3>& points, const std::vector<double>& weights, size_t begin, size_t end){
+    BatchPCA pca;
+    double sumWeights = 0;
+    for(size_t i=begin; i<end; ++i){
+      pca.centre += points[i] * weights[i];
+      sumWeights += weights[i];
+    }
+    pca.centre *= 1./sumWeights;
+
+    for(size_t i=begin; i<end; ++i){
+      const TVector3 relative = points[i] - pca.centre;
+      for(unsigned int a=0; a<3; ++a){
+        for(unsigned int b=0; b<3; ++b){
+          pca.covariance(a,b) += weights[i] * relative[a] * relative[b] / sumWeights;
+        }
+      }
+    }
+
+    const TMatrixDSymEigen eigen(pca.covariance);
+    const TMatrixD& eigenvectors = eigen.GetEigenVectors();
+    pca.principalAxis = TVector3(eigenvectors[0][0], eigenvectors[1][0], eigenvectors[2][0]);
+    return pca;
+  }
+
+  void CheckAgainstBatch(const reco::shower::ShowerIncrementalPCA& incrementalPCA, const BatchPCA& batchPCA,
+      size_t step){
+
+    const std::string where = " at step " + std::to_string(step);
+
+    //ATTN The moments are summed in a different order, and points are removed again, so only agree to rounding
+    Check((incrementalPCA.Centre() - batchPCA.centre).Mag() < 1e-6, "wrong centre" + where);
+
+    const TMatrixDSym covariance = incrementalPCA.Covariance();
+    for(unsigned int a=0; a<3; ++a){
+      for(unsigned int b=0; b<3; ++b){
+        Check(std::abs(covariance(a,b) - batchPCA.covariance(a,b)) < 1e-6, "wrong covariance" + where);
+      }
+    }
+
+    //The sign of an eigenvector is arbitrary
+    Check(std::abs(incrementalPCA.PrincipalAxis().Dot(batchPCA.principalAxis)) > 1 - 1e-9, "wrong principal axis" + where);
+  }
+
+}
+
+int main(){
+
+  try{
+    std::mt19937 generator(20201016);
+    std::normal_distribution<double>       scatterDistribution(0, 0.3);
+    std::uniform_real_distribution<double> weightDistribution(0.5, 2);
+
+    //A straight track a long way from the origin, with some scatter about it
+    const TVector3 trackStart(-300, 150, 800);
+    const TVector3 trackDirection = TVector3(0.6, -0.3, 0.74).Unit();
+    const size_t numPoints  = 20000;
+    const size_t windowSize = 100;
+
+    std::vector<TVector3> points;
+    std::vector<double>   weights;
+    for(size_t i=0; i<numPoints; ++i){
+      const TVector3 scatter(scatterDistribution(generator), scatterDistribution(generator), scatterDistribution(generator));
+      points.push_back(trackStart + trackDirection * (0.03 * i) + scatter);
+      weights.push_back(weightDistribution(generator));
+    }
+
+    //Refit the window at each step
+    const std::chrono::steady_clock::time_point batchStart = std::chrono::steady_clock::now();
+    std::vector<BatchPCA> batchPCAs;
+    for(size_t begin=0; begin + windowSize <= numPoints; ++begin){
+      batchPCAs.push_back(FitWindow(points, weights, begin, begin + windowSize));
+    }
+    const std::chrono::steady_clock::time_point batchEnd = std::chrono::steady_clock::now();
+
+    //Slide the window, alternately removing then adding a point and replacing one point with the next
+    std::vector<TVector3> incrementalAxes;
+    reco::shower::ShowerIncrementalPCA incrementalPCA;
+    for(size_t i=0; i<windowSize; ++i){
+      incrementalPCA.AddPoint(points[i], weights[i]);
+    }
+    incrementalAxes.push_back(incrementalPCA.PrincipalAxis());
+
+    for(size_t begin=1; begin + windowSize <= numPoints; ++begin){
+      const size_t oldPoint = begin - 1;
+      const size_t newPoint = begin + windowSize - 1;
+      if(begin % 2){
+        incrementalPCA.RemovePoint(points[oldPoint], weights[oldPoint]);
+        incrementalPCA.AddPoint(points[newPoint], weights[newPoint]);
+      }
+      else{
+        incrementalPCA.ReplacePoint(points[oldPoint], points[newPoint], weights[oldPoint], weights[newPoint]);
+      }
+      incrementalAxes.push_back(incrementalPCA.PrincipalAxis());
+    }
+    const std::chrono::steady_clock::time_point incrementalEnd = std::chrono::steady_clock::now();
+
+    //Repeat the slide to check each step, outside of the timing
+    reco::shower::ShowerIncrementalPCA checkPCA;
+    for(size_t i=0; i<windowSize; ++i){
+      checkPCA.AddPoint(points[i], weights[i]);
+    }
+    CheckAgainstBatch(checkPCA, batchPCAs[0], 0);
+
+    for(size_t begin=1; begin + windowSize <= numPoints; ++begin){
+      const size_t oldPoint = begin - 1;
+      const size_t newPoint = begin + windowSize - 1;
+      if(begin % 2){
+        checkPCA.RemovePoint(points[oldPoint], weights[oldPoint]);
+        checkPCA.AddPoint(points[newPoint], weights[newPoint]);
+      }
+      else{
+        checkPCA.ReplacePoint(points[oldPoint], points[newPoint], weights[oldPoint], weights[newPoint]);
+      }
+      Check(checkPCA.NumPoints() == windowSize, "wrong number of points at step " + std::to_string(begin));
+      CheckAgainstBatch(checkPCA, batchPCAs[begin], begin);
+      Check(checkPCA.PrincipalAxis() == incrementalAxes[begin], "principal axis not reproducible at step " + std::to_string(begin));
+    }
+
+    //Removing every point leaves an empty PCA, which cannot have any more points removed
+    for(size_t i=numPoints - windowSize; i<numPoints; ++i){
+      checkPCA.RemovePoint(points[i], weights[i]);
+    }
+    Check(checkPCA.NumPoints() == 0 && checkPCA.SumWeights() == 0, "points left after removing every point");
+
+    bool threw = false;
+    try{
+      checkPCA.RemovePoint(points[0]);
+    }
+    catch(const cet::exception&){
+      threw = true;
+    }
+    Check(threw, "removed a point from an empty PCA");
+
+    std::cout << "ShowerIncrementalPCA_test: " << batchPCAs.size() << " windows of " << windowSize << " points" << std::endl
+      << "  Refit:                "
+      << std::chrono::duration<double, std::milli>(batchEnd - batchStart).count() << " ms" << std::endl
+      << "  ShowerIncrementalPCA: "
+      << std::chrono::duration<double, std::milli>(incrementalEnd - batchEnd).count() << " ms" << std::endl;
+  }
+  catch(const cet::exception& exception){
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,149 @@
+//###################################################################
+//### Name:        ShowerSpatialIndex_test                        ###
+//### Date:        16.10.26                                       ###
+//### Description: Checks the nearest point found by the KD-tree  ###
+//###              against a linear scan over the points, as the  ###
+//###              shower tools did before, and times the two     ###
+//###################################################################
+
+//LArSoft Includes
+#include "larpandora/LArPandoraEventBuilding/LArPandoraShower/Algs/ShowerSpatialIndex.hh"
+
+//Root Includes
+#include "TVector3.h"
+
+//C++ Includes
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+  struct Match {
+    bool   found;
+    size_t index;
+  };
+
+  bool Check(bool condition, const std::string& message){
+    if(!condition){
+      std::cerr << "ShowerSpatialIndex_test: " << message << std::endl;
+    }
+    return condition;
+  }
+
+  //The linear scan that the spatial index replaces, keeping the first of several equally close points.
+  Match FindNearestLinear(const std::vector<TVector3>& points, const std::vector<bool>& removed,
+      const TVector3& position, double MaxDistance){
+
+    Match match{false, 0};
+    double bestDistance = MaxDistance;
+    for(size_t i=0; i<points.size(); ++i){
+      if(removed[i]) continue;
+      const double distance = (points[i] - position).Mag();
+      if(distance < bestDistance){
+        bestDistance = distance;
+        match        = {true, i};
+      }
+    }
+    return match;
+  }
+
+}
+
+int main(){
+
+  std::mt19937 generator(20201016);
+  std::uniform_real_distribution<double> positionDistribution(-100, 100);
+  std::uniform_int_distribution<int>     gridDistribution(-20, 20);
+  std::uniform_int_distribution<size_t>  duplicateDistribution(0, 9);
+
+  //ATTN Put half the points on a grid and repeat some of them, so that many searches find equally close points
+  std::vector<TVector3> points;
+  for(size_t i=0; i<20000; ++i){
+    if(i > 0 && duplicateDistribution(generator) == 0){
+      points.push_back(points[std::uniform_int_distribution<size_t>(0, i-1)(generator)]);
+    }
+    else if(i % 2){
+      points.emplace_back(5. * gridDistribution(generator), 5. * gridDistribution(generator), 5. * gridDistribution(generator));
+    }
+    else{
+      points.emplace_back(positionDistribution(generator), positionDistribution(generator), positionDistribution(generator));
+    }
+  }
+
+  //There are more searches than points, so that the searches without a maximum distance run out of points
+  std::vector<TVector3> positions;
+  for(size_t i=0; i<25000; ++i){
+    if(i % 4 == 0){
+      positions.push_back(points[i % points.size()]);
+    }
+    else if(i % 4 == 1){
+      positions.emplace_back(5. * gridDistribution(generator) + 2.5, 5. * gridDistribution(generator), 5. * gridDistribution(generator));
+    }
+    else{
+      positions.emplace_back(positionDistribution(generator), positionDistribution(generator), positionDistribution(generator));
+    }
+  }
+
+  const reco::shower::ShowerSpatialIndex spatialIndex(points);
+
+  if(!Check(spatialIndex.NumPoints() == points.size(), "wrong number of points in the index")){
+    return 1;
+  }
+
+  //Remove a point after every search, as in the matching tools, and search both with and without a maximum distance
+  const std::vector<double> maxDistances = {std::numeric_limits<double>::max(), 3.};
+  for(const double maxDistance: maxDistances){
+
+    reco::shower::ShowerSpatialIndex searchIndex(spatialIndex);
+
+    const std::chrono::steady_clock::time_point linearStart = std::chrono::steady_clock::now();
+    std::vector<Match> linearMatches;
+    std::vector<bool> linearRemoved(points.size(), false);
+    for(const TVector3& position: positions){
+      linearMatches.push_back(FindNearestLinear(points, linearRemoved, position, maxDistance));
+      if(linearMatches.back().found){
+        linearRemoved[linearMatches.back().index] = true;
+      }
+    }
+    const std::chrono::steady_clock::time_point linearEnd = std::chrono::steady_clock::now();
+
+    std::vector<Match> indexMatches;
+    for(const TVector3& position: positions){
+      Match match{false, 0};
+      match.found = searchIndex.FindNearest(position, maxDistance, match.index);
+      indexMatches.push_back(match);
+      if(match.found){
+        searchIndex.Remove(match.index);
+      }
+    }
+    const std::chrono::steady_clock::time_point indexEnd = std::chrono::steady_clock::now();
+
+    //ATTN Both find the same point only if ties go to the lowest index, so compare the indices exactly
+    size_t numFound = 0;
+    for(size_t i=0; i<positions.size(); ++i){
+      const std::string where = " for position " + std::to_string(i) + " with maximum distance " + std::to_string(maxDistance);
+      if(!Check(indexMatches[i].found == linearMatches[i].found, "wrong found flag" + where)
+          || !Check(!linearMatches[i].found || indexMatches[i].index == linearMatches[i].index, "wrong point" + where)){
+        return 1;
+      }
+      if(linearMatches[i].found) ++numFound;
+    }
+
+    if(!Check(numFound > 0 && numFound < positions.size(), "all or none of the searches found a point, the test is not testing anything")){
+      return 1;
+    }
+
+    std::cout << "ShowerSpatialIndex_test: " << positions.size() << " searches of " << points.size() << " points, maximum distance "
+      << maxDistance << ", " << numFound << " found" << std::endl
+      << "  Linear scan:        "
+      << std::chrono::duration<double, std::milli>(linearEnd - linearStart).count() << " ms" << std::endl
+      << "  ShowerSpatialIndex: "
+      << std::chrono::duration<double, std::milli>(indexEnd - linearEnd).count() << " ms" << std::endl;
+  }
+
+  return 0;
+}